@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "axleBrakeBias.hpp"
+#include "threadPool.hpp"
+#include "profiler.hpp"
+
+/********************
+Program    - Axle Load Model - Brake Bias Optimizer
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Column min/max reduction, exhaustive knot search with narrowing passes, full-grid rescore
+        - Version 1   - Search seeded with the best straight line on K knots, knot-at-a-time refinement
+        - Version 2   - Dropped the unused per-cell ideal share grid, rear weight >= 1
+********************/
+
+// Candidate curves scored per ParallelFor, so progress/cancel is polled a few times per pass
+static const long long kCandidateBatch = 1 << 15;
+// Upper bound on steps^knots per pass; steps are reduced to stay under it
+static const long long kMaxCandidates = 1 << 22;
+// Most knots a curve may have
+static const int kMaxKnots = 8;
+// Knot-at-a-time refinement rounds after the exhaustive passes; stops early once a round gains nothing
+static const int kRefineRounds = 20;
+
+double BrakeBiasCurve::Bias(double d) const {
+    if (bias.empty()) return 0.0;
+    if (d <= decel.front() || bias.size() == 1) return bias.front();
+    if (d >= decel.back()) return bias.back();
+    const size_t k = (size_t)(std::upper_bound(decel.begin(), decel.end(), d) - decel.begin()) - 1;
+    const double t = (d - decel[k]) / (decel[k + 1] - decel[k]);
+    return bias[k] + t * (bias[k + 1] - bias[k]);
+}
+
+// Worst risk over a column whose ideal share spans [lo, hi]: front-first lock is worst where
+// p is smallest, rear-first where it is largest
+static inline double ColumnRisk(double b, double lo, double hi, double rearWeight) {
+    const double front = b / lo - 1.0;
+    const double rear = rearWeight * ((1.0 - b) / (1.0 - hi) - 1.0);
+    return front > rear ? front : rear;
+}
+
+struct BiasColumn { double decel, lo, hi; int seg; double t; };   // ideal share range, knot segment
+struct BiasBest { double risk; long long index; };
+
+bool OptimizeBrakeBias(const AxleData& data, const BrakeBiasOptions& opt, BrakeBiasResult& out) {
+    PROFILE_SCOPE("OptimizeBrakeBias");
+    out = BrakeBiasResult();
+    const int rows = data.WF.Rows(), cols = data.WF.Cols();
+    if (rows == 0 || cols == 0 || (int)data.accel.size() != cols) return false;
+    ThreadPool& tp = opt.pool ? *opt.pool : DefaultThreadPool();
+    const int workers = tp.Size();
+    const double w = std::max(1.0, opt.rearWeight);
+
+    // Braking columns (decel = -accel)
+    std::vector<int> colIdx;
+    for (int j = 0; j < cols; ++j)
+        if (-data.accel[j] >= opt.minDecel && -data.accel[j] > 0.0) colIdx.push_back(j);
+    if (colIdx.empty()) return false;
+
+    // Parallel reduction: per-worker min/max ideal share per braking column, merged after
+    const int nc = (int)colIdx.size();
+    std::vector<double> lo((size_t)workers * nc, std::numeric_limits<double>::infinity());
+    std::vector<double> hi((size_t)workers * nc, -std::numeric_limits<double>::infinity());
+    std::vector<long long> cellCount(workers, 0), liftCount(workers, 0);
+    const int per = std::max(1, std::min(256, (rows + workers - 1) / workers));
+    tp.ParallelFor((rows + per - 1) / per, [&](int t, int worker) {
+        double* l = lo.data() + (size_t)worker * nc;
+        double* h = hi.data() + (size_t)worker * nc;
+        const int i1 = std::min(rows, (t + 1) * per);
+        for (int i = t * per; i < i1; ++i) {
+            const double* wf = data.WF.Row(i);
+            const double* wr = data.WR.Row(i);
+            for (int c = 0; c < nc; ++c) {
+                const int j = colIdx[c];
+                if (!(wf[j] > 0.0 && wr[j] > 0.0)) { ++liftCount[worker]; continue; }
+                const double p = IdealFrontBrakeShare(wf[j], wr[j]);
+                l[c] = std::min(l[c], p);
+                h[c] = std::max(h[c], p);
+                ++cellCount[worker];
+            }
+        }
+    });
+    std::vector<BiasColumn> columns;
+    for (int c = 0; c < nc; ++c) {
+        double l = std::numeric_limits<double>::infinity(), h = -l;
+        for (int k = 0; k < workers; ++k) {
+            l = std::min(l, lo[(size_t)k * nc + c]);
+            h = std::max(h, hi[(size_t)k * nc + c]);
+        }
+        if (l <= h) columns.push_back({-data.accel[colIdx[c]], l, h, 0, 0.0});
+    }
+    for (int k = 0; k < workers; ++k) { out.cells += cellCount[k]; out.liftCells += liftCount[k]; }
+    if (columns.empty()) return false;
+    std::sort(columns.begin(), columns.end(), [](const BiasColumn& a, const BiasColumn& b) { return a.decel < b.decel; });
+    for (const BiasColumn& c : columns) {
+        out.decel.push_back(c.decel);
+        out.idealMin.push_back(c.lo);
+        out.idealMax.push_back(c.hi);
+    }
+
+    // Best fixed bias in closed form: the front term rises and the rear term falls with b, so the
+    // optimum is where they meet over the envelope's extreme ideal shares
+    double pMin = columns[0].lo, pMax = columns[0].hi;
+    for (const BiasColumn& c : columns) { pMin = std::min(pMin, c.lo); pMax = std::max(pMax, c.hi); }
+    out.fixedBias = std::clamp((1.0 - w + w / (1.0 - pMax)) / (1.0 / pMin + w / (1.0 - pMax)), 1e-6, 1.0 - 1e-6);
+    out.fixedRisk = ColumnRisk(out.fixedBias, pMin, pMax, w);
+
+    // Knots evenly over the braking range (one knot if it is a single column); each column
+    // interpolates between two of them
+    const double d0 = columns.front().decel, d1 = columns.back().decel;
+    const int K = d1 > d0 ? std::clamp(opt.knots, 1, kMaxKnots) : 1;
+    int laidOut = 0;
+    auto layout = [&](int knots) {
+        laidOut = knots;
+        for (BiasColumn& c : columns) {
+            if (knots == 1) { c.seg = 0; c.t = 0.0; continue; }
+            const double x = (c.decel - d0) / (d1 - d0) * (knots - 1);
+            c.seg = std::min(knots - 2, (int)x);
+            c.t = x - c.seg;
+        }
+    };
+    auto score = [&](const double* v, double limit) {
+        double worst = 0.0;
+        for (const BiasColumn& c : columns) {
+            const double b = laidOut == 1 ? v[0] : v[c.seg] + c.t * (v[c.seg + 1] - v[c.seg]);
+            worst = std::max(worst, ColumnRisk(b, c.lo, c.hi, w));
+            if (worst > limit) break;   // cannot beat the best so far
+        }
+        return worst;
+    };
+
+    // Exhaustive search over steps^knots knot values per pass; each later pass spans one
+    // step of the previous grid either side of the best curve. best/bestRisk come in as the
+    // incumbent and a candidate is only taken if it does better.
+    std::vector<BiasBest> local(workers);
+    auto search = [&](int knots, std::vector<double>& best, double& bestRisk, float p0, float p1) {
+        layout(knots);
+        int S = std::max(2, opt.steps);
+        while (S > 2 && std::pow((double)S, knots) > (double)kMaxCandidates) --S;
+        long long combos = 1;
+        for (int k = 0; k < knots; ++k) combos *= S;
+        std::vector<double> base(knots, std::min(opt.biasMin, opt.biasMax));
+        std::vector<double> step(knots, (std::fabs(opt.biasMax - opt.biasMin)) / (S - 1));
+        const int passes = std::max(1, opt.passes);
+        for (int pass = 0; pass < passes; ++pass) {
+            for (long long b0 = 0; b0 < combos; b0 += kCandidateBatch) {
+                const long long b1 = std::min(combos, b0 + kCandidateBatch);
+                for (BiasBest& l : local) l = {bestRisk, -1};
+                const long long chunk = std::max<long long>(64, (b1 - b0 + 8 * workers - 1) / (8 * workers));
+                tp.ParallelFor((int)((b1 - b0 + chunk - 1) / chunk), [&](int t, int worker) {
+                    const long long i0 = b0 + (long long)t * chunk, i1 = std::min(b1, i0 + chunk);
+                    double v[kMaxKnots];
+                    int digit[kMaxKnots];
+                    long long rest = i0;
+                    for (int k = knots - 1; k >= 0; --k) { digit[k] = (int)(rest % S); rest /= S; }
+                    BiasBest& mine = local[worker];
+                    for (long long idx = i0; idx < i1; ++idx) {
+                        bool valid = true;
+                        for (int k = 0; k < knots; ++k) {
+                            v[k] = base[k] + digit[k] * step[k];
+                            valid &= v[k] > 0.0 && v[k] < 1.0 && (!opt.monotone || k == 0 || v[k] >= v[k - 1]);
+                        }
+                        if (valid) {
+                            const double r = score(v, mine.risk);
+                            // Ties go to the lowest index so the answer does not depend on scheduling
+                            if (r < mine.risk || (r == mine.risk && mine.index >= 0 && idx < mine.index))
+                                mine = {r, idx};
+                        }
+                        for (int k = knots - 1; k >= 0 && ++digit[k] == S; --k) digit[k] = 0;
+                    }
+                });
+                out.candidates += b1 - b0;
+                BiasBest winner{bestRisk, -1};
+                for (const BiasBest& l : local)
+                    if (l.index >= 0 && (l.risk < winner.risk || (l.risk == winner.risk && (winner.index < 0 || l.index < winner.index))))
+                        winner = l;
+                if (winner.index >= 0) {
+                    long long rest = winner.index;
+                    for (int k = knots - 1; k >= 0; --k) { best[k] = base[k] + (rest % S) * step[k]; rest /= S; }
+                    bestRisk = winner.risk;
+                }
+                const float done = ((float)pass + (float)b1 / (float)combos) / (float)passes;
+                if (opt.progress && !opt.progress(p0 + (p1 - p0) * done))
+                    return false;
+            }
+            for (int k = 0; k < knots; ++k) {
+                const double half = step[k];
+                step[k] = 2.0 * half / (S - 1);
+                base[k] = best[k] - half;
+            }
+        }
+
+        // The grid can settle a step or two off the optimum along a valley, so finish by moving
+        // one knot at a time. The worst risk is convex in each knot (a max of functions linear
+        // in it), so a ternary search between its neighbours finds that knot's best value.
+        for (int round = 0; round < kRefineRounds; ++round) {
+            const double before = bestRisk;
+            for (int k = 0; k < knots; ++k) {
+                double a = opt.monotone && k > 0 ? best[k - 1] : 1e-6;
+                double b = opt.monotone && k + 1 < knots ? best[k + 1] : 1.0 - 1e-6;
+                std::vector<double> v = best;
+                auto at = [&](double x) {
+                    ++out.candidates;
+                    v[k] = x;
+                    return score(v.data(), std::numeric_limits<double>::infinity());
+                };
+                for (int it = 0; it < 100 && b - a > 1e-12; ++it) {
+                    const double m1 = a + (b - a) / 3.0, m2 = b - (b - a) / 3.0;
+                    if (at(m1) <= at(m2)) b = m2; else a = m1;
+                }
+                const double x = 0.5 * (a + b), r = at(x);
+                if (r < bestRisk) { best[k] = x; bestRisk = r; }
+            }
+            if (!(bestRisk < before - 1e-12)) break;
+        }
+        return true;
+    };
+
+    // The fixed optimum is exact. A curve search starts from the best straight line (two knots,
+    // seeded with the fixed bias), laid onto the K knots: the end knots coincide and the others
+    // sit on the line, so it scores the same and K knots can never end up worse than two or one.
+    BrakeBiasCurve& curve = out.curve;
+    curve.decel.resize(K);
+    for (int k = 0; k < K; ++k) curve.decel[k] = K == 1 ? d0 : d0 + (d1 - d0) * k / (K - 1);
+    std::vector<double> best(K, out.fixedBias);
+    if (K >= 2) {
+        std::vector<double> line(2, out.fixedBias);
+        layout(2);
+        double lineRisk = score(line.data(), std::numeric_limits<double>::infinity());
+        const float split = K == 2 ? 1.0f : 0.1f;
+        if (!search(2, line, lineRisk, 0.0f, split)) return false;
+        for (int k = 0; k < K; ++k) best[k] = line[0] + (line[1] - line[0]) * k / (K - 1);
+        if (K > 2) {
+            layout(K);
+            double bestRisk = score(best.data(), std::numeric_limits<double>::infinity());
+            if (!search(K, best, bestRisk, split, 1.0f)) return false;
+        }
+    }
+    curve.bias = best;
+
+    // Rescore the winner over every braking cell for the reported figures
+    std::vector<double> biasAt(cols, 0.0);
+    for (int j : colIdx) biasAt[j] = curve.Bias(-data.accel[j]);
+    struct Stats { double risk = -1.0; int i = 0, j = 0; double worstRatio = 0.0; long long rearFirst = 0; };
+    std::vector<Stats> stats(workers);
+    tp.ParallelFor((rows + per - 1) / per, [&](int t, int worker) {
+        Stats& s = stats[worker];
+        const int i1 = std::min(rows, (t + 1) * per);
+        for (int i = t * per; i < i1; ++i) {
+            const double* wf = data.WF.Row(i);
+            const double* wr = data.WR.Row(i);
+            for (int j : colIdx) {
+                if (!(wf[j] > 0.0 && wr[j] > 0.0)) continue;
+                const double p = IdealFrontBrakeShare(wf[j], wr[j]);
+                const double b = biasAt[j];
+                const double r = BrakeLockRisk(b, p, w);
+                if (r > s.risk || (r == s.risk && (i < s.i || (i == s.i && j < s.j)))) { s.risk = r; s.i = i; s.j = j; }
+                s.worstRatio = std::max(s.worstRatio, std::max(b / p, (1.0 - b) / (1.0 - p)));
+                s.rearFirst += b < p;
+            }
+        }
+    });
+    Stats all;
+    long long rearFirst = 0;
+    for (const Stats& s : stats) {
+        if (s.risk > all.risk || (s.risk == all.risk && (s.i < all.i || (s.i == all.i && s.j < all.j)))) {
+            all.risk = s.risk; all.i = s.i; all.j = s.j;
+        }
+        all.worstRatio = std::max(all.worstRatio, s.worstRatio);
+        rearFirst += s.rearFirst;
+    }
+    out.risk = all.risk;
+    out.efficiency = all.worstRatio > 0.0 ? 1.0 / all.worstRatio : 0.0;
+    out.worstTheta = data.theta[all.i];
+    out.worstAccel = data.accel[all.j];
+    out.rearFirstShare = out.cells > 0 ? (double)rearFirst / (double)out.cells : 0.0;
+    out.generation = data.generation;
+    return true;
+}
@@ -0,0 +1,86 @@
+/********************
+Program    - Axle Load Model - Brake Bias Optimizer
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Ideal brake split per cell, fixed / piecewise bias search over the braking envelope
+        - Version 1   - Curve search seeded with the best straight line, knot-at-a-time refinement
+        - Version 2   - Removed CalculateIdealBrakeShare, rearWeight documented as >= 1
+********************/
+
+#ifndef AXLE_BRAKE_BIAS_H
+#define AXLE_BRAKE_BIAS_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "axleLoads.hpp"
+
+class ThreadPool;
+
+// Front share of the total brake force that makes both axles reach the friction limit together:
+// the share of the total axle load carried by the front axle.
+inline double IdealFrontBrakeShare(double WF, double WR) { return WF / (WF + WR); }
+
+// Lock-up risk of braking with front share b where the ideal share is p: how much more friction
+// the first axle to lock needs than the ideal split would, e.g. 0.25 = locks at 80% of the
+// achievable decel. Front-first lock (b > p) costs b/p - 1; rear-first lock (b < p), which makes
+// the car unstable, costs rearWeight * ((1-b)/(1-p) - 1).
+inline double BrakeLockRisk(double b, double p, double rearWeight) {
+    const double front = b / p - 1.0;
+    const double rear = rearWeight * ((1.0 - b) / (1.0 - p) - 1.0);
+    return front > rear ? front : rear;
+}
+
+// Front brake share as a function of deceleration (m/s^2, positive when braking): linear between
+// knots, flat outside them. One knot is a fixed bias.
+struct BrakeBiasCurve {
+    std::vector<double> decel;      // ascending
+    std::vector<double> bias;       // front share at each knot
+    double Bias(double d) const;
+};
+
+struct BrakeBiasOptions {
+    int knots = 3;                  // curve knots spread evenly over the braking range; 1 = fixed bias, at most 8
+    int steps = 24;                 // candidate values per knot in each search pass
+    int passes = 3;                 // each pass searches a narrower window around the best curve
+    double biasMin = 0.3, biasMax = 0.95;   // front share searched in the first pass
+    // Rear-first lock counts this much more than front-first; values below 1 are taken as 1, since
+    // a rear lock is never better than a front lock
+    double rearWeight = 2.0;
+    double minDecel = 0.5;          // columns braking less than this (m/s^2) are ignored
+    bool monotone = true;           // front share may only rise with decel, as a proportioning valve
+    ThreadPool* pool = nullptr;     // nullptr -> DefaultThreadPool()
+    // Called between search passes with the fraction done; return false to cancel
+    std::function<bool(float)> progress;
+};
+
+struct BrakeBiasResult {
+    BrakeBiasCurve curve;                   // best curve found
+    double risk = 0.0;                      // its worst BrakeLockRisk over the envelope
+    double efficiency = 0.0;                // worst decel before lock / decel with the ideal split
+    double worstTheta = 0.0, worstAccel = 0.0;   // cell with the worst risk
+    double rearFirstShare = 0.0;            // share of braking cells where the rear locks first
+    double fixedBias = 0.0, fixedRisk = 0.0;     // best single bias (exact), for comparison
+    // Ideal front share range over slope per braking column, decel ascending
+    std::vector<double> decel, idealMin, idealMax;
+    long long candidates = 0;               // curves scored
+    long long cells = 0;                    // braking cells in the envelope
+    long long liftCells = 0;                // braking cells skipped because an axle carries no load
+    std::uint64_t generation = 0;           // grid generation it came from; 0 = none
+};
+
+// Search fixed (knots = 1) or piecewise-linear bias curves for the one whose worst lock-up risk
+// over the braking part of the grid is lowest.
+// The grid is reduced once, in parallel over row blocks, to the min and max ideal share of each
+// braking column: a column's worst risk for a given bias only depends on those two (risk falls
+// with p for front-first lock and rises with p for rear-first). Scoring a curve is then one pass
+// over the columns, so steps^knots candidates per pass are spread over the pool with a
+// per-worker best and early exit once a curve is worse than that best, then each knot is refined
+// on its own. A curve search starts from the best straight line laid onto its knots, so more
+// knots never score worse than fewer. The winner is scored again over every cell for the
+// reported figures. Returns false if there are no braking cells or the search was cancelled.
+bool OptimizeBrakeBias(const AxleData& data, const BrakeBiasOptions& opt, BrakeBiasResult& out);
+
+#endif // AXLE_BRAKE_BIAS_H
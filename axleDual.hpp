@@ -0,0 +1,91 @@
+/********************
+Program    - Axle Load Model - Dual Numbers
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Forward-mode dual number with N partials (arithmetic, sin/cos)
+********************/
+
+#ifndef AXLE_DUAL_H
+#define AXLE_DUAL_H
+
+#include <cmath>
+
+// Value plus N partial derivatives, propagated through arithmetic (forward-mode AD).
+// The value part goes through exactly the operations the plain scalar code would do,
+// so it is bit-identical to evaluating the same expression in T.
+template <typename T, int N>
+struct DualT {
+    T v;      // value
+    T d[N];   // partials
+
+    DualT() : v(T(0)), d{} {}
+    DualT(T value) : v(value), d{} {}   // constant: all partials zero
+
+    // Independent variable i of N
+    static DualT Seed(T value, int i) {
+        DualT x(value);
+        x.d[i] = T(1);
+        return x;
+    }
+
+    DualT operator-() const {
+        DualT r(-v);
+        for (int i = 0; i < N; ++i) r.d[i] = -d[i];
+        return r;
+    }
+};
+
+template <typename T, int N>
+DualT<T, N> operator+(const DualT<T, N>& a, const DualT<T, N>& b) {
+    DualT<T, N> r(a.v + b.v);
+    for (int i = 0; i < N; ++i) r.d[i] = a.d[i] + b.d[i];
+    return r;
+}
+
+template <typename T, int N>
+DualT<T, N> operator-(const DualT<T, N>& a, const DualT<T, N>& b) {
+    DualT<T, N> r(a.v - b.v);
+    for (int i = 0; i < N; ++i) r.d[i] = a.d[i] - b.d[i];
+    return r;
+}
+
+template <typename T, int N>
+DualT<T, N> operator*(const DualT<T, N>& a, const DualT<T, N>& b) {
+    DualT<T, N> r(a.v * b.v);
+    for (int i = 0; i < N; ++i) r.d[i] = a.d[i] * b.v + a.v * b.d[i];
+    return r;
+}
+
+template <typename T, int N>
+DualT<T, N> operator/(const DualT<T, N>& a, const DualT<T, N>& b) {
+    DualT<T, N> r(a.v / b.v);
+    const T inv = T(1) / b.v;
+    for (int i = 0; i < N; ++i) r.d[i] = (a.d[i] - r.v * b.d[i]) * inv;
+    return r;
+}
+
+// Found by argument-dependent lookup from templated model code that does `using std::cos;`
+template <typename T, int N>
+DualT<T, N> cos(const DualT<T, N>& x) {
+    using std::cos; using std::sin;
+    DualT<T, N> r(cos(x.v));
+    const T ds = -sin(x.v);
+    for (int i = 0; i < N; ++i) r.d[i] = ds * x.d[i];
+    return r;
+}
+
+template <typename T, int N>
+DualT<T, N> sin(const DualT<T, N>& x) {
+    using std::cos; using std::sin;
+    DualT<T, N> r(sin(x.v));
+    const T dc = cos(x.v);
+    for (int i = 0; i < N; ++i) r.d[i] = dc * x.d[i];
+    return r;
+}
+
+// One partial per VehicleParams field, in declaration order: m, h, L, lf, lr
+using AxleDual = DualT<double, 5>;
+
+#endif // AXLE_DUAL_H
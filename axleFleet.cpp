@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <cmath>
+#include "axleFleet.hpp"
+#include "axleKernel.hpp"
+#include "threadPool.hpp"
+#include "profiler.hpp"
+
+/********************
+Program    - Axle Load Model - Vehicle Comparison
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Value-matched variant grids, row coefficients batched over dirty vehicles
+        - Version 1   - Per-vehicle constants follow the corrected load transfer
+        - Version 2   - Matching and row scratch reused between calls, one task object per call
+********************/
+
+static bool SameVehicle(const VehicleParams& a, const VehicleParams& b) {
+    return a.m == b.m && a.h == b.h && a.L == b.L && a.lf == b.lf && a.lr == b.lr;
+}
+
+void AxleFleet::Clear() {
+    entries_.clear();
+    steps_[0] = steps_[1] = -1;
+}
+
+int AxleFleet::Evaluate(const std::vector<VehicleParams>& vehicles,
+                        double thetaMin, double thetaMax, int thetaSteps,
+                        double accelMin, double accelMax, int accelSteps,
+                        ThreadPool* pool, const std::function<bool()>& cancel) {
+    PROFILE_SCOPE("AxleFleet::Evaluate");
+    const bool sameRanges = range_[0] == thetaMin && range_[1] == thetaMax && steps_[0] == thetaSteps &&
+                            range_[2] == accelMin && range_[3] == accelMax && steps_[1] == accelSteps;
+    range_[0] = thetaMin; range_[1] = thetaMax; steps_[0] = thetaSteps;
+    range_[2] = accelMin; range_[3] = accelMax; steps_[1] = accelSteps;
+
+    // Keep every grid that already holds a requested vehicle, wherever it sits in the list;
+    // the rest reuse leftover buffers. old_, taken_ and matched_ keep their capacity between
+    // calls, so a steady fleet allocates nothing here.
+    old_.swap(entries_);
+    entries_.clear();
+    entries_.resize(vehicles.size());
+    taken_.assign(old_.size(), 0);
+    matched_.assign(vehicles.size(), 0);
+    if (sameRanges) {
+        for (size_t v = 0; v < vehicles.size(); ++v) {
+            for (size_t o = 0; o < old_.size(); ++o) {
+                if (!taken_[o] && old_[o].valid && SameVehicle(old_[o].vp, vehicles[v])) {
+                    entries_[v] = std::move(old_[o]);
+                    taken_[o] = matched_[v] = 1;
+                    break;
+                }
+            }
+        }
+    }
+    dirty_.clear();
+    size_t spare = 0;
+    for (size_t v = 0; v < vehicles.size(); ++v) {
+        if (matched_[v]) continue;
+        while (spare < old_.size() && taken_[spare]) ++spare;
+        if (spare < old_.size()) {
+            entries_[v].grid = std::move(old_[spare].grid);
+            taken_[spare] = 1;
+        }
+        entries_[v].vp = vehicles[v];
+        entries_[v].valid = false;
+        PrepareAxleGrid(entries_[v].grid, thetaMin, thetaMax, thetaSteps, accelMin, accelMax, accelSteps);
+        dirty_.push_back((int)v);
+    }
+    old_.clear();   // grids of variants no longer requested are freed
+    const int D = (int)dirty_.size();
+    if (D == 0) return 0;
+
+    // Per-vehicle constants of AxleRowCoefficients, in the same operation order
+    aF_.resize(D); aR_.resize(D); b_.resize(D); kF_.resize(D); kR_.resize(D);
+    for (int d = 0; d < D; ++d) {
+        const VehicleParams& vp = entries_[dirty_[d]].vp;
+        const double W = vp.m * g;
+        const double hL = vp.h / vp.L;
+        aF_[d] = (vp.lr / vp.L) * W;
+        aR_[d] = (vp.lf / vp.L) * W;
+        b_[d]  = hL * W;
+        kF_[d] = -hL * vp.m;
+        kR_[d] =  hL * vp.m;
+    }
+
+    const AxleData& axes = entries_[dirty_[0]].grid;
+    const int rows = (int)axes.theta.size(), cols = (int)axes.accel.size();
+    if (rows == 0 || cols == 0) {
+        for (int v : dirty_) entries_[v].valid = true;
+        return D;
+    }
+    ThreadPool& tp = pool ? *pool : DefaultThreadPool();
+
+    // ~256k cells per block across all dirty vehicles, split over the pool
+    const int blockRows = std::max(1, (256 * 1024) / std::max(1, cols * D));
+    const int per = std::max(1, (std::min(rows, blockRows) + tp.Size() - 1) / tp.Size());
+    scratch_.resize(tp.Size());
+    for (std::vector<double>& sc : scratch_) sc.resize(2 * (size_t)D * per);
+    // One task object for every block (a fresh lambda per ParallelFor would allocate each time)
+    int i0 = 0, i1 = 0;
+    const std::function<void(int, int)> rowTask = [&](int t, int worker) {
+        const int a = i0 + t * per, e = std::min(i1, a + per);
+        double* cF = scratch_[worker].data();
+        double* cR = cF + (size_t)D * per;
+        const double* aF = aF_.data(); const double* aR = aR_.data(); const double* b = b_.data();
+        // Shared trig per row, then every dirty vehicle's intercepts in one vector loop
+        for (int i = a; i < e; ++i) {
+            const double c = std::cos(axes.theta[i]);
+            const double s = std::sin(axes.theta[i]);
+            double* rF = cF + (size_t)(i - a) * D;
+            double* rR = cR + (size_t)(i - a) * D;
+            for (int d = 0; d < D; ++d) {
+                rF[d] = aF[d] * c - b[d] * s;
+                rR[d] = aR[d] * c + b[d] * s;
+            }
+        }
+        // Expansion vehicle by vehicle, so each writes its rows as one contiguous stream
+        for (int d = 0; d < D; ++d) {
+            AxleData& grid = entries_[dirty_[d]].grid;
+            for (int i = a; i < e; ++i) {
+                const AxleRowCoeffs rc{cF[(size_t)(i - a) * D + d], kF_[d], cR[(size_t)(i - a) * D + d], kR_[d]};
+                AxleRowKernel(rc, axes.accel.data(), cols, grid.WF.Row(i), grid.WR.Row(i));
+            }
+        }
+    };
+    for (i0 = 0; i0 < rows; i0 += blockRows) {
+        if (cancel && cancel()) return -1;
+        i1 = std::min(rows, i0 + blockRows);
+        tp.ParallelFor((i1 - i0 + per - 1) / per, rowTask);
+    }
+    for (int v : dirty_) entries_[v].valid = true;
+    return D;
+}
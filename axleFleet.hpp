@@ -0,0 +1,62 @@
+/********************
+Program    - Axle Load Model - Vehicle Comparison
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Several vehicles over one shared grid, batched across vehicles, dirty-only recompute
+        - Version 1   - Evaluate() buffers kept as members
+********************/
+
+#ifndef AXLE_FLEET_H
+#define AXLE_FLEET_H
+
+#include <functional>
+#include <vector>
+#include "axleLoads.hpp"
+
+class ThreadPool;
+
+// Loads of a list of vehicle variants over one shared theta x accel grid.
+// Evaluate() keeps each variant's grid between calls and recomputes only the variants whose
+// parameters are not already held (matched by value, so reordering or removing variants costs
+// nothing); a range change recomputes all of them.
+// Recomputed rows are batched across vehicles: cos/sin of theta once per row, the row
+// coefficients of every dirty vehicle in one loop over SoA lanes (vehicles are the vector
+// dimension), then each vehicle's row expanded along accel by the SIMD row kernel.
+// Every grid is bit-identical to CalculateAxleLoads for that vehicle.
+class AxleFleet {
+public:
+    // Returns the number of vehicles recomputed, or -1 when cancel (polled between row blocks)
+    // returned true; variants left half-done are recomputed by the next call.
+    int Evaluate(const std::vector<VehicleParams>& vehicles,
+                 double thetaMin, double thetaMax, int thetaSteps,
+                 double accelMin, double accelMax, int accelSteps,
+                 ThreadPool* pool = nullptr, const std::function<bool()>& cancel = nullptr);
+    void Clear();
+
+    int Size() const { return (int)entries_.size(); }
+    const AxleData& Grid(int v) const { return entries_[v].grid; }
+    const VehicleParams& Params(int v) const { return entries_[v].vp; }
+
+private:
+    struct Entry {
+        VehicleParams vp{};
+        bool valid = false;                  // grid holds vp over the current ranges
+        AxleData grid;
+    };
+    std::vector<Entry> entries_;
+    double range_[4] = {0.0, 0.0, 0.0, 0.0};
+    int steps_[2] = {-1, -1};
+
+    // Per dirty vehicle, SoA: cF = aF*cos - b*sin, cR = aR*cos + b*sin, kF, kR constant
+    std::vector<int> dirty_;
+    std::vector<double> aF_, aR_, b_, kF_, kR_;
+
+    // Reused by every Evaluate(): last call's entries while matching, and per-worker row scratch
+    std::vector<Entry> old_;
+    std::vector<char> taken_, matched_;
+    std::vector<std::vector<double>> scratch_;
+};
+
+#endif // AXLE_FLEET_H
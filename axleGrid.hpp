@@ -0,0 +1,145 @@
+/********************
+Program    - Axle Load Model - Grid Storage
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Flat, aligned, row-major grid with strided row/column views
+        - Version 1   - Templated on scalar type (AxleGrid = double, AxleGridF = float)
+        - Version 2   - Adopt() external (e.g. memory-mapped) storage without copying
+        - Version 3   - Capacity() of the grid's own buffer
+********************/
+
+#ifndef AXLE_GRID_H
+#define AXLE_GRID_H
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Strided read-only view over grid values.
+// stride is in bytes so it can be handed straight to ImPlot's (offset, stride) arguments.
+template <typename T>
+struct GridViewT {
+    const T* data = nullptr;
+    int count = 0;
+    int stride = sizeof(T);
+
+    T operator[](int k) const {
+        return *reinterpret_cast<const T*>(reinterpret_cast<const char*>(data) + (std::size_t)k * stride);
+    }
+};
+
+// Row-major grid in a single aligned allocation.
+// - Rows are padded to a whole cache line so every row starts 64-byte aligned.
+// - Resize() keeps the existing buffer whenever it is large enough, so refilling
+//   a grid of the same (or smaller) shape does not touch the heap.
+// - Adopt() points the grid at storage it does not own (e.g. a copy-on-write file
+//   mapping) without copying; the owner handle keeps that storage alive. The next
+//   Resize() switches back to the grid's own buffer.
+template <typename T>
+class AxleGridT {
+public:
+    static constexpr std::size_t kAlign = 64;                   // bytes
+    static constexpr int kRowPad = (int)(kAlign / sizeof(T));   // elements
+
+    AxleGridT() = default;
+    AxleGridT(int rows, int cols) { Resize(rows, cols); }
+
+    AxleGridT(const AxleGridT& o) { *this = o; }
+    AxleGridT& operator=(const AxleGridT& o) {
+        if (this == &o) return *this;
+        Resize(o.rows_, o.cols_);
+        for (int i = 0; i < o.rows_; ++i)
+            std::memcpy(Row(i), o.Row(i), (std::size_t)o.cols_ * sizeof(T));
+        return *this;
+    }
+    AxleGridT(AxleGridT&& o) noexcept { *this = std::move(o); }
+    AxleGridT& operator=(AxleGridT&& o) noexcept {
+        if (this == &o) return *this;
+        buf_ = std::move(o.buf_);
+        external_ = std::move(o.external_);
+        data_ = o.data_;
+        capacity_ = o.capacity_;
+        rows_ = o.rows_; cols_ = o.cols_; stride_ = o.stride_;
+        o.data_ = nullptr;
+        o.capacity_ = 0;
+        o.Clear();
+        return *this;
+    }
+
+    void Resize(int rows, int cols) {
+        if (rows < 0) rows = 0;
+        if (cols < 0) cols = 0;
+        external_.reset();
+        const int stride = (cols + kRowPad - 1) / kRowPad * kRowPad;
+        const std::size_t need = (std::size_t)rows * stride;
+        if (need > capacity_) {
+            buf_.reset(static_cast<T*>(::operator new[](need * sizeof(T), std::align_val_t(kAlign))));
+            capacity_ = need;
+        }
+        data_ = buf_.get();
+        rows_ = rows;
+        cols_ = cols;
+        stride_ = stride;
+        // Keep the padding lanes defined so whole-row SIMD loads/stores are safe
+        for (int i = 0; i < rows_; ++i)
+            for (int j = cols_; j < stride_; ++j)
+                data_[(std::size_t)i * stride_ + j] = T(0);
+    }
+
+    // Use rows x cols values at data (rows stride elements apart, 64-byte aligned,
+    // padding lanes defined) without copying. owner keeps the memory alive.
+    // The grid's own buffer is kept for the next Resize().
+    void Adopt(std::shared_ptr<void> owner, T* data, int rows, int cols, int stride) {
+        external_ = std::move(owner);
+        data_ = data;
+        rows_ = rows;
+        cols_ = cols;
+        stride_ = stride;
+    }
+
+    void Clear() { external_.reset(); data_ = buf_.get(); rows_ = cols_ = stride_ = 0; }
+
+    bool Empty()    const { return rows_ == 0 || cols_ == 0; }
+    bool External() const { return external_ != nullptr; }
+    int  Rows()     const { return rows_; }
+    int  Cols()     const { return cols_; }
+    int  Stride()   const { return stride_; } // elements between consecutive rows
+    std::size_t Capacity() const { return capacity_; } // elements in the own buffer (kept by Resize)
+
+    T*       Data()       { return data_; }
+    const T* Data() const { return data_; }
+
+    T*       Row(int i)       { return data_ + (std::size_t)i * stride_; }
+    const T* Row(int i) const { return data_ + (std::size_t)i * stride_; }
+
+    T&       operator()(int i, int j)       { return Row(i)[j]; }
+    const T& operator()(int i, int j) const { return Row(i)[j]; }
+
+    // Contiguous view of row i (fixed slope, all accelerations)
+    GridViewT<T> RowView(int i) const { return GridViewT<T>{Row(i), cols_, (int)sizeof(T)}; }
+    // Strided view of column j (fixed acceleration, all slopes)
+    GridViewT<T> ColView(int j) const { return GridViewT<T>{data_ + j, rows_, (int)(stride_ * sizeof(T))}; }
+
+private:
+    struct AlignedDelete {
+        void operator()(T* p) const { ::operator delete[](p, std::align_val_t(kAlign)); }
+    };
+
+    std::unique_ptr<T[], AlignedDelete> buf_;
+    std::shared_ptr<void> external_;          // owner of adopted storage (null when data_ is buf_)
+    T* data_ = nullptr;
+    std::size_t capacity_ = 0;
+    int rows_ = 0;
+    int cols_ = 0;
+    int stride_ = 0;
+};
+
+using GridView  = GridViewT<double>;
+using AxleGrid  = AxleGridT<double>;
+using AxleGridF = AxleGridT<float>;
+
+#endif // AXLE_GRID_H
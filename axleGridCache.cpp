@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "axleGridCache.hpp"
+#include "mappedFile.hpp"
+#include "profiler.hpp"
+
+/********************
+Program    - Axle Load Model - Grid Cache
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - AXGC writer, mapped loader with header/bounds checks, atomic store
+        - Version 1   - Loader rejects unpadded strides and overflowing section sizes
+        - Version 2   - LRU eviction to a size budget, hits refresh the file time
+        - Version 3   - Model version and kernel hashed, stored and checked
+********************/
+
+static const char kGridMagic[4] = {'A', 'X', 'G', 'C'};
+static const std::uint64_t kSectionAlign = AxleGrid::kAlign;
+
+static std::uint64_t AlignUp(std::uint64_t n) {
+    return (n + kSectionAlign - 1) / kSectionAlign * kSectionAlign;
+}
+
+AxleGridCache::AxleGridCache(std::string dir, std::uint64_t maxBytes) : dir_(std::move(dir)), maxBytes_(maxBytes) {}
+
+std::uint64_t AxleGridCache::DefaultBudget() {
+    if (const char* d = std::getenv("AXLE_CACHE_MAX_MB"); d && *d) {
+        const long long mb = std::atoll(d);
+        if (mb > 0) return (std::uint64_t)mb << 20;
+    }
+    return 2048ull << 20;
+}
+
+std::string AxleGridCache::DefaultDirectory() {
+    if (const char* d = std::getenv("AXLE_CACHE_DIR"); d && *d) return d;
+    if (const char* d = std::getenv("XDG_CACHE_HOME"); d && *d) return std::string(d) + "/wheelload";
+    if (const char* d = std::getenv("HOME"); d && *d) return std::string(d) + "/.cache/wheelload";
+    if (const char* d = std::getenv("LOCALAPPDATA"); d && *d) return std::string(d) + "/wheelload";
+    return ".axle_cache";
+}
+
+// FNV-1a, fed field by field so struct padding never reaches the hash
+static void Fnv1a(std::uint64_t& h, const void* p, std::size_t n) {
+    const unsigned char* b = static_cast<const unsigned char*>(p);
+    for (std::size_t i = 0; i < n; ++i) {
+        h ^= b[i];
+        h *= 0x100000001B3ull;
+    }
+}
+
+std::uint64_t AxleGridCache::Hash(const AxleGridKey& k) {
+    std::uint64_t h = 0xCBF29CE484222325ull;
+    const std::uint32_t version = kAxleGridFileVersion, scalar = sizeof(double);
+    Fnv1a(h, &version, sizeof(version));
+    Fnv1a(h, &scalar, sizeof(scalar));
+    for (double v : {k.vp.m, k.vp.h, k.vp.L, k.vp.lf, k.vp.lr,
+                     k.thetaMin, k.thetaMax, k.accelMin, k.accelMax})
+        Fnv1a(h, &v, sizeof(v));
+    Fnv1a(h, &k.thetaSteps, sizeof(k.thetaSteps));
+    Fnv1a(h, &k.accelSteps, sizeof(k.accelSteps));
+    const std::uint32_t kernel = (std::uint32_t)k.kernel;
+    Fnv1a(h, &k.model, sizeof(k.model));
+    Fnv1a(h, &kernel, sizeof(kernel));
+    return h;
+}
+
+std::string AxleGridCache::PathFor(const AxleGridKey& key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.axgc", (unsigned long long)Hash(key));
+    return dir_ + "/" + name;
+}
+
+// Bitwise compare, so a cached grid is only reused for exactly the inputs it was built from
+static bool SameKey(const AxleGridFileHeader& h, const AxleGridKey& k) {
+    auto same = [](double a, double b) { return std::memcmp(&a, &b, sizeof(double)) == 0; };
+    return same(h.vp.m, k.vp.m) && same(h.vp.h, k.vp.h) && same(h.vp.L, k.vp.L)
+        && same(h.vp.lf, k.vp.lf) && same(h.vp.lr, k.vp.lr)
+        && same(h.thetaMin, k.thetaMin) && same(h.thetaMax, k.thetaMax)
+        && same(h.accelMin, k.accelMin) && same(h.accelMax, k.accelMax)
+        && h.thetaSteps == k.thetaSteps && h.accelSteps == k.accelSteps
+        && h.model == k.model && h.kernel == (std::uint32_t)k.kernel;
+}
+
+// Section [offset, offset + bytes) is aligned and inside the file
+static bool SectionOk(std::uint64_t offset, std::uint64_t bytes, std::uint64_t fileBytes) {
+    return offset % kSectionAlign == 0 && offset <= fileBytes && bytes <= fileBytes - offset;
+}
+
+bool AxleGridCache::Load(const AxleGridKey& key, AxleData& out) {
+    PROFILE_SCOPE("AxleGridCache::Load");
+    const std::string path = PathFor(key);
+    auto file = std::make_shared<MappedFile>();
+    if (!file->Open(path, true)) {
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    AxleGridFileHeader h;
+    bool ok = file->Size() >= sizeof(h);
+    if (ok) std::memcpy(&h, file->Data(), sizeof(h));
+    ok = ok && std::memcmp(h.magic, kGridMagic, 4) == 0 && h.version == kAxleGridFileVersion
+            && h.scalarBytes == sizeof(double) && h.fileBytes == file->Size();
+    if (ok && (h.hash != Hash(key) || !SameKey(h, key))) {
+        // Different inputs behind the same name (hash collision) - recompute and overwrite
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    // Adopted rows must keep AxleGrid's alignment, so the stride is a whole number of pads.
+    // Sizes are checked for overflow before they are compared with the file.
+    ok = ok && h.thetaSteps >= 0 && h.accelSteps >= 0 && h.stride >= h.accelSteps
+            && h.stride % AxleGrid::kRowPad == 0;
+    const std::uint64_t rows = ok ? (std::uint64_t)h.thetaSteps : 0, cols = ok ? (std::uint64_t)h.accelSteps : 0;
+    const std::uint64_t stride = ok ? (std::uint64_t)h.stride : 0;
+    ok = ok && (stride == 0 || rows <= UINT64_MAX / sizeof(double) / stride);
+    const std::uint64_t gridBytes = ok ? rows * stride * sizeof(double) : 0;
+    ok = ok && SectionOk(h.thetaOffset, rows * sizeof(double), h.fileBytes)
+            && SectionOk(h.accelOffset, cols * sizeof(double), h.fileBytes)
+            && SectionOk(h.wfOffset, gridBytes, h.fileBytes)
+            && SectionOk(h.wrOffset, gridBytes, h.fileBytes);
+    if (!ok) {
+        std::cerr << path << " is not a version " << kAxleGridFileVersion << " grid file, ignoring it" << std::endl;
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    char* base = file->MutableData();
+    const double* theta = reinterpret_cast<const double*>(base + h.thetaOffset);
+    const double* accel = reinterpret_cast<const double*>(base + h.accelOffset);
+    out.theta.assign(theta, theta + rows);
+    out.accel.assign(accel, accel + cols);
+    out.WF.Adopt(file, reinterpret_cast<double*>(base + h.wfOffset), (int)rows, (int)cols, h.stride);
+    out.WR.Adopt(file, reinterpret_cast<double*>(base + h.wrOffset), (int)rows, (int)cols, h.stride);
+    out.generation = NextAxleGeneration();
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    // Mark as recently used for eviction
+    std::error_code ec;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+    return true;
+}
+
+// Delete the least recently used .axgc files until the directory fits the budget
+void AxleGridCache::Evict() {
+    struct Entry { std::filesystem::file_time_type time; std::uint64_t bytes; std::filesystem::path path; };
+    std::vector<Entry> files;
+    std::uint64_t total = 0;
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(dir_, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->path().extension() != ".axgc") continue;
+        std::error_code fe;
+        const std::uint64_t bytes = it->file_size(fe);
+        const std::filesystem::file_time_type time = it->last_write_time(fe);
+        if (fe) continue;
+        files.push_back({time, bytes, it->path()});
+        total += bytes;
+    }
+    if (total <= maxBytes_) return;
+    std::sort(files.begin(), files.end(), [](const Entry& a, const Entry& b) { return a.time < b.time; });
+    for (const Entry& e : files) {
+        if (total <= maxBytes_) break;
+        // A mapped grid keeps its pages after the unlink (POSIX); elsewhere removal may fail and is retried next store
+        if (std::filesystem::remove(e.path, ec)) total -= e.bytes;
+    }
+}
+
+static bool WriteAt(std::FILE* f, std::uint64_t& pos, std::uint64_t offset, const void* p, std::size_t bytes) {
+    static const char zeros[64] = {};
+    while (pos < offset) {
+        const std::size_t n = (std::size_t)std::min<std::uint64_t>(sizeof(zeros), offset - pos);
+        if (std::fwrite(zeros, 1, n, f) != n) return false;
+        pos += n;
+    }
+    if (bytes && std::fwrite(p, 1, bytes, f) != bytes) return false;
+    pos += bytes;
+    return true;
+}
+
+bool AxleGridCache::Store(const AxleGridKey& key, const AxleData& data) {
+    PROFILE_SCOPE("AxleGridCache::Store");
+    const int rows = data.WF.Rows(), cols = data.WF.Cols(), stride = data.WF.Stride();
+    if (rows != key.thetaSteps || cols != key.accelSteps || (int)data.theta.size() != rows
+        || (int)data.accel.size() != cols || data.WR.Rows() != rows || data.WR.Stride() != stride)
+        return false;
+
+    std::error_code ec;
+    std::filesystem::create_directories(dir_, ec);
+    if (ec) {
+        std::cerr << "Cannot create grid cache directory " << dir_ << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    AxleGridFileHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, kGridMagic, 4);
+    h.version = kAxleGridFileVersion;
+    h.scalarBytes = sizeof(double);
+    h.stride = stride;
+    h.hash = Hash(key);
+    h.model = key.model;
+    h.kernel = (std::uint32_t)key.kernel;
+    h.vp = key.vp;
+    h.thetaMin = key.thetaMin; h.thetaMax = key.thetaMax;
+    h.accelMin = key.accelMin; h.accelMax = key.accelMax;
+    h.thetaSteps = rows; h.accelSteps = cols;
+    const std::uint64_t gridBytes = (std::uint64_t)rows * stride * sizeof(double);
+    h.thetaOffset = AlignUp(sizeof(h));
+    h.accelOffset = AlignUp(h.thetaOffset + (std::uint64_t)rows * sizeof(double));
+    h.wfOffset    = AlignUp(h.accelOffset + (std::uint64_t)cols * sizeof(double));
+    h.wrOffset    = AlignUp(h.wfOffset + gridBytes);
+    h.fileBytes   = h.wrOffset + gridBytes;
+    if (h.fileBytes > maxBytes_ / 4) return false;
+
+    // Unique temporary name per writer, renamed over the final path when complete
+    const std::string path = PathFor(key);
+    char suffix[48];
+    std::snprintf(suffix, sizeof(suffix), ".%zx.%llx.tmp", std::hash<std::thread::id>()(std::this_thread::get_id()),
+                  (unsigned long long)std::chrono::steady_clock::now().time_since_epoch().count());
+    const std::string tmp = path + suffix;
+
+    std::FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (!f) {
+        std::cerr << "Cannot open " << tmp << " for writing" << std::endl;
+        return false;
+    }
+    std::uint64_t pos = 0;
+    bool ok = WriteAt(f, pos, 0, &h, sizeof(h))
+           && WriteAt(f, pos, h.thetaOffset, data.theta.data(), (std::size_t)rows * sizeof(double))
+           && WriteAt(f, pos, h.accelOffset, data.accel.data(), (std::size_t)cols * sizeof(double))
+           && WriteAt(f, pos, h.wfOffset, data.WF.Data(), (std::size_t)gridBytes)
+           && WriteAt(f, pos, h.wrOffset, data.WR.Data(), (std::size_t)gridBytes);
+    ok = std::fclose(f) == 0 && ok;
+    if (ok) {
+        std::filesystem::rename(tmp, path, ec);
+        ok = !ec;
+    }
+    if (!ok) {
+        std::cerr << "Write error on " << path << std::endl;
+        std::filesystem::remove(tmp, ec);
+    }
+    if (ok) Evict();
+    return ok;
+}
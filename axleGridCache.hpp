@@ -0,0 +1,95 @@
+/********************
+Program    - Axle Load Model - Grid Cache
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Versioned grid file format, zero-copy mapped loads, content-addressed cache directory
+        - Version 1   - Size budget with least-recently-used eviction, oversized grids not stored
+        - Version 2   - Model version and row kernel in the key and file header (file version 2)
+********************/
+
+#ifndef AXLE_GRID_CACHE_H
+#define AXLE_GRID_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include "axleKernel.hpp"
+#include "axleLoads.hpp"
+
+// Everything a dense grid depends on: the inputs, the model version and the row kernel that
+// fills it (the FMA kernels round differently from the others), so identical keys give
+// bit-identical grids even in a directory shared between machines and builds
+struct AxleGridKey {
+    VehicleParams vp{};
+    double thetaMin = 0.0, thetaMax = 0.0; int thetaSteps = 0;
+    double accelMin = 0.0, accelMax = 0.0; int accelSteps = 0;
+    std::uint32_t model = kAxleModelVersion;
+    AxleKernelIsa kernel = ActiveAxleKernel();
+};
+
+// Grid file (little-endian, every section 64-byte aligned so it maps straight into AxleGrid):
+//   AxleGridFileHeader
+//   theta   thetaSteps f64
+//   accel   accelSteps f64
+//   WF      rows * stride f64 (row-major, padding lanes zero)
+//   WR      same layout as WF
+struct AxleGridFileHeader {
+    char          magic[4];      // 'AXGC'
+    std::uint32_t version;
+    std::uint32_t scalarBytes;   // sizeof(double)
+    std::int32_t  stride;        // elements between rows of WF / WR
+    std::uint64_t hash;          // AxleGridCache::Hash(key)
+    std::uint32_t model;         // kAxleModelVersion of the build that wrote it
+    std::uint32_t kernel;        // AxleKernelIsa that filled WF / WR
+    VehicleParams vp;            // full key, checked on load (hash collisions)
+    double        thetaMin, thetaMax;
+    double        accelMin, accelMax;
+    std::int32_t  thetaSteps, accelSteps;
+    std::uint64_t thetaOffset, accelOffset, wfOffset, wrOffset;
+    std::uint64_t fileBytes;
+};
+
+const std::uint32_t kAxleGridFileVersion = 2;
+
+// Content-addressed directory of computed grids: <dir>/<hash>.axgc.
+// Load() maps the file copy-on-write and adopts the WF/WR sections into the grid, so a hit
+// costs a few page faults instead of a model evaluation. The mapping lives as long as the
+// grid uses it. Store() writes a temporary file and renames it into place, so readers never
+// see a partial file. Errors are printed to std::cerr; a bad or stale file is just a miss.
+// The directory is kept under maxBytes: after each store the least recently used files (by
+// modification time, which a hit refreshes) are deleted, and a grid larger than a quarter of
+// the budget is not stored at all.
+class AxleGridCache {
+public:
+    explicit AxleGridCache(std::string dir, std::uint64_t maxBytes = DefaultBudget());
+
+    // AXLE_CACHE_DIR, else $XDG_CACHE_HOME/wheelload, else ~/.cache/wheelload, else ./.axle_cache
+    static std::string DefaultDirectory();
+    // AXLE_CACHE_MAX_MB megabytes, else 2 GB
+    static std::uint64_t DefaultBudget();
+
+    // FNV-1a over the file version and every key field, model version and kernel included
+    static std::uint64_t Hash(const AxleGridKey& key);
+    std::string PathFor(const AxleGridKey& key) const;
+
+    // Fill out from the cache (axes copied, WF/WR mapped). False on a miss.
+    bool Load(const AxleGridKey& key, AxleData& out);
+    // Save a grid computed for key, then evict down to the budget. False if not stored
+    // (error, or the file would exceed a quarter of the budget).
+    bool Store(const AxleGridKey& key, const AxleData& data);
+
+    const std::string& Directory() const { return dir_; }
+    std::uint64_t Hits()   const { return hits_.load(std::memory_order_relaxed); }
+    std::uint64_t Misses() const { return misses_.load(std::memory_order_relaxed); }
+
+private:
+    void Evict();
+
+    std::string dir_;
+    std::uint64_t maxBytes_;
+    std::atomic<std::uint64_t> hits_{0}, misses_{0};
+};
+
+#endif // AXLE_GRID_CACHE_H
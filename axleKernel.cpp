@@ -0,0 +1,453 @@
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "axleKernel.hpp"
+#include "axleDual.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define AXLE_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+/********************
+Program    - Axle Load Model - Grid Kernels
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Scalar, SSE2, AVX2 and AVX-512 row kernels + runtime dispatch
+        - Version 1   - Batched point kernel (polynomial sin/cos, auto-vectorized per ISA)
+        - Version 2   - float row/point kernels (twice the lanes per vector)
+        - Version 3   - Row coefficients instantiated for dual numbers (parameter sensitivities)
+        - Version 4   - Load transfer m*h/L*(a + g*sin(theta)); the slope term was missing g, accel had 1/g
+********************/
+
+// Per-row coefficients of the quasi-static model at slope theta
+template <typename T>
+AxleRowCoeffsT<T> AxleRowCoefficients(const VehicleParamsT<T>& vp, T theta) {
+    const T gT = (T)g;
+    const T W = vp.m * gT;
+    using std::cos; using std::sin;   // dual-number overloads via ADL
+    const T c = cos(theta);
+    const T s = sin(theta);
+    const T hL = vp.h / vp.L;
+
+    AxleRowCoeffsT<T> rc;
+    rc.cF = (vp.lr / vp.L) * W * c - hL * W * s;
+    rc.cR = (vp.lf / vp.L) * W * c + hL * W * s;
+    rc.kF = -hL * vp.m;
+    rc.kR =  hL * vp.m;
+    return rc;
+}
+
+template AxleRowCoeffsT<double> AxleRowCoefficients(const VehicleParamsT<double>&, double);
+template AxleRowCoeffsT<float>  AxleRowCoefficients(const VehicleParamsT<float>&, float);
+template AxleRowCoeffsT<AxleDual> AxleRowCoefficients(const VehicleParamsT<AxleDual>&, AxleDual);
+
+// Kernels
+// Scalar/SSE2/AVX2 use a separate multiply and add (their targets do not enable FMA,
+// so the compiler cannot contract the tails); AVX-512 uses FMA everywhere including a
+// masked tail. Either way a cell's result never depends on where the row was split.
+static void RowKernelScalar(const AxleRowCoeffs& c, const double* accel, int n, double* WF, double* WR) {
+    for (int j = 0; j < n; ++j) {
+        const double a = accel[j];
+        WF[j] = c.cF + c.kF * a;
+        WR[j] = c.cR + c.kR * a;
+    }
+}
+
+#if defined(AXLE_KERNEL_X86)
+__attribute__((target("sse2")))
+static void RowKernelSSE2(const AxleRowCoeffs& c, const double* accel, int n, double* WF, double* WR) {
+    const __m128d cF = _mm_set1_pd(c.cF), kF = _mm_set1_pd(c.kF);
+    const __m128d cR = _mm_set1_pd(c.cR), kR = _mm_set1_pd(c.kR);
+    int j = 0;
+    for (; j + 2 <= n; j += 2) {
+        const __m128d a = _mm_loadu_pd(accel + j);
+        _mm_storeu_pd(WF + j, _mm_add_pd(cF, _mm_mul_pd(kF, a)));
+        _mm_storeu_pd(WR + j, _mm_add_pd(cR, _mm_mul_pd(kR, a)));
+    }
+    for (; j < n; ++j) {
+        const double a = accel[j];
+        WF[j] = c.cF + c.kF * a;
+        WR[j] = c.cR + c.kR * a;
+    }
+}
+
+__attribute__((target("avx2")))
+static void RowKernelAVX2(const AxleRowCoeffs& c, const double* accel, int n, double* WF, double* WR) {
+    const __m256d cF = _mm256_set1_pd(c.cF), kF = _mm256_set1_pd(c.kF);
+    const __m256d cR = _mm256_set1_pd(c.cR), kR = _mm256_set1_pd(c.kR);
+    int j = 0;
+    // Two vectors per iteration keeps both store ports busy
+    for (; j + 8 <= n; j += 8) {
+        const __m256d a0 = _mm256_loadu_pd(accel + j);
+        const __m256d a1 = _mm256_loadu_pd(accel + j + 4);
+        _mm256_storeu_pd(WF + j,     _mm256_add_pd(cF, _mm256_mul_pd(kF, a0)));
+        _mm256_storeu_pd(WF + j + 4, _mm256_add_pd(cF, _mm256_mul_pd(kF, a1)));
+        _mm256_storeu_pd(WR + j,     _mm256_add_pd(cR, _mm256_mul_pd(kR, a0)));
+        _mm256_storeu_pd(WR + j + 4, _mm256_add_pd(cR, _mm256_mul_pd(kR, a1)));
+    }
+    for (; j + 4 <= n; j += 4) {
+        const __m256d a = _mm256_loadu_pd(accel + j);
+        _mm256_storeu_pd(WF + j, _mm256_add_pd(cF, _mm256_mul_pd(kF, a)));
+        _mm256_storeu_pd(WR + j, _mm256_add_pd(cR, _mm256_mul_pd(kR, a)));
+    }
+    for (; j < n; ++j) {
+        const double a = accel[j];
+        WF[j] = c.cF + c.kF * a;
+        WR[j] = c.cR + c.kR * a;
+    }
+}
+
+__attribute__((target("avx512f")))
+static void RowKernelAVX512(const AxleRowCoeffs& c, const double* accel, int n, double* WF, double* WR) {
+    const __m512d cF = _mm512_set1_pd(c.cF), kF = _mm512_set1_pd(c.kF);
+    const __m512d cR = _mm512_set1_pd(c.cR), kR = _mm512_set1_pd(c.kR);
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        const __m512d a = _mm512_loadu_pd(accel + j);
+        _mm512_storeu_pd(WF + j, _mm512_fmadd_pd(kF, a, cF));
+        _mm512_storeu_pd(WR + j, _mm512_fmadd_pd(kR, a, cR));
+    }
+    if (j < n) {
+        const __mmask8 m = (__mmask8)((1u << (n - j)) - 1u);
+        const __m512d a = _mm512_maskz_loadu_pd(m, accel + j);
+        _mm512_mask_storeu_pd(WF + j, m, _mm512_fmadd_pd(kF, a, cF));
+        _mm512_mask_storeu_pd(WR + j, m, _mm512_fmadd_pd(kR, a, cR));
+    }
+}
+#endif
+
+// float row kernels - same structure, twice the lanes per vector
+static void RowKernelScalarF(const AxleRowCoeffsF& c, const float* accel, int n, float* WF, float* WR) {
+    for (int j = 0; j < n; ++j) {
+        const float a = accel[j];
+        WF[j] = c.cF + c.kF * a;
+        WR[j] = c.cR + c.kR * a;
+    }
+}
+
+#if defined(AXLE_KERNEL_X86)
+__attribute__((target("sse2")))
+static void RowKernelSSE2F(const AxleRowCoeffsF& c, const float* accel, int n, float* WF, float* WR) {
+    const __m128 cF = _mm_set1_ps(c.cF), kF = _mm_set1_ps(c.kF);
+    const __m128 cR = _mm_set1_ps(c.cR), kR = _mm_set1_ps(c.kR);
+    int j = 0;
+    for (; j + 4 <= n; j += 4) {
+        const __m128 a = _mm_loadu_ps(accel + j);
+        _mm_storeu_ps(WF + j, _mm_add_ps(cF, _mm_mul_ps(kF, a)));
+        _mm_storeu_ps(WR + j, _mm_add_ps(cR, _mm_mul_ps(kR, a)));
+    }
+    for (; j < n; ++j) {
+        const float a = accel[j];
+        WF[j] = c.cF + c.kF * a;
+        WR[j] = c.cR + c.kR * a;
+    }
+}
+
+__attribute__((target("avx2")))
+static void RowKernelAVX2F(const AxleRowCoeffsF& c, const float* accel, int n, float* WF, float* WR) {
+    const __m256 cF = _mm256_set1_ps(c.cF), kF = _mm256_set1_ps(c.kF);
+    const __m256 cR = _mm256_set1_ps(c.cR), kR = _mm256_set1_ps(c.kR);
+    int j = 0;
+    for (; j + 16 <= n; j += 16) {
+        const __m256 a0 = _mm256_loadu_ps(accel + j);
+        const __m256 a1 = _mm256_loadu_ps(accel + j + 8);
+        _mm256_storeu_ps(WF + j,     _mm256_add_ps(cF, _mm256_mul_ps(kF, a0)));
+        _mm256_storeu_ps(WF + j + 8, _mm256_add_ps(cF, _mm256_mul_ps(kF, a1)));
+        _mm256_storeu_ps(WR + j,     _mm256_add_ps(cR, _mm256_mul_ps(kR, a0)));
+        _mm256_storeu_ps(WR + j + 8, _mm256_add_ps(cR, _mm256_mul_ps(kR, a1)));
+    }
+    for (; j + 8 <= n; j += 8) {
+        const __m256 a = _mm256_loadu_ps(accel + j);
+        _mm256_storeu_ps(WF + j, _mm256_add_ps(cF, _mm256_mul_ps(kF, a)));
+        _mm256_storeu_ps(WR + j, _mm256_add_ps(cR, _mm256_mul_ps(kR, a)));
+    }
+    for (; j < n; ++j) {
+        const float a = accel[j];
+        WF[j] = c.cF + c.kF * a;
+        WR[j] = c.cR + c.kR * a;
+    }
+}
+
+__attribute__((target("avx512f")))
+static void RowKernelAVX512F(const AxleRowCoeffsF& c, const float* accel, int n, float* WF, float* WR) {
+    const __m512 cF = _mm512_set1_ps(c.cF), kF = _mm512_set1_ps(c.kF);
+    const __m512 cR = _mm512_set1_ps(c.cR), kR = _mm512_set1_ps(c.kR);
+    int j = 0;
+    for (; j + 16 <= n; j += 16) {
+        const __m512 a = _mm512_loadu_ps(accel + j);
+        _mm512_storeu_ps(WF + j, _mm512_fmadd_ps(kF, a, cF));
+        _mm512_storeu_ps(WR + j, _mm512_fmadd_ps(kR, a, cR));
+    }
+    if (j < n) {
+        const __mmask16 m = (__mmask16)((1u << (n - j)) - 1u);
+        const __m512 a = _mm512_maskz_loadu_ps(m, accel + j);
+        _mm512_mask_storeu_ps(WF + j, m, _mm512_fmadd_ps(kF, a, cF));
+        _mm512_mask_storeu_ps(WR + j, m, _mm512_fmadd_ps(kR, a, cR));
+    }
+}
+#endif
+
+// Point kernel
+// sin/cos of x: reduce by n = round(x * 2/pi) with a three-part pi/2, evaluate Taylor
+// polynomials on |r| <= pi/4 (truncation < 1e-19), then rotate by the quadrant n mod 4.
+// Straight-line code only, so the loop body below vectorizes for any target.
+__attribute__((always_inline))
+static inline void PolySinCos(double x, double& s, double& c) {
+    const double kRound  = 6755399441055744.0;          // 1.5 * 2^52: add/sub rounds to integer
+    const double kTwoPi  = 0.63661977236758134308;      // 2/pi
+    const double kPio2a  = 1.57079632673412561417e+00;  // first 33 bits of pi/2
+    const double kPio2b  = 6.07710050630396597660e-11;  // next 33 bits
+    const double kPio2c  = 2.02226624879595063154e-21;  // remainder
+
+    const double t = x * kTwoPi + kRound;
+    std::int64_t bits;
+    std::memcpy(&bits, &t, sizeof(bits));
+    const double n = t - kRound;
+    const double r = ((x - n * kPio2a) - n * kPio2b) - n * kPio2c;
+    const double r2 = r * r;
+
+    // sin(r) = r - r^3/3! + ... - r^19/19!; cos(r) = 1 - r^2/2! + ... + r^20/20!
+    double sr = -1.0 / 121645100408832000.0;             // -1/19!
+    sr = sr * r2 + 1.0 / 355687428096000.0;              //  1/17!
+    sr = sr * r2 - 1.0 / 1307674368000.0;                // -1/15!
+    sr = sr * r2 + 1.0 / 6227020800.0;                   //  1/13!
+    sr = sr * r2 - 1.0 / 39916800.0;                     // -1/11!
+    sr = sr * r2 + 1.0 / 362880.0;                       //  1/9!
+    sr = sr * r2 - 1.0 / 5040.0;                         // -1/7!
+    sr = sr * r2 + 1.0 / 120.0;                          //  1/5!
+    sr = sr * r2 - 1.0 / 6.0;                            // -1/3!
+    sr = r + r * r2 * sr;
+
+    double cr = 1.0 / 2432902008176640000.0;             //  1/20!
+    cr = cr * r2 - 1.0 / 6402373705728000.0;             // -1/18!
+    cr = cr * r2 + 1.0 / 20922789888000.0;               //  1/16!
+    cr = cr * r2 - 1.0 / 87178291200.0;                  // -1/14!
+    cr = cr * r2 + 1.0 / 479001600.0;                    //  1/12!
+    cr = cr * r2 - 1.0 / 3628800.0;                      // -1/10!
+    cr = cr * r2 + 1.0 / 40320.0;                        //  1/8!
+    cr = cr * r2 - 1.0 / 720.0;                          // -1/6!
+    cr = cr * r2 + 1.0 / 24.0;                           //  1/4!
+    cr = cr * r2 - 0.5;                                  // -1/2!
+    cr = 1.0 + r2 * cr;
+
+    // Quadrant: 0 -> (s, c), 1 -> (c, -s), 2 -> (-s, -c), 3 -> (-c, s)
+    const std::int64_t q = bits & 3;
+    const double s0 = (q & 1) ? cr : sr;
+    const double c0 = (q & 1) ? sr : cr;
+    s = (q & 2) ? -s0 : s0;
+    c = ((q + 1) & 2) ? -c0 : c0;
+}
+
+// float sin/cos: same scheme with a 1.5 * 2^23 rounding constant, a three-part pi/2 whose
+// leading parts multiply n exactly, and polynomials cut where they drop below float ulp
+__attribute__((always_inline))
+static inline void PolySinCosF(float x, float& s, float& c) {
+    const float kRound = 12582912.0f;                   // 1.5 * 2^23
+    const float kTwoPi = 0.636619772f;                  // 2/pi
+    const float kPio2a = 1.5703125f;                    // pi/2 split, 8 + 11 + 24 bits
+    const float kPio2b = 4.837512969970703125e-4f;
+    const float kPio2c = 7.54978995489188216e-8f;
+
+    const float t = x * kTwoPi + kRound;
+    std::int32_t bits;
+    std::memcpy(&bits, &t, sizeof(bits));
+    const float n = t - kRound;
+    const float r = ((x - n * kPio2a) - n * kPio2b) - n * kPio2c;
+    const float r2 = r * r;
+
+    // sin to r^9, cos to r^10 (truncation < 2e-9 on |r| <= pi/4)
+    float sr = 1.0f / 362880.0f;
+    sr = sr * r2 - 1.0f / 5040.0f;
+    sr = sr * r2 + 1.0f / 120.0f;
+    sr = sr * r2 - 1.0f / 6.0f;
+    sr = r + r * r2 * sr;
+
+    float cr = -1.0f / 3628800.0f;
+    cr = cr * r2 + 1.0f / 40320.0f;
+    cr = cr * r2 - 1.0f / 720.0f;
+    cr = cr * r2 + 1.0f / 24.0f;
+    cr = cr * r2 - 0.5f;
+    cr = 1.0f + r2 * cr;
+
+    const std::int32_t q = bits & 3;
+    const float s0 = (q & 1) ? cr : sr;
+    const float c0 = (q & 1) ? sr : cr;
+    s = (q & 2) ? -s0 : s0;
+    c = ((q + 1) & 2) ? -c0 : c0;
+}
+
+template <typename T>
+AxlePointCoeffsT<T> AxlePointCoefficients(const VehicleParamsT<T>& vp) {
+    const T gT = (T)g;
+    AxlePointCoeffsT<T> pc;
+    pc.pF = (vp.lr / vp.L) * vp.m * gT;
+    pc.pR = (vp.lf / vp.L) * vp.m * gT;
+    pc.k  = (vp.h / vp.L) * vp.m;
+    pc.q  = pc.k * gT;
+    return pc;
+}
+
+template AxlePointCoeffsT<double> AxlePointCoefficients(const VehicleParamsT<double>&);
+template AxlePointCoeffsT<float>  AxlePointCoefficients(const VehicleParamsT<float>&);
+
+__attribute__((always_inline))
+static inline void PointKernelBody(const AxlePointCoeffs& pc, const double* __restrict theta,
+                                   const double* __restrict accel, std::size_t n,
+                                   double* __restrict WF, double* __restrict WR) {
+    for (std::size_t k = 0; k < n; ++k) {
+        double s, c;
+        PolySinCos(theta[k], s, c);
+        const double shift = pc.q * s + pc.k * accel[k];
+        WF[k] = pc.pF * c - shift;
+        WR[k] = pc.pR * c + shift;
+    }
+}
+
+__attribute__((always_inline))
+static inline void PointKernelBodyF(const AxlePointCoeffsF& pc, const float* __restrict theta,
+                                    const float* __restrict accel, std::size_t n,
+                                    float* __restrict WF, float* __restrict WR) {
+    for (std::size_t k = 0; k < n; ++k) {
+        float s, c;
+        PolySinCosF(theta[k], s, c);
+        const float shift = pc.q * s + pc.k * accel[k];
+        WF[k] = pc.pF * c - shift;
+        WR[k] = pc.pR * c + shift;
+    }
+}
+
+static void PointKernelScalar(const AxlePointCoeffs& pc, const double* theta, const double* accel,
+                              std::size_t n, double* WF, double* WR) {
+    PointKernelBody(pc, theta, accel, n, WF, WR);
+}
+
+static void PointKernelScalarF(const AxlePointCoeffsF& pc, const float* theta, const float* accel,
+                               std::size_t n, float* WF, float* WR) {
+    PointKernelBodyF(pc, theta, accel, n, WF, WR);
+}
+
+#if defined(AXLE_KERNEL_X86)
+__attribute__((target("avx2,fma")))
+static void PointKernelAVX2(const AxlePointCoeffs& pc, const double* theta, const double* accel,
+                            std::size_t n, double* WF, double* WR) {
+    PointKernelBody(pc, theta, accel, n, WF, WR);
+}
+
+__attribute__((target("avx512f")))
+static void PointKernelAVX512(const AxlePointCoeffs& pc, const double* theta, const double* accel,
+                              std::size_t n, double* WF, double* WR) {
+    PointKernelBody(pc, theta, accel, n, WF, WR);
+}
+
+__attribute__((target("avx2,fma")))
+static void PointKernelAVX2F(const AxlePointCoeffsF& pc, const float* theta, const float* accel,
+                             std::size_t n, float* WF, float* WR) {
+    PointKernelBodyF(pc, theta, accel, n, WF, WR);
+}
+
+__attribute__((target("avx512f")))
+static void PointKernelAVX512F(const AxlePointCoeffsF& pc, const float* theta, const float* accel,
+                               std::size_t n, float* WF, float* WR) {
+    PointKernelBodyF(pc, theta, accel, n, WF, WR);
+}
+#endif
+
+// Dispatch
+using RowKernelFn = void (*)(const AxleRowCoeffs&, const double*, int, double*, double*);
+
+static RowKernelFn KernelFor(AxleKernelIsa isa) {
+    switch (isa) {
+#if defined(AXLE_KERNEL_X86)
+        case AxleKernelIsa::AVX512: return RowKernelAVX512;
+        case AxleKernelIsa::AVX2:   return RowKernelAVX2;
+        case AxleKernelIsa::SSE2:   return RowKernelSSE2;
+#endif
+        default:                    return RowKernelScalar;
+    }
+}
+
+using RowKernelFnF = void (*)(const AxleRowCoeffsF&, const float*, int, float*, float*);
+
+static RowKernelFnF KernelForF(AxleKernelIsa isa) {
+    switch (isa) {
+#if defined(AXLE_KERNEL_X86)
+        case AxleKernelIsa::AVX512: return RowKernelAVX512F;
+        case AxleKernelIsa::AVX2:   return RowKernelAVX2F;
+        case AxleKernelIsa::SSE2:   return RowKernelSSE2F;
+#endif
+        default:                    return RowKernelScalarF;
+    }
+}
+
+AxleKernelIsa DetectAxleKernel() {
+    static const AxleKernelIsa best = [] {
+#if defined(AXLE_KERNEL_X86)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return AxleKernelIsa::AVX512;
+        if (__builtin_cpu_supports("avx2"))    return AxleKernelIsa::AVX2;
+        if (__builtin_cpu_supports("sse2"))    return AxleKernelIsa::SSE2;
+#endif
+        return AxleKernelIsa::Scalar;
+    }();
+    return best;
+}
+
+static std::atomic<int> activeIsa{-1};
+
+AxleKernelIsa ActiveAxleKernel() {
+    int isa = activeIsa.load(std::memory_order_relaxed);
+    if (isa < 0) {
+        isa = (int)DetectAxleKernel();
+        activeIsa.store(isa, std::memory_order_relaxed);
+    }
+    return (AxleKernelIsa)isa;
+}
+
+AxleKernelIsa SetAxleKernel(AxleKernelIsa isa) {
+    if ((int)isa > (int)DetectAxleKernel()) isa = DetectAxleKernel();
+    activeIsa.store((int)isa, std::memory_order_relaxed);
+    return isa;
+}
+
+const char* AxleKernelName(AxleKernelIsa isa) {
+    switch (isa) {
+        case AxleKernelIsa::AVX512: return "avx512";
+        case AxleKernelIsa::AVX2:   return "avx2";
+        case AxleKernelIsa::SSE2:   return "sse2";
+        default:                    return "scalar";
+    }
+}
+
+void AxleRowKernel(const AxleRowCoeffs& c, const double* accel, int n, double* WF, double* WR) {
+    KernelFor(ActiveAxleKernel())(c, accel, n, WF, WR);
+}
+
+void AxleRowKernel(const AxleRowCoeffsF& c, const float* accel, int n, float* WF, float* WR) {
+    KernelForF(ActiveAxleKernel())(c, accel, n, WF, WR);
+}
+
+void AxlePointKernel(const AxlePointCoeffs& c, const double* theta, const double* accel,
+                     std::size_t n, double* WF, double* WR) {
+    switch (ActiveAxleKernel()) {
+#if defined(AXLE_KERNEL_X86)
+        case AxleKernelIsa::AVX512: PointKernelAVX512(c, theta, accel, n, WF, WR); return;
+        case AxleKernelIsa::AVX2:   PointKernelAVX2(c, theta, accel, n, WF, WR);   return;
+#endif
+        default:                    PointKernelScalar(c, theta, accel, n, WF, WR); return;
+    }
+}
+
+void AxlePointKernel(const AxlePointCoeffsF& c, const float* theta, const float* accel,
+                     std::size_t n, float* WF, float* WR) {
+    switch (ActiveAxleKernel()) {
+#if defined(AXLE_KERNEL_X86)
+        case AxleKernelIsa::AVX512: PointKernelAVX512F(c, theta, accel, n, WF, WR); return;
+        case AxleKernelIsa::AVX2:   PointKernelAVX2F(c, theta, accel, n, WF, WR);   return;
+#endif
+        default:                    PointKernelScalarF(c, theta, accel, n, WF, WR); return;
+    }
+}
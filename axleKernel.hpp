@@ -0,0 +1,79 @@
+/********************
+Program    - Axle Load Model - Grid Kernels
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Row kernel with runtime SIMD dispatch (Scalar/SSE2/AVX2/AVX-512)
+        - Version 1   - Batched point kernel with vectorizable sin/cos
+        - Version 2   - float overloads of the row and point kernels
+        - Version 3   - Row coefficients also instantiated for AxleDual
+********************/
+
+#ifndef AXLE_KERNEL_H
+#define AXLE_KERNEL_H
+
+#include <cstddef>
+#include "axleLoads.hpp"
+
+// For a fixed slope each grid row is affine in acceleration:
+//   WF[j] = cF + kF * accel[j]
+//   WR[j] = cR + kR * accel[j]
+// so all trigonometry is hoisted out to one evaluation per row.
+template <typename T>
+struct AxleRowCoeffsT {
+    T cF, kF; // Front: intercept, slope w.r.t. accel
+    T cR, kR; // Rear:  intercept, slope w.r.t. accel
+};
+using AxleRowCoeffs  = AxleRowCoeffsT<double>;
+using AxleRowCoeffsF = AxleRowCoeffsT<float>;
+
+// Instruction set used by the row kernel
+enum class AxleKernelIsa { Scalar, SSE2, AVX2, AVX512 };
+
+// Per-row coefficients of the quasi-static model at slope theta (float/double, and
+// AxleDual for parameter sensitivities - see axleSensitivity.hpp)
+template <typename T>
+AxleRowCoeffsT<T> AxleRowCoefficients(const VehicleParamsT<T>& vp, T theta);
+
+// Fill n cells of one row (WF and WR in a single pass) with the active kernel.
+// Every cell goes through the same operation sequence wherever the row is split,
+// so filling a row in sub-ranges is bit-identical to filling it in one call.
+void AxleRowKernel(const AxleRowCoeffs& c, const double* accel, int n, double* WF, double* WR);
+void AxleRowKernel(const AxleRowCoeffsF& c, const float* accel, int n, float* WF, float* WR);
+
+// Per-vehicle coefficients for independent (theta, accel) samples:
+//   WF = pF * cos(theta) - q * sin(theta) - k * accel
+//   WR = pR * cos(theta) + q * sin(theta) + k * accel
+template <typename T>
+struct AxlePointCoeffsT {
+    T pF, pR; // static axle shares of m*g
+    T q;      // m*g*h/L
+    T k;      // m*h/L
+};
+using AxlePointCoeffs  = AxlePointCoeffsT<double>;
+using AxlePointCoeffsF = AxlePointCoeffsT<float>;
+
+template <typename T>
+AxlePointCoeffsT<T> AxlePointCoefficients(const VehicleParamsT<T>& vp);
+
+// Evaluate n independent samples with the active kernel.
+// sin/cos use a branch-free Cody-Waite reduction + polynomial (within a few ulp of libm)
+// so whole batches vectorize instead of calling libm per sample.
+void AxlePointKernel(const AxlePointCoeffs& c, const double* theta, const double* accel,
+                     std::size_t n, double* WF, double* WR);
+// float: single-precision reduction and shorter polynomials (within a few float ulp of sinf/cosf)
+void AxlePointKernel(const AxlePointCoeffsF& c, const float* theta, const float* accel,
+                     std::size_t n, float* WF, float* WR);
+
+// Best kernel supported by this CPU (detected once)
+AxleKernelIsa DetectAxleKernel();
+
+// Active kernel. SetAxleKernel() clamps the request to what the CPU supports
+// and returns the kernel actually selected (used by benchmarks to compare paths).
+AxleKernelIsa ActiveAxleKernel();
+AxleKernelIsa SetAxleKernel(AxleKernelIsa isa);
+
+const char* AxleKernelName(AxleKernelIsa isa);
+
+#endif // AXLE_KERNEL_H
@@ -1,6 +1,11 @@
+#include <atomic>
 #include <iostream>
 #include <vector>
+#include <cmath>
 #include "axleLoads.hpp"
+#include "axleKernel.hpp"
+#include "threadPool.hpp"
+#include "profiler.hpp"
 
 /********************
 Program    - Axle Load Model - Axle Load Fncs
@@ -9,58 +14,163 @@ File       - Program Header
 Version    - 0
     - Release Notes:
         - Version 0   - Axle Load functions
+        - Version 1   - In-place grid fill into flat AxleGrid storage
+        - Version 2   - Row-affine SIMD kernel (axleKernel.cpp) for the grid fill
+        - Version 3   - Tiled, work-stolen parallel grid fill
+        - Version 4   - Batched point evaluation via the point kernel
+        - Version 5   - Public grid preparation + row-range fill
+        - Version 6   - Generation id stamped on every grid preparation
+        - Version 7   - Profiler scopes on the grid fills
+        - Version 8   - float/double instantiations of the model
+        - Version 9   - Nominal load transfer m*h/L*(a + g*sin(theta)), as in the README
 ********************/
 
 // Nonlinear load Model
-AxleData CalculateAxleLoads (
-    const VehicleParams& vp,
+template <typename T>
+AxleDataT<T> CalculateAxleLoads (
+    const VehicleParamsT<T>& vp,
     double thetaMin, double thetaMax, int thetaSteps,
     double accelMin, double accelMax, int accelSteps
 ) {
-    AxleData data;
+    AxleDataT<T> data;
+    CalculateAxleLoads(data, vp, thetaMin, thetaMax, thetaSteps, accelMin, accelMax, accelSteps);
+    return data;
+}
+
+std::uint64_t NextAxleGeneration() {
+    static std::atomic<std::uint64_t> counter{0};
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
 
-    double W = vp.m * g; // Total Load
-    data.theta.resize(thetaSteps); // ?
-    data.accel.resize(accelSteps); // ?
-    data.WF.resize(thetaSteps, std::vector<double>(accelSteps)); // ?
-    data.WR.resize(thetaSteps, std::vector<double>(accelSteps)); // ?
+// Shape the grid and fill the theta/accel axes (shared by the serial and parallel fills)
+template <typename T>
+void PrepareAxleGrid (
+    AxleDataT<T>& data,
+    double thetaMin, double thetaMax, int thetaSteps,
+    double accelMin, double accelMax, int accelSteps
+) {
+    if (thetaSteps < 0) thetaSteps = 0;
+    if (accelSteps < 0) accelSteps = 0;
+    data.theta.resize(thetaSteps);
+    data.accel.resize(accelSteps);
+    data.WF.Resize(thetaSteps, accelSteps);
+    data.WR.Resize(thetaSteps, accelSteps);
+    data.generation = NextAxleGeneration();
 
-    // // Create the slope and accel vectors
+    // Create the slope and accel vectors
+    const double dTheta = thetaSteps > 1 ? (thetaMax - thetaMin) / (thetaSteps - 1) : 0.0;
+    const double dAccel = accelSteps > 1 ? (accelMax - accelMin) / (accelSteps - 1) : 0.0;
     for (int i = 0; i < thetaSteps; ++i)
-        data.theta[i] = thetaMin + i * (thetaMax - thetaMin) / (thetaSteps - 1);
+        data.theta[i] = (T)(thetaMin + i * dTheta);
 
     for (int j = 0; j < accelSteps; ++j)
-        data.accel[j] = accelMin + j * (accelMax - accelMin) / (accelSteps - 1);
-
-    // Compute Loads
-    for (int i = 0; i < thetaSteps; ++i) {
-        double thetaI = data.theta[i];
-        for (int j = 0; j < accelSteps; ++j) {
-            double aI = data.accel[j];
-            
-            double WF = (vp.lr / vp.L) * W * std::cos(thetaI) - (vp.h / vp.L) * vp.m * (std::sin(thetaI) + aI / g);
+        data.accel[j] = (T)(accelMin + j * dAccel);
+}
 
-            double WR = (vp.lf / vp.L) * W * std::cos(thetaI) + (vp.h / vp.L) * vp.m * (std::sin(thetaI) + aI / g);
+// Nonlinear load Model - in-place fill of a caller-owned grid
+template <typename T>
+void CalculateAxleLoads (
+    AxleDataT<T>& data,
+    const VehicleParamsT<T>& vp,
+    double thetaMin, double thetaMax, int thetaSteps,
+    double accelMin, double accelMax, int accelSteps
+) {
+    PROFILE_SCOPE("CalculateAxleLoads");
+    PrepareAxleGrid(data, thetaMin, thetaMax, thetaSteps, accelMin, accelMax, accelSteps);
+    CalculateAxleLoadRows(data, vp, 0, data.WF.Rows());
+}
 
-            data.WF[i][j] = WF;
-            data.WR[i][j] = WR;
-        }
+// Compute Loads for rows [i0, i1) - trig hoisted per row, each row filled by the SIMD row kernel
+template <typename T>
+void CalculateAxleLoadRows (
+    AxleDataT<T>& data,
+    const VehicleParamsT<T>& vp,
+    int i0, int i1
+) {
+    const int accelSteps = (int)data.accel.size();
+    for (int i = i0; i < i1; ++i) {
+        const AxleRowCoeffsT<T> rc = AxleRowCoefficients(vp, data.theta[i]);
+        AxleRowKernel(rc, data.accel.data(), accelSteps, data.WF.Row(i), data.WR.Row(i));
     }
-    return data;
 }
 
+// Nonlinear load Model - tiled parallel fill
+template <typename T>
+void CalculateAxleLoadsParallel (
+    AxleDataT<T>& data,
+    const VehicleParamsT<T>& vp,
+    double thetaMin, double thetaMax, int thetaSteps,
+    double accelMin, double accelMax, int accelSteps,
+    ThreadPool& pool
+) {
+    PROFILE_SCOPE("CalculateAxleLoadsParallel");
+    PrepareAxleGrid(data, thetaMin, thetaMax, thetaSteps, accelMin, accelMax, accelSteps);
+    thetaSteps = data.WF.Rows();
+    accelSteps = data.WF.Cols();
+    if (thetaSteps == 0 || accelSteps == 0) return;
+
+    // Tiles of ~256 KB of output per grid - whole cache lines wide, so
+    // neighbouring tiles never write to the same line
+    const int kTileCells = 256 * 1024 / (int)sizeof(T);
+    const int kMaxTileCols = 32 * 1024 / (int)sizeof(T);
+    const int tileCols = accelSteps < kMaxTileCols ? accelSteps : kMaxTileCols;
+    const int tileRows = tileCols >= kTileCells ? 1 : kTileCells / tileCols;
+    const int tilesAcross = (accelSteps + tileCols - 1) / tileCols;
+    const int tilesDown   = (thetaSteps + tileRows - 1) / tileRows;
+
+    pool.ParallelFor(tilesAcross * tilesDown, [&](int tile, int) {
+        const int i0 = (tile / tilesAcross) * tileRows;
+        const int j0 = (tile % tilesAcross) * tileCols;
+        const int i1 = i0 + tileRows < thetaSteps ? i0 + tileRows : thetaSteps;
+        const int n  = j0 + tileCols < accelSteps ? tileCols : accelSteps - j0;
+        for (int i = i0; i < i1; ++i) {
+            const AxleRowCoeffsT<T> rc = AxleRowCoefficients(vp, data.theta[i]);
+            AxleRowKernel(rc, data.accel.data() + j0, n, data.WF.Row(i) + j0, data.WR.Row(i) + j0);
+        }
+    });
+}
 
 // Nominal Axle Loads at the operating point
-std::pair<double, double> CalculateNominalAxleLoads(
-    const VehicleParams& vp, 
-    double thetaNom, 
-    double accelNom
+template <typename T>
+std::pair<T, T> CalculateNominalAxleLoads(
+    const VehicleParamsT<T>& vp, 
+    T thetaNom, 
+    T accelNom
 ) {
-    double W = vp.m * g;
+    const T gT = (T)g;
+    T W = vp.m * gT;
 
-    double WFOp = (vp.lr / vp.L) * W * std::cos(thetaNom) - (vp.h / vp.L) * vp.m * (std::sin(thetaNom) + accelNom / g);
+    T WFOp = (vp.lr / vp.L) * W * std::cos(thetaNom) - (vp.h / vp.L) * vp.m * (accelNom + gT * std::sin(thetaNom));
     
-    double WROp = (vp.lf / vp.L) * W * std::cos(thetaNom) + (vp.h / vp.L) * vp.m * (std::sin(thetaNom) + accelNom / g);
+    T WROp = (vp.lf / vp.L) * W * std::cos(thetaNom) + (vp.h / vp.L) * vp.m * (accelNom + gT * std::sin(thetaNom));
 
     return {WFOp, WROp};
 }
+
+
+// Axle loads for a batch of independent samples
+template <typename T>
+void CalculateAxleLoadsBatch(
+    const VehicleParamsT<T>& vp,
+    const T* theta,
+    const T* accel,
+    std::size_t n,
+    T* WF,
+    T* WR
+) {
+    AxlePointKernel(AxlePointCoefficients(vp), theta, accel, n, WF, WR);
+}
+
+// Instantiations
+#define AXLE_INSTANTIATE_MODEL(T) \
+    template AxleDataT<T> CalculateAxleLoads(const VehicleParamsT<T>&, double, double, int, double, double, int); \
+    template void CalculateAxleLoads(AxleDataT<T>&, const VehicleParamsT<T>&, double, double, int, double, double, int); \
+    template void PrepareAxleGrid(AxleDataT<T>&, double, double, int, double, double, int); \
+    template void CalculateAxleLoadRows(AxleDataT<T>&, const VehicleParamsT<T>&, int, int); \
+    template void CalculateAxleLoadsParallel(AxleDataT<T>&, const VehicleParamsT<T>&, double, double, int, double, double, int, ThreadPool&); \
+    template std::pair<T, T> CalculateNominalAxleLoads(const VehicleParamsT<T>&, T, T); \
+    template void CalculateAxleLoadsBatch(const VehicleParamsT<T>&, const T*, const T*, std::size_t, T*, T*);
+
+AXLE_INSTANTIATE_MODEL(double)
+AXLE_INSTANTIATE_MODEL(float)
+#undef AXLE_INSTANTIATE_MODEL
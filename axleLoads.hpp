@@ -6,33 +6,100 @@ File       - Program Header
 Version    - 0
     - Release Notes:
         - Version 0   - Class structure for Axle Load functions
+        - Version 1   - Flat aligned grids for WF/WR, in-place grid fill
+        - Version 2   - Opt-in tiled parallel grid fill on a ThreadPool
+        - Version 3   - Batched point evaluation
+        - Version 4   - Row-range fill for incremental/cancellable evaluation
+        - Version 5   - Data generation ids for downstream caches
+        - Version 6   - Model and grid types templated on float/double
+        - Version 7   - Model version constant for persisted grids
+        - Version 8   - Model version 2: load transfer term corrected
 ********************/
 
 #ifndef AXLE_LOAD_H
 #define AXLE_LOAD_H
 
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "axleGrid.hpp"
+
 // Global Constants
 const double g = 9.81; // gravity m/s^2
 
-struct VehicleParams {
-    double m;  // Mass
-    double h;  // CoG height
-    double L;  // Wheelbase
-    double lf; // Front to CoG Length
-    double lr; // Rear to CoG Length
+// Bumped whenever the model equations change, so grids cached by an older build are not reused
+const std::uint32_t kAxleModelVersion = 2;
+
+// Model types are templated on the scalar type. double is the reference model;
+// float halves the grid footprint and doubles the SIMD width (see the accuracy
+// report in WheelLoadBench --accuracy for what that costs).
+template <typename T>
+struct VehicleParamsT {
+    T m;  // Mass
+    T h;  // CoG height
+    T L;  // Wheelbase
+    T lf; // Front to CoG Length
+    T lr; // Rear to CoG Length
 };
 
-struct AxleData {
-    std::vector<double> theta;           // Slope Angles (rad)
-    std::vector<double> accel;           // Accelerations(m/s^2)
-    std::vector<std::vector<double>> WF; // Front Axle Load
-    std::vector<std::vector<double>> WR; // Rear Axle Load
+template <typename T>
+struct AxleDataT {
+    std::vector<T> theta;                // Slope Angles (rad)
+    std::vector<T> accel;                // Accelerations(m/s^2)
+    AxleGridT<T> WF;                     // Front Axle Load [theta][accel]
+    AxleGridT<T> WR;                     // Rear Axle Load  [theta][accel]
+    std::uint64_t generation = 0;        // Unique per (re)fill; 0 = never filled
 };
 
+using VehicleParams  = VehicleParamsT<double>;
+using VehicleParamsF = VehicleParamsT<float>;
+using AxleData       = AxleDataT<double>;
+using AxleDataF      = AxleDataT<float>;
+
+// Same vehicle at another precision
+template <typename To, typename From>
+VehicleParamsT<To> ConvertVehicleParams(const VehicleParamsT<From>& vp) {
+    return VehicleParamsT<To>{(To)vp.m, (To)vp.h, (To)vp.L, (To)vp.lf, (To)vp.lr};
+}
+
+// Next unique AxleData generation id (thread-safe, never 0)
+std::uint64_t NextAxleGeneration();
+
+// The functions below are instantiated for float and double in axleLoads.cpp.
+// Range bounds stay double for both: the axes are spaced in double and stored as T.
+
 // Nonlinear load Model
-AxleData CalculateAxleLoads (const VehicleParams&, double, double, int, double, double, int);
+template <typename T>
+AxleDataT<T> CalculateAxleLoads (const VehicleParamsT<T>&, double, double, int, double, double, int);
+
+// Nonlinear load Model - fills a caller-owned AxleData in place.
+// Buffers are reused when the grid shape does not grow, so repeated calls do not allocate.
+template <typename T>
+void CalculateAxleLoads (AxleDataT<T>&, const VehicleParamsT<T>&, double, double, int, double, double, int);
+
+// Shape a grid and fill its theta/accel axes without computing any loads
+template <typename T>
+void PrepareAxleGrid (AxleDataT<T>&, double, double, int, double, double, int);
+
+// Compute rows [i0, i1) of a grid already shaped by PrepareAxleGrid
+template <typename T>
+void CalculateAxleLoadRows (AxleDataT<T>&, const VehicleParamsT<T>&, int, int);
+
+// Nonlinear load Model - parallel in-place fill.
+// The grid is cut into cache-sized tiles that the pool work-steals; the output is
+// bit-identical to the serial CalculateAxleLoads.
+class ThreadPool;
+template <typename T>
+void CalculateAxleLoadsParallel (AxleDataT<T>&, const VehicleParamsT<T>&, double, double, int, double, double, int, ThreadPool&);
 
 // Nominal Axle Loads at the operating point
-std::pair<double, double> CalculateNominalAxleLoads(const VehicleParams&, double, double);
+template <typename T>
+std::pair<T, T> CalculateNominalAxleLoads(const VehicleParamsT<T>&, T, T);
+
+// Axle loads for n independent (theta, accel) samples - vectorized, no libm trig calls
+template <typename T>
+void CalculateAxleLoadsBatch(const VehicleParamsT<T>&, const T* theta, const T* accel,
+                             std::size_t n, T* WF, T* WR);
 
 #endif // AXLE_LOAD_H
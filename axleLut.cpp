@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include "axleLut.hpp"
+#include "axleKernel.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define AXLE_LUT_X86 1
+#endif
+
+/********************
+Program    - Axle Load Model - Feed-forward Lookup Table
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Table build from the grid model, bilinear query kernels, AXLT file I/O
+********************/
+
+static const char kLutMagic[4] = {'A', 'X', 'L', 'T'};
+static const int kMaxLutNodes = 1 << 20;
+
+// Bound of |d2W/dtheta2| for both axles: amplitude of p*cos(theta) -/+ q*sin(theta)
+static double ThetaCurvatureBound(const VehicleParams& vp) {
+    const AxlePointCoeffs pc = AxlePointCoefficients(vp);
+    return std::max(std::hypot(pc.pF, pc.q), std::hypot(pc.pR, pc.q));
+}
+
+bool AxleLoadLut::Build(const VehicleParams& vp,
+                        double thetaMin, double thetaMax, int thetaNodes,
+                        double accelMin, double accelMax, int accelNodes) {
+    wf_.clear();
+    wr_.clear();
+    nt_ = na_ = 0;
+    if (thetaNodes < 2 || accelNodes < 2 || thetaNodes > kMaxLutNodes || accelNodes > kMaxLutNodes
+        || (std::int64_t)thetaNodes * accelNodes > kMaxLutNodes * 16LL
+        || !(thetaMax > thetaMin) || !(accelMax > accelMin))
+        return false;
+
+    // Node values straight from the grid model
+    AxleData grid;
+    CalculateAxleLoads(grid, vp, thetaMin, thetaMax, thetaNodes, accelMin, accelMax, accelNodes);
+    wf_.resize((std::size_t)thetaNodes * accelNodes);
+    wr_.resize(wf_.size());
+    double maxAbs = 0.0;
+    for (int i = 0; i < thetaNodes; ++i) {
+        std::copy(grid.WF.Row(i), grid.WF.Row(i) + accelNodes, wf_.begin() + (std::size_t)i * accelNodes);
+        std::copy(grid.WR.Row(i), grid.WR.Row(i) + accelNodes, wr_.begin() + (std::size_t)i * accelNodes);
+        for (int j = 0; j < accelNodes; ++j)
+            maxAbs = std::max(maxAbs, std::max(std::fabs(grid.WF(i, j)), std::fabs(grid.WR(i, j))));
+    }
+
+    vp_ = vp;
+    thMin_ = thetaMin; thMax_ = thetaMax;
+    aMin_ = accelMin;  aMax_ = accelMax;
+    nt_ = thetaNodes;  na_ = accelNodes;
+    invDt_ = (nt_ - 1) / (thMax_ - thMin_);
+    invDa_ = (na_ - 1) / (aMax_ - aMin_);
+
+    // Interpolation term (theta only, see header) + a rounding allowance for the
+    // node values and the three lerps
+    const double dTheta = (thMax_ - thMin_) / (nt_ - 1);
+    errorBound_ = dTheta * dTheta / 8.0 * ThetaCurvatureBound(vp) + 16.0 * DBL_EPSILON * maxAbs;
+    return true;
+}
+
+bool AxleLoadLut::BuildForError(const VehicleParams& vp,
+                                double thetaMin, double thetaMax,
+                                double accelMin, double accelMax,
+                                double maxErrorN, int accelNodes) {
+    const double M = ThetaCurvatureBound(vp);
+    if (!(maxErrorN > 0.0) || !(thetaMax > thetaMin) || !(M > 0.0)) return false;
+    // dTheta^2 / 8 * M <= maxErrorN, leaving a little room for rounding
+    const double dTheta = std::sqrt(8.0 * 0.999 * maxErrorN / M);
+    const double nodes = std::ceil((thetaMax - thetaMin) / dTheta) + 1.0;
+    if (nodes > kMaxLutNodes) {
+        std::cerr << "Lookup table error target " << maxErrorN << " N needs more than "
+                  << kMaxLutNodes << " theta nodes" << std::endl;
+        return false;
+    }
+    if (!Build(vp, thetaMin, thetaMax, std::max(2, (int)nodes), accelMin, accelMax, accelNodes))
+        return false;
+    return errorBound_ <= maxErrorN;
+}
+
+// Query kernel
+struct LutView {
+    const double* wf;
+    const double* wr;
+    double thMin, aMin, invDt, invDa;
+    double uMax, vMax;  // nt - 1, na - 1
+    int nt, na;
+};
+
+// Clamp to the table, split into cell index + fraction, lerp accel then theta.
+// Straight-line body so the loop vectorizes with gathers for the four corners.
+__attribute__((always_inline))
+static inline void LutBody(const LutView& L, const double* __restrict theta, const double* __restrict accel,
+                           std::size_t n, double* __restrict WF, double* __restrict WR) {
+    for (std::size_t k = 0; k < n; ++k) {
+        // Argument order maps NaN inputs to node 0, so every index stays in the table
+        const double u = std::min(L.uMax, std::max(0.0, (theta[k] - L.thMin) * L.invDt));
+        const double v = std::min(L.vMax, std::max(0.0, (accel[k] - L.aMin) * L.invDa));
+        const int i = std::min((int)u, L.nt - 2);
+        const int j = std::min((int)v, L.na - 2);
+        const double fu = u - i;
+        const double fv = v - j;
+        const int c0 = i * L.na + j;
+        const int c1 = c0 + L.na;
+
+        const double f0 = L.wf[c0] + fv * (L.wf[c0 + 1] - L.wf[c0]);
+        const double f1 = L.wf[c1] + fv * (L.wf[c1 + 1] - L.wf[c1]);
+        WF[k] = f0 + fu * (f1 - f0);
+        const double r0 = L.wr[c0] + fv * (L.wr[c0 + 1] - L.wr[c0]);
+        const double r1 = L.wr[c1] + fv * (L.wr[c1 + 1] - L.wr[c1]);
+        WR[k] = r0 + fu * (r1 - r0);
+    }
+}
+
+static void LutKernelScalar(const LutView& L, const double* theta, const double* accel,
+                            std::size_t n, double* WF, double* WR) {
+    LutBody(L, theta, accel, n, WF, WR);
+}
+
+#if defined(AXLE_LUT_X86)
+__attribute__((target("avx2,fma")))
+static void LutKernelAVX2(const LutView& L, const double* theta, const double* accel,
+                          std::size_t n, double* WF, double* WR) {
+    LutBody(L, theta, accel, n, WF, WR);
+}
+
+__attribute__((target("avx512f")))
+static void LutKernelAVX512(const LutView& L, const double* theta, const double* accel,
+                            std::size_t n, double* WF, double* WR) {
+    LutBody(L, theta, accel, n, WF, WR);
+}
+#endif
+
+void AxleLoadLut::Query(const double* theta, const double* accel, std::size_t n, double* WF, double* WR) const {
+    if (Empty()) {
+        std::fill(WF, WF + n, 0.0);
+        std::fill(WR, WR + n, 0.0);
+        return;
+    }
+    const LutView L{wf_.data(), wr_.data(), thMin_, aMin_, invDt_, invDa_,
+                    (double)(nt_ - 1), (double)(na_ - 1), nt_, na_};
+    switch (ActiveAxleKernel()) {
+#if defined(AXLE_LUT_X86)
+        case AxleKernelIsa::AVX512: LutKernelAVX512(L, theta, accel, n, WF, WR); return;
+        case AxleKernelIsa::AVX2:   LutKernelAVX2(L, theta, accel, n, WF, WR);   return;
+#endif
+        default:                    LutKernelScalar(L, theta, accel, n, WF, WR); return;
+    }
+}
+
+std::pair<double, double> AxleLoadLut::Query(double theta, double accel) const {
+    double WF = 0.0, WR = 0.0;
+    if (Empty()) return {WF, WR};
+    const LutView L{wf_.data(), wr_.data(), thMin_, aMin_, invDt_, invDa_,
+                    (double)(nt_ - 1), (double)(na_ - 1), nt_, na_};
+    LutBody(L, &theta, &accel, 1, &WF, &WR);
+    return {WF, WR};
+}
+
+bool AxleLoadLut::Save(const std::string& path) const {
+    if (Empty()) {
+        std::cerr << "Lookup table is empty, nothing to save" << std::endl;
+        return false;
+    }
+    AxleLutHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, kLutMagic, 4);
+    h.version = kAxleLutVersion;
+    h.thetaNodes = nt_;
+    h.accelNodes = na_;
+    h.thetaMin = thMin_; h.thetaMax = thMax_;
+    h.accelMin = aMin_;  h.accelMax = aMax_;
+    h.errorBound = errorBound_;
+    h.vp = vp_;
+
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        std::cerr << "Cannot open " << path << " for writing" << std::endl;
+        return false;
+    }
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1
+           && std::fwrite(wf_.data(), sizeof(double), wf_.size(), f) == wf_.size()
+           && std::fwrite(wr_.data(), sizeof(double), wr_.size(), f) == wr_.size();
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok) std::cerr << "Write error on " << path << std::endl;
+    return ok;
+}
+
+bool AxleLoadLut::Load(const std::string& path) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        std::cerr << "Cannot open " << path << std::endl;
+        return false;
+    }
+    AxleLutHeader h;
+    bool ok = std::fread(&h, sizeof(h), 1, f) == 1;
+    if (!ok || std::memcmp(h.magic, kLutMagic, 4) != 0 || h.version != kAxleLutVersion) {
+        std::cerr << path << " is not a version " << kAxleLutVersion << " axle load table" << std::endl;
+        std::fclose(f);
+        return false;
+    }
+    if (h.thetaNodes < 2 || h.accelNodes < 2 || h.thetaNodes > kMaxLutNodes || h.accelNodes > kMaxLutNodes
+        || (std::int64_t)h.thetaNodes * h.accelNodes > kMaxLutNodes * 16LL
+        || !(h.thetaMax > h.thetaMin) || !(h.accelMax > h.accelMin)) {
+        std::cerr << path << ": corrupt table header" << std::endl;
+        std::fclose(f);
+        return false;
+    }
+
+    std::vector<double> wf((std::size_t)h.thetaNodes * h.accelNodes), wr(wf.size());
+    ok = std::fread(wf.data(), sizeof(double), wf.size(), f) == wf.size()
+      && std::fread(wr.data(), sizeof(double), wr.size(), f) == wr.size();
+    std::fclose(f);
+    if (!ok) {
+        std::cerr << path << ": truncated table" << std::endl;
+        return false;
+    }
+
+    vp_ = h.vp;
+    thMin_ = h.thetaMin; thMax_ = h.thetaMax;
+    aMin_ = h.accelMin;  aMax_ = h.accelMax;
+    nt_ = h.thetaNodes;  na_ = h.accelNodes;
+    invDt_ = (nt_ - 1) / (thMax_ - thMin_);
+    invDa_ = (na_ - 1) / (aMax_ - aMin_);
+    errorBound_ = h.errorBound;
+    wf_.swap(wf);
+    wr_.swap(wr);
+    return true;
+}
@@ -0,0 +1,94 @@
+/********************
+Program    - Axle Load Model - Feed-forward Lookup Table
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - 2D (theta x accel) load table, batched bilinear queries, error bound, file I/O
+        - Version 1   - Cost comment matches the bench: the table only wins for single queries
+        - Version 2   - File version 2: tables built with the old load transfer are refused
+********************/
+
+#ifndef AXLE_LUT_H
+#define AXLE_LUT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "axleLoads.hpp"
+
+// Table file (little-endian):
+//   AxleLutHeader, then thetaNodes*accelNodes f64 WF values, then the same for WR
+//   (row-major, theta rows, accel columns)
+struct AxleLutHeader {
+    char          magic[4];      // 'AXLT'
+    std::uint32_t version;
+    std::int32_t  thetaNodes;
+    std::int32_t  accelNodes;
+    double        thetaMin, thetaMax;
+    double        accelMin, accelMax;
+    double        errorBound;    // N, see AxleLoadLut::ErrorBound()
+    VehicleParams vp;            // vehicle the table was built for
+};
+
+const std::uint32_t kAxleLutVersion = 2;   // 2: corrected load transfer (kAxleModelVersion 2)
+
+// Uniform theta x accel table of front/rear axle loads for feed-forward queries.
+// Queries are bilinear, branch-free and trig-free. That only pays off for single queries:
+// Query(theta, accel) costs ~17 ns against 21-32 ns for CalculateNominalAxleLoads. Batches
+// are bound by the table gathers (~6.5 ns per point, points/lut in WheelLoadBench) and lose
+// to CalculateAxleLoadsBatch (~3.5 ns, vectorized sin/cos), so use the batched path for those.
+//
+// Error bound: for a tensor-product bilinear interpolant
+//   |W - W_lut| <= dTheta^2/8 * max|d2W/dtheta2| + dAccel^2/8 * max|d2W/daccel2|
+// The model is linear in accel (second term is 0) and d2W/dtheta2 is a sinusoid of
+// amplitude sqrt(p^2 + q^2) (p = static axle share of m*g, q = m*g*h/L), so the bound
+// depends only on the theta spacing. Two accel nodes are therefore exact in accel.
+class AxleLoadLut {
+public:
+    // Build over [thetaMin, thetaMax] x [accelMin, accelMax] with the given node counts (>= 2 each).
+    // Returns false (and leaves the table empty) for degenerate ranges or counts.
+    bool Build(const VehicleParams& vp,
+               double thetaMin, double thetaMax, int thetaNodes,
+               double accelMin, double accelMax, int accelNodes = 2);
+
+    // Build with the fewest theta nodes whose error bound is <= maxErrorN (Newtons)
+    bool BuildForError(const VehicleParams& vp,
+                       double thetaMin, double thetaMax,
+                       double accelMin, double accelMax,
+                       double maxErrorN, int accelNodes = 2);
+
+    bool Empty() const { return wf_.empty(); }
+    int  ThetaNodes() const { return nt_; }
+    int  AccelNodes() const { return na_; }
+    double ThetaMin() const { return thMin_; }
+    double ThetaMax() const { return thMax_; }
+    double AccelMin() const { return aMin_; }
+    double AccelMax() const { return aMax_; }
+    const VehicleParams& Vehicle() const { return vp_; }
+    std::size_t Bytes() const { return (wf_.size() + wr_.size()) * sizeof(double); }
+
+    // Max |error| in N for queries inside the table range (interpolation + rounding).
+    // Queries outside the range are clamped to the nearest edge and carry no bound.
+    double ErrorBound() const { return errorBound_; }
+
+    // Bilinear queries - n independent (theta, accel) points, active SIMD kernel
+    void Query(const double* theta, const double* accel, std::size_t n, double* WF, double* WR) const;
+    std::pair<double, double> Query(double theta, double accel) const;
+
+    // Serialize / load. Errors are printed to std::cerr.
+    bool Save(const std::string& path) const;
+    bool Load(const std::string& path);
+
+private:
+    VehicleParams vp_{};
+    double thMin_ = 0.0, thMax_ = 0.0, aMin_ = 0.0, aMax_ = 0.0;
+    double invDt_ = 0.0, invDa_ = 0.0;
+    int nt_ = 0, na_ = 0;
+    double errorBound_ = 0.0;
+    std::vector<double> wf_, wr_;
+};
+
+#endif // AXLE_LUT_H
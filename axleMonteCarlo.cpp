@@ -0,0 +1,285 @@
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include "axleMonteCarlo.hpp"
+#include "axleKernel.hpp"
+#include "threadPool.hpp"
+#include "profiler.hpp"
+
+/********************
+Program    - Axle Load Model - Monte Carlo Envelopes
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Batched sampling, per-worker histogram sketches, merge + percentile readout
+        - Version 1   - Bins fitted to a scratch budget; deterministic mean from per-batch coefficient sums
+********************/
+
+static const int kBatchSamples = 1024;  // samples per task; one RNG stream per batch
+
+// splitmix64 - seeds each batch's stream and generates its samples
+static std::uint64_t SplitMix64(std::uint64_t& s) {
+    std::uint64_t z = (s += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static double Uniform01(std::uint64_t& s) {
+    return (double)(SplitMix64(s) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static double Sample(const ParamSpread& p, std::uint64_t& s) {
+    switch (p.kind) {
+        case ParamSpreadKind::Uniform:
+            return p.a + (p.b - p.a) * Uniform01(s);
+        case ParamSpreadKind::Normal: {
+            // Box-Muller (one of the pair is enough here)
+            const double u1 = 1.0 - Uniform01(s);
+            const double u2 = Uniform01(s);
+            return p.a + p.b * std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+        }
+        default:
+            return p.a;
+    }
+}
+
+// [lo, hi] covering (almost) every sample of p
+static void SpreadRange(const ParamSpread& p, double& lo, double& hi) {
+    switch (p.kind) {
+        case ParamSpreadKind::Uniform: lo = std::min(p.a, p.b); hi = std::max(p.a, p.b); break;
+        case ParamSpreadKind::Normal:  lo = p.a - 4.0 * std::fabs(p.b); hi = p.a + 4.0 * std::fabs(p.b); break;
+        default:                       lo = hi = p.a; break;
+    }
+}
+
+// Keep sampled vehicles physical
+static VehicleParams MakeVehicle(const VehicleDistribution& d, double m, double h, double lf) {
+    VehicleParams vp;
+    vp.L  = d.L;
+    vp.m  = std::max(m, 1e-6);
+    vp.h  = std::max(h, 0.0);
+    vp.lf = std::min(std::max(lf, 0.0), d.L);
+    vp.lr = d.L - vp.lf;
+    return vp;
+}
+
+// Per-worker streaming state. Cells [0, n) are WF, [n, 2n) are WR.
+// min/max and integer counts merge exactly in any order; the mean is not kept per cell
+// (see CoeffSums).
+struct EnvelopeAccumulator {
+    std::vector<double> mn, mx;
+    std::vector<std::uint32_t> hist;  // [cell][bin]
+
+    static std::uint64_t BytesPerCell(int bins) { return 2 * sizeof(double) + (std::uint64_t)bins * sizeof(std::uint32_t); }
+
+    void Reset(int cells2, int bins) {
+        mn.assign(cells2, HUGE_VAL);
+        mx.assign(cells2, -HUGE_VAL);
+        hist.assign((std::size_t)cells2 * bins, 0u);
+    }
+
+    void Merge(const EnvelopeAccumulator& o) {
+        for (std::size_t c = 0; c < mn.size(); ++c) {
+            mn[c] = std::min(mn[c], o.mn[c]);
+            mx[c] = std::max(mx[c], o.mx[c]);
+        }
+        for (std::size_t k = 0; k < hist.size(); ++k) hist[k] += o.hist[k];
+    }
+};
+
+// Shared read-only setup for the sampling tasks
+struct EnvelopeSetup {
+    const VehicleDistribution* dist;
+    std::vector<double> cosT, sinT, accel;
+    std::vector<double> lo, inv;  // histogram origin and bins per Newton, per cell
+    int rows, cols, bins;
+};
+
+// One (row-affine) axle load grid for vp, folded into acc
+static void AccumulateSample(const EnvelopeSetup& S, const VehicleParams& vp, EnvelopeAccumulator& acc) {
+    const AxlePointCoeffs pc = AxlePointCoefficients(vp);
+    const int n = S.rows * S.cols;
+    const double binMax = S.bins - 1;
+    for (int i = 0; i < S.rows; ++i) {
+        const double cF = pc.pF * S.cosT[i] - pc.q * S.sinT[i];
+        const double cR = pc.pR * S.cosT[i] + pc.q * S.sinT[i];
+        for (int axle = 0; axle < 2; ++axle) {
+            const double c0 = axle == 0 ? cF : cR;
+            const double k  = axle == 0 ? -pc.k : pc.k;
+            const int base = axle * n + i * S.cols;
+            double* mn = acc.mn.data() + base;
+            double* mx = acc.mx.data() + base;
+            const double* lo = S.lo.data() + base;
+            const double* inv = S.inv.data() + base;
+            std::uint32_t* hist = acc.hist.data() + (std::size_t)base * S.bins;
+            for (int j = 0; j < S.cols; ++j) {
+                const double w = c0 + k * S.accel[j];
+                mn[j] = std::min(mn[j], w);
+                mx[j] = std::max(mx[j], w);
+                const int b = (int)std::min(binMax, std::max(0.0, (w - lo[j]) * inv[j]));
+                ++hist[(std::size_t)j * S.bins + b];
+            }
+        }
+    }
+}
+
+// Value below which a fraction p of the cell's samples fall (linear within a bin)
+static double HistogramPercentile(const std::uint32_t* hist, int bins, double lo, double inv,
+                                  std::uint64_t total, double p, double mn, double mx) {
+    if (inv <= 0.0 || total == 0) return std::min(std::max(lo, mn), mx);
+    const double target = p * (double)total;
+    double cum = 0.0;
+    for (int b = 0; b < bins; ++b) {
+        const double c = hist[b];
+        if (c > 0.0 && cum + c >= target) {
+            const double v = lo + (b + (target - cum) / c) / inv;
+            return std::min(std::max(v, mn), mx);
+        }
+        cum += c;
+    }
+    return mx;
+}
+
+bool CalculateAxleLoadEnvelope(AxleEnvelopeData& out, const VehicleDistribution& dist,
+                               double thetaMin, double thetaMax, int thetaSteps,
+                               double accelMin, double accelMax, int accelSteps,
+                               const MonteCarloOptions& opts) {
+    PROFILE_SCOPE("CalculateAxleLoadEnvelope");
+    // Axes exactly as the dense grid lays them out
+    AxleData axes;
+    PrepareAxleGrid(axes, thetaMin, thetaMax, thetaSteps, accelMin, accelMax, accelSteps);
+    const int rows = (int)axes.theta.size(), cols = (int)axes.accel.size();
+    const int n = rows * cols;
+    const std::uint64_t samples = std::min<std::uint64_t>(opts.samples, UINT32_MAX);
+
+    out.theta = axes.theta;
+    out.accel = axes.accel;
+    out.samples = 0;
+    out.pLow = opts.pLow;
+    out.pHigh = opts.pHigh;
+    for (AxleLoadBands* b : {&out.WF, &out.WR}) {
+        b->min.Resize(rows, cols); b->max.Resize(rows, cols); b->mean.Resize(rows, cols);
+        b->pLow.Resize(rows, cols); b->pHigh.Resize(rows, cols);
+    }
+    if (n == 0 || samples == 0) {
+        out.generation = NextAxleGeneration();
+        return true;
+    }
+
+    // Fit the bins to the scratch budget: every worker holds min/max + histogram for 2n cells
+    ThreadPool& pool = opts.pool ? *opts.pool : DefaultThreadPool();
+    const std::uint64_t cellsAll = 2ull * (std::uint64_t)n * (std::uint64_t)pool.Size();
+    int bins = std::max(2, opts.histogramBins);
+    while (bins > kMinEnvelopeBins && cellsAll * EnvelopeAccumulator::BytesPerCell(bins) > opts.maxScratchBytes)
+        bins = std::max(kMinEnvelopeBins, bins / 2);
+    if (cellsAll * EnvelopeAccumulator::BytesPerCell(bins) > opts.maxScratchBytes) {
+        std::cerr << "Monte Carlo envelope: " << rows << " x " << cols << " cells on " << pool.Size()
+                  << " workers need " << (cellsAll * EnvelopeAccumulator::BytesPerCell(bins) >> 20)
+                  << " MB of scratch (budget " << (opts.maxScratchBytes >> 20) << " MB), skipping" << std::endl;
+        return false;
+    }
+
+    EnvelopeSetup S;
+    S.dist = &dist;
+    S.rows = rows; S.cols = cols; S.bins = bins;
+    S.accel = axes.accel;
+    S.cosT.resize(rows); S.sinT.resize(rows);
+    for (int i = 0; i < rows; ++i) { S.cosT[i] = std::cos(axes.theta[i]); S.sinT[i] = std::sin(axes.theta[i]); }
+
+    // Histogram ranges: the model is multilinear in (m, h, lf), so the 8 corners of the
+    // parameter box bound every cell
+    {
+        double r[3][2];
+        SpreadRange(dist.m, r[0][0], r[0][1]);
+        SpreadRange(dist.h, r[1][0], r[1][1]);
+        SpreadRange(dist.lf, r[2][0], r[2][1]);
+        EnvelopeAccumulator corners;
+        corners.Reset(2 * n, 1);
+        EnvelopeSetup C = S;
+        C.bins = 1;
+        C.lo.assign(2 * n, 0.0);
+        C.inv.assign(2 * n, 0.0);
+        for (int k = 0; k < 8; ++k)
+            AccumulateSample(C, MakeVehicle(dist, r[0][k & 1], r[1][(k >> 1) & 1], r[2][(k >> 2) & 1]), corners);
+        S.lo.resize(2 * n);
+        S.inv.resize(2 * n);
+        for (int c = 0; c < 2 * n; ++c) {
+            const double width = corners.mx[c] - corners.mn[c];
+            S.lo[c] = corners.mn[c];
+            S.inv[c] = width > 0.0 ? bins / width : 0.0;
+        }
+    }
+
+    // Parallel sampling in waves of batches, so progress/cancellation is checked regularly
+    std::vector<EnvelopeAccumulator> acc(pool.Size());
+    for (EnvelopeAccumulator& a : acc) a.Reset(2 * n, bins);
+
+    // The model is linear in its coefficients (pF, pR, q, k), so the per-cell mean is the model
+    // at the mean coefficients. Each batch sums its own in sample order and the batch sums are
+    // added in batch order, which no thread count or steal pattern can change.
+    typedef std::array<double, 4> CoeffSums;
+    CoeffSums total{};
+    std::vector<CoeffSums> batchSums;
+
+    const std::uint64_t batches = (samples + kBatchSamples - 1) / kBatchSamples;
+    const std::uint64_t wave = (std::uint64_t)pool.Size() * 8;
+    for (std::uint64_t b0 = 0; b0 < batches; b0 += wave) {
+        if (opts.progress && !opts.progress((float)((double)b0 / (double)batches))) return false;
+        const int count = (int)std::min(wave, batches - b0);
+        batchSums.assign(count, CoeffSums{});
+        pool.ParallelFor(count, [&](int t, int worker) {
+            const std::uint64_t batch = b0 + (std::uint64_t)t;
+            std::uint64_t state = opts.seed ^ (batch * 0xD1B54A32D192ED03ull);
+            SplitMix64(state);
+            const std::uint64_t first = batch * kBatchSamples;
+            const std::uint64_t last = std::min(samples, first + kBatchSamples);
+            for (std::uint64_t s = first; s < last; ++s) {
+                const double m = Sample(dist.m, state);
+                const double h = Sample(dist.h, state);
+                const double lf = Sample(dist.lf, state);
+                const VehicleParams vp = MakeVehicle(dist, m, h, lf);
+                const AxlePointCoeffs pc = AxlePointCoefficients(vp);
+                CoeffSums& bs = batchSums[t];
+                bs[0] += pc.pF; bs[1] += pc.pR; bs[2] += pc.q; bs[3] += pc.k;
+                AccumulateSample(S, vp, acc[worker]);
+            }
+        });
+        for (const CoeffSums& bs : batchSums)
+            for (int c = 0; c < 4; ++c) total[c] += bs[c];
+    }
+    if (opts.progress && !opts.progress(1.0f)) return false;
+
+    for (std::size_t w = 1; w < acc.size(); ++w) acc[0].Merge(acc[w]);
+    const EnvelopeAccumulator& A = acc[0];
+
+    const double invSamples = 1.0 / (double)samples;
+    AxlePointCoeffs mean;
+    mean.pF = total[0] * invSamples; mean.pR = total[1] * invSamples;
+    mean.q = total[2] * invSamples;  mean.k = total[3] * invSamples;
+    for (int axle = 0; axle < 2; ++axle) {
+        AxleLoadBands& B = axle == 0 ? out.WF : out.WR;
+        for (int i = 0; i < rows; ++i) {
+            // Same row-affine form as AccumulateSample, at the mean coefficients
+            const double c0 = axle == 0 ? mean.pF * S.cosT[i] - mean.q * S.sinT[i]
+                                        : mean.pR * S.cosT[i] + mean.q * S.sinT[i];
+            const double k = axle == 0 ? -mean.k : mean.k;
+            for (int j = 0; j < cols; ++j) {
+                const int c = axle * n + i * cols + j;
+                const std::uint32_t* hist = A.hist.data() + (std::size_t)c * bins;
+                B.min(i, j) = A.mn[c];
+                B.max(i, j) = A.mx[c];
+                B.mean(i, j) = c0 + k * S.accel[j];
+                B.pLow(i, j)  = HistogramPercentile(hist, bins, S.lo[c], S.inv[c], samples, opts.pLow, A.mn[c], A.mx[c]);
+                B.pHigh(i, j) = HistogramPercentile(hist, bins, S.lo[c], S.inv[c], samples, opts.pHigh, A.mn[c], A.mx[c]);
+            }
+        }
+    }
+    out.samples = samples;
+    out.generation = NextAxleGeneration();
+    return true;
+}
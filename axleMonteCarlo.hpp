@@ -0,0 +1,94 @@
+/********************
+Program    - Axle Load Model - Monte Carlo Envelopes
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Parameter distributions, parallel sampling, streaming per-cell min/max/mean/percentiles
+        - Version 1   - Scratch memory budget, mean from per-batch sums in batch order
+********************/
+
+#ifndef AXLE_MONTE_CARLO_H
+#define AXLE_MONTE_CARLO_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "axleGrid.hpp"
+#include "axleLoads.hpp"
+
+// One uncertain parameter
+enum class ParamSpreadKind { Fixed, Uniform, Normal };
+
+struct ParamSpread {
+    ParamSpreadKind kind = ParamSpreadKind::Fixed;
+    double a = 0.0;  // Fixed: value   Uniform: min   Normal: mean
+    double b = 0.0;  //                Uniform: max   Normal: standard deviation
+
+    static ParamSpread Fixed(double v)               { return {ParamSpreadKind::Fixed, v, 0.0}; }
+    static ParamSpread Uniform(double lo, double hi) { return {ParamSpreadKind::Uniform, lo, hi}; }
+    static ParamSpread Normal(double mean, double sd) { return {ParamSpreadKind::Normal, mean, sd}; }
+};
+
+// Payload-dependent vehicle: mass, CoG height and CoG position vary, the wheelbase does not.
+// lr follows as L - lf. Normal samples are clamped to physical ranges (m, h > 0, 0 < lf < L).
+struct VehicleDistribution {
+    ParamSpread m;   // Mass (kg)
+    ParamSpread h;   // CoG height (m)
+    ParamSpread lf;  // Front axle to CoG (m)
+    double L = 0.0;  // Wheelbase (m)
+
+    static VehicleDistribution FromVehicle(const VehicleParams& vp) {
+        return {ParamSpread::Fixed(vp.m), ParamSpread::Fixed(vp.h), ParamSpread::Fixed(vp.lf), vp.L};
+    }
+};
+
+// Per-cell statistics of one axle load over all samples
+struct AxleLoadBands {
+    AxleGrid min, max, mean;
+    AxleGrid pLow, pHigh;           // percentiles (default P5 / P95)
+};
+
+struct AxleEnvelopeData {
+    std::vector<double> theta;      // Slope Angles (rad)
+    std::vector<double> accel;      // Accelerations(m/s^2)
+    AxleLoadBands WF, WR;           // [theta][accel]
+    std::uint64_t samples = 0;
+    double pLow = 0.05, pHigh = 0.95;
+    std::uint64_t generation = 0;   // unique per completed run; 0 = never filled
+};
+
+class ThreadPool;
+
+struct MonteCarloOptions {
+    std::uint64_t samples = 100000;
+    std::uint64_t seed = 1;
+    double pLow = 0.05, pHigh = 0.95;
+    int histogramBins = 256;        // per cell and axle; percentile resolution = cell range / bins
+    // Per-worker scratch (min/max + histogram per cell and axle) summed over all workers.
+    // histogramBins is lowered to fit; below kMinEnvelopeBins the run is refused.
+    std::uint64_t maxScratchBytes = 512ull << 20;
+    ThreadPool* pool = nullptr;     // nullptr -> DefaultThreadPool()
+    // Called between batches with the fraction done; return false to cancel
+    std::function<bool(float)> progress;
+};
+
+const int kMinEnvelopeBins = 8;
+
+// Sample VehicleParams from dist and reduce every sampled axle load grid into per-cell
+// min / max / mean and percentiles, without storing the samples.
+// Percentiles come from a fixed-range histogram per cell: the range is the image of the
+// parameter box (uniform bounds, or mean +- 4 sd for normals) - the model is multilinear in
+// (m, h, lf), so its corners bound every cell. Histograms from the pool workers are merged
+// at the end. Sample streams are seeded per batch, and the mean is formed from per-batch sums
+// of the (linear) model coefficients added in batch order, so min / max / mean do not depend on
+// thread count or scheduling; neither do the percentiles unless the bins had to be lowered to
+// fit the budget, which depends on the worker count. Returns false if cancelled, or if the
+// grid needs more scratch than opts.maxScratchBytes (reported on std::cerr); out.generation
+// is then left unchanged.
+bool CalculateAxleLoadEnvelope(AxleEnvelopeData& out, const VehicleDistribution& dist,
+                               double thetaMin, double thetaMax, int thetaSteps,
+                               double accelMin, double accelMax, int accelSteps,
+                               const MonteCarloOptions& opts);
+
+#endif // AXLE_MONTE_CARLO_H
@@ -0,0 +1,260 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include "axlePitch.hpp"
+#include "axleKernel.hpp"
+#include "threadPool.hpp"
+#include "profiler.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define AXLE_PITCH_X86 1
+#endif
+
+/********************
+Program    - Axle Load Model - Pitch Dynamics
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - SoA lane setup, RK4 step kernels (scalar/AVX2/AVX-512), parallel scenario blocks
+        - Version 1   - Lane data size comment corrected
+********************/
+
+static const int kPitchBlock = 256;       // scenarios per task: 48 KB of lane data (24 fields) stays in L1/L2
+static const double kRk4Limit = 2.0;      // max dt * fastest rate (RK4 is stable to ~2.8)
+
+PitchVehicleParams PitchVehicleParams::FromVehicle(const VehicleParams& vp, double frontHz,
+                                                   double rearHz, double zeta) {
+    PitchVehicleParams p;
+    static_cast<VehicleParams&>(p) = vp;
+    const double twoPi = 6.283185307179586;
+    const double mf = vp.m * vp.lr / vp.L, mr = vp.m * vp.lf / vp.L;   // sprung mass per axle
+    p.kf = mf * (twoPi * frontHz) * (twoPi * frontHz);
+    p.kr = mr * (twoPi * rearHz) * (twoPi * rearHz);
+    p.cf = 2.0 * zeta * std::sqrt(p.kf * mf);
+    p.cr = 2.0 * zeta * std::sqrt(p.kr * mr);
+    p.Iy = vp.m * (0.45 * vp.L) * (0.45 * vp.L);
+    return p;
+}
+
+// Argument order keeps the fraction in [0, 1] for a step too (invRamp = inf, 0 * inf = NaN -> 0)
+static inline double RampFraction(double t, double tStart, double invRamp) {
+    return std::min(1.0, std::max(0.0, (t - tStart) * invRamp));
+}
+
+double BrakeEvent::AccelAt(double t) const {
+    const double invRamp = tRamp > 0.0 ? 1.0 / tRamp : HUGE_VAL;
+    return accel0 + (accel1 - accel0) * RampFraction(t, tStart, invRamp);
+}
+
+// Lane storage: blocks of kPitchBlock scenarios, each block one field-major array
+// (AoSoA). Every field of a block is a contiguous run of kPitchBlock doubles at a fixed
+// offset from the block base, so the step loop sees constant distances between its
+// loads and stores and vectorizes across scenarios.
+enum PitchField {
+    kInvM, kInvIy, kLf, kLr, kKf, kKr, kCf, kCr,
+    kBaseF, kBaseR,                             // static axle shares at theta
+    kMSlope, kMAccel,                           // pitch moment: kMSlope + kMAccel * accel
+    kInvL,                                      // moment -> static load transfer
+    kA0, kDa, kTStart, kInvRamp,                // accel(t) = a0 + da * ramp fraction
+    kZ, kZd, kPhi, kPhid,                       // state
+    kAccS, kAccM, kAccE,                        // scratch: accel at t, t + h/2, t + h
+    kPitchFields
+};
+
+#define LANE(f) L[(f) * kPitchBlock + k]
+
+// Heave and pitch accelerations of lane k
+#define PITCH_DERIV(a, z, zd, phi, phid, zdd, phidd)                                          \
+    do {                                                                                      \
+        const double Ff_ = LANE(kKf) * ((z) + LANE(kLf) * (phi)) + LANE(kCf) * ((zd) + LANE(kLf) * (phid)); \
+        const double Fr_ = LANE(kKr) * ((z) - LANE(kLr) * (phi)) + LANE(kCr) * ((zd) - LANE(kLr) * (phid)); \
+        zdd = -(Ff_ + Fr_) * LANE(kInvM);                                                     \
+        phidd = (-(LANE(kMSlope) + LANE(kMAccel) * (a)) - LANE(kLf) * Ff_ + LANE(kLr) * Fr_) * LANE(kInvIy); \
+    } while (0)
+
+#define PITCH_ACCEL(t) (LANE(kA0) + LANE(kDa) * RampFraction((t), LANE(kTStart), LANE(kInvRamp)))
+
+// Output rows of one block
+struct PitchOut {
+    double *WF, *WR, *WFs, *WRs, *pitch, *accel; // row of the block's first scenario
+    std::size_t stride;                         // elements between rows
+};
+
+// Loads, pitch and input at time t into output column s
+__attribute__((always_inline))
+static inline void PitchStoreBody(const double* __restrict L, const PitchOut& o, int n, double t, int s) {
+    for (int k = 0; k < n; ++k) {
+        const double Ff = LANE(kKf) * (LANE(kZ) + LANE(kLf) * LANE(kPhi)) + LANE(kCf) * (LANE(kZd) + LANE(kLf) * LANE(kPhid));
+        const double Fr = LANE(kKr) * (LANE(kZ) - LANE(kLr) * LANE(kPhi)) + LANE(kCr) * (LANE(kZd) - LANE(kLr) * LANE(kPhid));
+        const double a = PITCH_ACCEL(t);
+        const double dW = (LANE(kMSlope) + LANE(kMAccel) * a) * LANE(kInvL);
+        const std::size_t i = k * o.stride + s;
+        o.WF[i] = LANE(kBaseF) + Ff;
+        o.WR[i] = LANE(kBaseR) + Fr;
+        o.WFs[i] = LANE(kBaseF) - dW;
+        o.WRs[i] = LANE(kBaseR) + dW;
+        o.pitch[i] = LANE(kPhi);
+        o.accel[i] = a;
+    }
+}
+
+// One classic RK4 step of every lane in the block. Straight-line per lane, so the loop
+// vectorizes across scenarios.
+__attribute__((always_inline))
+static inline void PitchStepBody(double* __restrict L, int n, double t, double h) {
+    const double h2 = 0.5 * h, h6 = h / 6.0;
+    // Inputs first: kept out of the main loop, whose clamps would otherwise stop it vectorizing
+    for (int k = 0; k < n; ++k) {
+        LANE(kAccS) = PITCH_ACCEL(t);
+        LANE(kAccM) = PITCH_ACCEL(t + h2);
+        LANE(kAccE) = PITCH_ACCEL(t + h);
+    }
+    for (int k = 0; k < n; ++k) {
+        const double aS = LANE(kAccS), aM = LANE(kAccM), aE = LANE(kAccE);
+        const double z = LANE(kZ), zd = LANE(kZd), p = LANE(kPhi), pd = LANE(kPhid);
+
+        double z1, p1, z2, p2, z3, p3, z4, p4;
+        PITCH_DERIV(aS, z, zd, p, pd, z1, p1);
+        const double zdA = zd + h2 * z1, pdA = pd + h2 * p1;
+        PITCH_DERIV(aM, z + h2 * zd, zdA, p + h2 * pd, pdA, z2, p2);
+        const double zdB = zd + h2 * z2, pdB = pd + h2 * p2;
+        PITCH_DERIV(aM, z + h2 * zdA, zdB, p + h2 * pdA, pdB, z3, p3);
+        const double zdC = zd + h * z3, pdC = pd + h * p3;
+        PITCH_DERIV(aE, z + h * zdB, zdC, p + h * pdB, pdC, z4, p4);
+
+        LANE(kZ)    = z  + h6 * (zd + 2.0 * (zdA + zdB) + zdC);
+        LANE(kPhi)  = p  + h6 * (pd + 2.0 * (pdA + pdB) + pdC);
+        LANE(kZd)   = zd + h6 * (z1 + 2.0 * (z2 + z3) + z4);
+        LANE(kPhid) = pd + h6 * (p1 + 2.0 * (p2 + p3) + p4);
+    }
+}
+
+// Whole run for one block: sample 0 is the settled start, then a sample every outputEvery steps
+__attribute__((always_inline))
+static inline void PitchRunBody(double* L, const PitchOut& o, int n, int steps, double dt, int outputEvery) {
+    PitchStoreBody(L, o, n, 0.0, 0);
+    for (int step = 0; step < steps; ++step) {
+        PitchStepBody(L, n, step * dt, dt);
+        if ((step + 1) % outputEvery == 0)
+            PitchStoreBody(L, o, n, (step + 1) * dt, (step + 1) / outputEvery);
+    }
+}
+
+static void PitchRunScalar(double* L, const PitchOut& o, int n, int steps, double dt, int outputEvery) {
+    PitchRunBody(L, o, n, steps, dt, outputEvery);
+}
+
+#if defined(AXLE_PITCH_X86)
+__attribute__((target("avx2,fma")))
+static void PitchRunAVX2(double* L, const PitchOut& o, int n, int steps, double dt, int outputEvery) {
+    PitchRunBody(L, o, n, steps, dt, outputEvery);
+}
+
+__attribute__((target("avx512f")))
+static void PitchRunAVX512(double* L, const PitchOut& o, int n, int steps, double dt, int outputEvery) {
+    PitchRunBody(L, o, n, steps, dt, outputEvery);
+}
+#endif
+
+static void PitchRun(double* L, const PitchOut& o, int n, int steps, double dt, int outputEvery) {
+    switch (ActiveAxleKernel()) {
+#if defined(AXLE_PITCH_X86)
+        case AxleKernelIsa::AVX512: PitchRunAVX512(L, o, n, steps, dt, outputEvery); return;
+        case AxleKernelIsa::AVX2:   PitchRunAVX2(L, o, n, steps, dt, outputEvery);   return;
+#endif
+        default:                    PitchRunScalar(L, o, n, steps, dt, outputEvery); return;
+    }
+}
+
+#undef PITCH_ACCEL
+#undef PITCH_DERIV
+#undef LANE
+
+bool SimulatePitchDynamics(PitchSimData& out, const std::vector<PitchScenario>& scenarios,
+                           const PitchSimOptions& opts) {
+    PROFILE_SCOPE("SimulatePitchDynamics");
+    out.time.clear();
+    for (AxleGrid* grid : {&out.WF, &out.WR, &out.WFStatic, &out.WRStatic, &out.pitch, &out.accel}) grid->Clear();
+    out.generation = 0;
+    if (!(opts.dt > 0.0) || !(opts.duration >= 0.0) || opts.outputEvery < 1) {
+        std::cerr << "Pitch simulation needs dt > 0, duration >= 0 and outputEvery >= 1" << std::endl;
+        return false;
+    }
+    const double stepsD = std::floor(opts.duration / opts.dt + 1e-9);
+    if (stepsD > 1e9) {
+        std::cerr << "Pitch simulation: too many steps (" << stepsD << ")" << std::endl;
+        return false;
+    }
+    const int steps = (int)stepsD;
+    const int samples = steps / opts.outputEvery + 1;
+    const int n = (int)scenarios.size();
+
+    // Fold every scenario into its lanes and check the step against its fastest mode
+    const int blocks = (n + kPitchBlock - 1) / kPitchBlock;
+    std::vector<double> lanes((std::size_t)blocks * kPitchFields * kPitchBlock, 0.0);
+    for (int k = 0; k < n; ++k) {
+        const PitchVehicleParams& p = scenarios[k].vp;
+        const BrakeEvent& e = scenarios[k].event;
+        const double span = p.lf + p.lr;
+        if (!(p.m > 0.0) || !(p.Iy > 0.0) || !(p.kf > 0.0) || !(p.kr > 0.0) || !(p.L > 0.0)
+            || !(span > 0.0) || p.cf < 0.0 || p.cr < 0.0) {
+            std::cerr << "Pitch scenario " << k << ": needs m, Iy, kf, kr, L > 0 and cf, cr >= 0" << std::endl;
+            return false;
+        }
+        const double kPitch = p.kf * p.lf * p.lf + p.kr * p.lr * p.lr;
+        const double cPitch = p.cf * p.lf * p.lf + p.cr * p.lr * p.lr;
+        const double rate = std::max(std::max(std::sqrt((p.kf + p.kr) / p.m), std::sqrt(kPitch / p.Iy)),
+                                     std::max((p.cf + p.cr) / p.m, cPitch / p.Iy));
+        if (opts.dt * rate > kRk4Limit) {
+            std::cerr << "Pitch scenario " << k << ": dt " << opts.dt << " s is too large for RK4 (max "
+                      << kRk4Limit / rate << " s)" << std::endl;
+            return false;
+        }
+
+        double* lane = lanes.data() + (std::size_t)(k / kPitchBlock) * kPitchFields * kPitchBlock + k % kPitchBlock;
+        auto set = [&](PitchField f, double v) { lane[f * kPitchBlock] = v; };
+        // Static shares and load transfer exactly as the grid model has them; the transfer
+        // times the span is the pitch moment the suspension has to react
+        const AxlePointCoeffs pc = AxlePointCoefficients(static_cast<const VehicleParams&>(p));
+        const double mSlope = pc.q * std::sin(e.theta) * p.L;
+        const double mAccel = pc.k * p.L;
+        set(kInvM, 1.0 / p.m);
+        set(kInvIy, 1.0 / p.Iy);
+        set(kLf, p.lf); set(kLr, p.lr);
+        set(kKf, p.kf); set(kKr, p.kr);
+        set(kCf, p.cf); set(kCr, p.cr);
+        set(kBaseF, pc.pF * std::cos(e.theta));
+        set(kBaseR, pc.pR * std::cos(e.theta));
+        set(kMSlope, mSlope);
+        set(kMAccel, mAccel);
+        set(kInvL, 1.0 / p.L);
+        set(kA0, e.accel0);
+        set(kDa, e.accel1 - e.accel0);
+        set(kTStart, e.tStart);
+        set(kInvRamp, e.tRamp > 0.0 ? 1.0 / e.tRamp : HUGE_VAL);
+
+        // Start settled at accel0: suspension forces carry the steady load transfer
+        const double Ff = -(mSlope + mAccel * e.accel0) / span;
+        const double zf = Ff / p.kf, zr = -Ff / p.kr;
+        const double phi = (zf - zr) / span;
+        set(kPhi, phi);
+        set(kZ, zf - p.lf * phi);
+    }
+
+    out.time.resize(samples);
+    for (int s = 0; s < samples; ++s) out.time[s] = (double)s * opts.outputEvery * opts.dt;
+    for (AxleGrid* grid : {&out.WF, &out.WR, &out.WFStatic, &out.WRStatic, &out.pitch, &out.accel}) grid->Resize(n, samples);
+
+    ThreadPool& pool = opts.pool ? *opts.pool : DefaultThreadPool();
+    pool.ParallelFor(blocks, [&](int b, int) {
+        const int k0 = b * kPitchBlock;
+        const PitchOut o{out.WF.Row(k0), out.WR.Row(k0), out.WFStatic.Row(k0), out.WRStatic.Row(k0),
+                         out.pitch.Row(k0), out.accel.Row(k0), (std::size_t)out.WF.Stride()};
+        PitchRun(lanes.data() + (std::size_t)b * kPitchFields * kPitchBlock, o,
+                 std::min(kPitchBlock, n - k0), steps, opts.dt, opts.outputEvery);
+    });
+
+    out.generation = NextAxleGeneration();
+    return true;
+}
@@ -0,0 +1,86 @@
+/********************
+Program    - Axle Load Model - Pitch Dynamics
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Heave/pitch suspension model, batched fixed-step RK4 over SoA scenario lanes
+********************/
+
+#ifndef AXLE_PITCH_H
+#define AXLE_PITCH_H
+
+#include <cstdint>
+#include <vector>
+#include "axleGrid.hpp"
+#include "axleLoads.hpp"
+
+// Vehicle plus the suspension seen by the body in heave and pitch.
+// Rates are per axle (both wheels together), wheel-centre equivalent.
+struct PitchVehicleParams : VehicleParams {
+    double kf;  // Front suspension stiffness (N/m)
+    double kr;  // Rear suspension stiffness (N/m)
+    double cf;  // Front damping (N*s/m)
+    double cr;  // Rear damping (N*s/m)
+    double Iy;  // Body pitch inertia about the CoG (kg*m^2)
+
+    // Typical passenger-car suspension for vp: front/rear ride frequencies (Hz),
+    // damping ratio, and a pitch radius of gyration of 0.45 * L
+    static PitchVehicleParams FromVehicle(const VehicleParams& vp, double frontHz = 1.3,
+                                          double rearHz = 1.5, double zeta = 0.3);
+};
+
+// Longitudinal input: accel ramps linearly from accel0 to accel1 over [tStart, tStart + tRamp]
+// (tRamp = 0 is a step). theta is constant for the run.
+struct BrakeEvent {
+    double theta = 0.0;             // Slope (rad)
+    double accel0 = 0.0;            // m/s^2 before the event (the run starts settled here)
+    double accel1 = -8.0;           // m/s^2 after the ramp (negative = braking)
+    double tStart = 0.2;            // s
+    double tRamp = 0.1;             // s
+
+    double AccelAt(double t) const;
+};
+
+struct PitchScenario {
+    PitchVehicleParams vp;
+    BrakeEvent event;
+};
+
+class ThreadPool;
+
+struct PitchSimOptions {
+    double dt = 1e-3;               // RK4 step (s)
+    double duration = 2.0;          // s
+    int outputEvery = 10;           // store every Nth step
+    ThreadPool* pool = nullptr;     // nullptr -> DefaultThreadPool()
+};
+
+// Time series per scenario: rows = scenarios, columns = stored samples at time[]
+struct PitchSimData {
+    std::vector<double> time;       // s
+    AxleGrid WF, WR;                // Axle loads (N)
+    AxleGrid WFStatic, WRStatic;    // Quasi-static loads at the same accel (CalculateAxleLoads)
+    AxleGrid pitch;                 // Body pitch (rad, nose-down positive)
+    AxleGrid accel;                 // Input acceleration (m/s^2)
+    std::uint64_t generation = 0;   // unique per completed run; 0 = never filled
+};
+
+// Transient axle loads for many scenarios at once.
+// Model: rigid body on front/rear spring-dampers, heave z and pitch phi (nose-down positive).
+//   deflections   zf = z + lf*phi,  zr = z - lr*phi       (compression positive)
+//   forces        Ff = kf*zf + cf*zf',  Fr = kr*zr + cr*zr'
+//   heave         m*z''    = -(Ff + Fr)
+//   pitch         Iy*phi'' = -L*dW(theta, a(t)) - lf*Ff + lr*Fr
+//   axle loads    WF = pF*cos(theta) + Ff,  WR = pR*cos(theta) + Fr
+// with pF, pR and the load transfer dW = q*sin(theta) + k*a taken from AxlePointCoefficients.
+// At rest (z'' = phi'' = 0, lf + lr = L) these are exactly the CalculateAxleLoads values, so the
+// transient settles onto the static AxleData curves. Runs start settled at accel0.
+// State is kept in SoA lanes (blocks of 256 scenarios) and each RK4 step is one straight-line
+// loop across scenarios (vectorized, runtime ISA dispatch); blocks run in parallel on the pool.
+// Returns false (out left empty) for invalid options, or if dt is beyond the RK4 stability
+// limit for the stiffest scenario; the message goes to std::cerr.
+bool SimulatePitchDynamics(PitchSimData& out, const std::vector<PitchScenario>& scenarios,
+                           const PitchSimOptions& opts);
+
+#endif // AXLE_PITCH_H
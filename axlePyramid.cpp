@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "axlePyramid.hpp"
+#include "threadPool.hpp"
+#include "profiler.hpp"
+
+/********************
+Program    - Axle Load Model - Grid Pyramid
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - 4x first reduction from the grid, 2x per level after, parallel over level rows
+********************/
+
+static const int kFirstScale = 4;
+
+static inline double FrontShare(double wf, double wr) {
+    const double sum = wf + wr;
+    return sum != 0.0 ? wf / sum : 0.0;
+}
+
+static void ResetRow(float* lo, float* hi, int n) {
+    std::fill(lo, lo + n, std::numeric_limits<float>::infinity());
+    std::fill(hi, hi + n, -std::numeric_limits<float>::infinity());
+}
+
+// Level rows [I, I+1) from the grid itself: kFirstScale x kFirstScale cells per level cell
+static void ReduceFromGrid(const AxleData& data, int I, AxleGridF* lo, AxleGridF* hi) {
+    const int rows = data.WF.Rows(), cols = data.WF.Cols();
+    const int outCols = lo[0].Cols();
+    float* l[kAxleHeatFieldCount];
+    float* h[kAxleHeatFieldCount];
+    for (int f = 0; f < kAxleHeatFieldCount; ++f) {
+        l[f] = lo[f].Row(I);
+        h[f] = hi[f].Row(I);
+        ResetRow(l[f], h[f], outCols);
+    }
+    const int i1 = std::min(rows, (I + 1) * kFirstScale);
+    for (int i = I * kFirstScale; i < i1; ++i) {
+        const double* wf = data.WF.Row(i);
+        const double* wr = data.WR.Row(i);
+        for (int j = 0; j < cols; ++j) {
+            const int J = j / kFirstScale;
+            const float v[kAxleHeatFieldCount] = {(float)wf[j], (float)wr[j], (float)FrontShare(wf[j], wr[j])};
+            for (int f = 0; f < kAxleHeatFieldCount; ++f) {
+                l[f][J] = std::min(l[f][J], v[f]);
+                h[f][J] = std::max(h[f][J], v[f]);
+            }
+        }
+    }
+}
+
+// Level row I from the previous level: 2 x 2 cells per level cell
+static void ReduceFromLevel(const AxleGridF* srcLo, const AxleGridF* srcHi, int I,
+                            AxleGridF* lo, AxleGridF* hi) {
+    const int rows = srcLo[0].Rows(), cols = srcLo[0].Cols();
+    const int outCols = lo[0].Cols();
+    const int i1 = std::min(rows, 2 * I + 2);
+    for (int f = 0; f < kAxleHeatFieldCount; ++f) {
+        float* l = lo[f].Row(I);
+        float* h = hi[f].Row(I);
+        ResetRow(l, h, outCols);
+        for (int i = 2 * I; i < i1; ++i) {
+            const float* sl = srcLo[f].Row(i);
+            const float* sh = srcHi[f].Row(i);
+            for (int j = 0; j < cols; ++j) {
+                l[j >> 1] = std::min(l[j >> 1], sl[j]);
+                h[j >> 1] = std::max(h[j >> 1], sh[j]);
+            }
+        }
+    }
+}
+
+void AxleGridPyramid::Clear() {
+    usedLevels_ = 0;
+    generation_ = 0;
+    for (int f = 0; f < kAxleHeatFieldCount; ++f) lo_[f] = hi_[f] = 0.0;
+}
+
+bool AxleGridPyramid::Build(const AxleData& data, ThreadPool* pool, const std::function<bool()>& cancel) {
+    PROFILE_SCOPE("AxleGridPyramid::Build");
+    Clear();
+    const int rows = data.WF.Rows(), cols = data.WF.Cols();
+    if (rows == 0 || cols == 0) return true;
+    ThreadPool& tp = pool ? *pool : DefaultThreadPool();
+
+    // Levels down to a single cell, whose bounds are the whole-grid range
+    int scale = kFirstScale;
+    for (int n = 0;; ++n, scale *= 2) {
+        if (cancel && cancel()) { Clear(); return false; }
+        if ((int)levels_.size() <= n) levels_.emplace_back();
+        Level& lv = levels_[n];
+        lv.scale = scale;
+        const int lr = (rows + scale - 1) / scale, lc = (cols + scale - 1) / scale;
+        for (int f = 0; f < kAxleHeatFieldCount; ++f) {
+            lv.lo[f].Resize(lr, lc);
+            lv.hi[f].Resize(lr, lc);
+        }
+        if (n == 0) {
+            tp.ParallelFor(lr, [&](int I, int) { ReduceFromGrid(data, I, lv.lo, lv.hi); });
+        } else {
+            const Level& src = levels_[n - 1];
+            tp.ParallelFor(lr, [&](int I, int) { ReduceFromLevel(src.lo, src.hi, I, lv.lo, lv.hi); });
+        }
+        usedLevels_ = n + 1;
+        if (lr == 1 && lc == 1) break;
+    }
+
+    const Level& top = levels_[usedLevels_ - 1];
+    for (int f = 0; f < kAxleHeatFieldCount; ++f) {
+        lo_[f] = top.lo[f](0, 0);
+        hi_[f] = top.hi[f](0, 0);
+    }
+    generation_ = data.generation;
+    return true;
+}
+
+// Range of cells of one axis covered by each of n output cells spanning [v0, v1).
+// Grid cell k is centred on origin + k*step; an output cell takes every cell whose centre it
+// contains, or the nearest one when it falls between centres. Indices are then divided down to
+// a level with `scale` grid cells per level cell.
+static void CoverRanges(double v0, double v1, int n, double origin, double step, int cells, int scale,
+                        std::vector<int>& first, std::vector<int>& last) {
+    first.resize(n);
+    last.resize(n);
+    const double span = (v1 - v0) / n;
+    for (int c = 0; c < n; ++c) {
+        const double u0 = (v0 + span * c - origin) / step;
+        const double u1 = (v0 + span * (c + 1) - origin) / step;
+        double k0 = std::ceil(std::min(u0, u1));
+        double k1 = std::ceil(std::max(u0, u1)) - 1.0;
+        if (k1 < k0) k0 = k1 = std::floor(0.5 * (u0 + u1) + 0.5);
+        k0 = std::min(std::max(k0, 0.0), (double)(cells - 1));
+        k1 = std::min(std::max(k1, 0.0), (double)(cells - 1));
+        first[c] = (int)k0 / scale;
+        last[c] = (int)k1 / scale;
+    }
+}
+
+// out[r][c] = max (or min) of get(i, j) over the covered cell ranges
+template <bool UseMax, typename Get>
+static void ReduceView(const Get& get, const std::vector<int>& rFirst, const std::vector<int>& rLast,
+                       const std::vector<int>& cFirst, const std::vector<int>& cLast, float* out) {
+    const int outRows = (int)rFirst.size(), outCols = (int)cFirst.size();
+    for (int r = 0; r < outRows; ++r) {
+        float* dst = out + (std::size_t)r * outCols;
+        for (int c = 0; c < outCols; ++c) {
+            float v = UseMax ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::infinity();
+            for (int i = rFirst[r]; i <= rLast[r]; ++i)
+                for (int j = cFirst[c]; j <= cLast[c]; ++j)
+                    v = UseMax ? std::max(v, get(i, j)) : std::min(v, get(i, j));
+            dst[c] = v;
+        }
+    }
+}
+
+int AxleGridPyramid::Sample(const AxleData& data, AxleHeatField field, bool useMax,
+                            double thetaLo, double thetaHi, double accelLo, double accelHi,
+                            int outRows, int outCols, float* out) const {
+    PROFILE_SCOPE("AxleGridPyramid::Sample");
+    const int rows = data.WF.Rows(), cols = data.WF.Cols();
+    if (outRows <= 0 || outCols <= 0 || rows == 0 || cols == 0) return 0;
+    const double th0 = data.theta.front(), a0 = data.accel.front();
+    const double dTh = rows > 1 && data.theta.back() != th0 ? (data.theta.back() - th0) / (rows - 1) : 1.0;
+    const double dA = cols > 1 && data.accel.back() != a0 ? (data.accel.back() - a0) / (cols - 1) : 1.0;
+
+    // Coarsest level whose cells are still no bigger than an output cell on either axis
+    const double cellsPerOut = std::min(std::fabs(thetaHi - thetaLo) / std::fabs(dTh) / outRows,
+                                        std::fabs(accelHi - accelLo) / std::fabs(dA) / outCols);
+    int level = 0;
+    for (int n = 0; n < usedLevels_ && levels_[n].scale <= cellsPerOut; ++n) level = n + 1;
+    const int scale = level > 0 ? levels_[level - 1].scale : 1;
+
+    // Top row first: theta runs from thetaHi down to thetaLo
+    static thread_local std::vector<int> rFirst, rLast, cFirst, cLast;
+    CoverRanges(thetaHi, thetaLo, outRows, th0, dTh, rows, scale, rFirst, rLast);
+    CoverRanges(accelLo, accelHi, outCols, a0, dA, cols, scale, cFirst, cLast);
+
+    auto reduce = [&](const auto& get) {
+        if (useMax) ReduceView<true>(get, rFirst, rLast, cFirst, cLast, out);
+        else        ReduceView<false>(get, rFirst, rLast, cFirst, cLast, out);
+    };
+    if (level > 0) {
+        const Level& lv = levels_[level - 1];
+        const AxleGridF& g = useMax ? lv.hi[(int)field] : lv.lo[(int)field];
+        reduce([&](int i, int j) { return g(i, j); });
+    } else if (field == AxleHeatField::Front) {
+        reduce([&](int i, int j) { return (float)data.WF(i, j); });
+    } else if (field == AxleHeatField::Rear) {
+        reduce([&](int i, int j) { return (float)data.WR(i, j); });
+    } else {
+        reduce([&](int i, int j) { return (float)FrontShare(data.WF(i, j), data.WR(i, j)); });
+    }
+    return level;
+}
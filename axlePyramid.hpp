@@ -0,0 +1,69 @@
+/********************
+Program    - Axle Load Model - Grid Pyramid
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Min/max mip pyramid over WF, WR and front share, view resampling for heatmaps
+********************/
+
+#ifndef AXLE_PYRAMID_H
+#define AXLE_PYRAMID_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "axleGrid.hpp"
+#include "axleLoads.hpp"
+
+// Quantities the pyramid reduces (front share = WF / (WF + WR))
+enum class AxleHeatField { Front, Rear, FrontShare };
+const int kAxleHeatFieldCount = 3;
+
+class ThreadPool;
+
+// Min/max mip pyramid over a load grid, so any view of it can be resampled to screen size
+// at a cost set by the pixel count rather than the grid size.
+// Level 0 is the grid itself (never copied). Stored levels reduce it by 4, 8, 16, ... cells
+// per side, each cell holding the min and max of every grid cell it covers, in float.
+// Storage is about 1/12 of the cells times 2 bounds times 3 fields, ~2 bytes per grid cell.
+class AxleGridPyramid {
+public:
+    // (Re)build from data; keeps its buffers between builds. cancel (optional) is polled
+    // between levels: when it returns true the build stops and the pyramid is left empty.
+    // Returns false if cancelled.
+    bool Build(const AxleData& data, ThreadPool* pool = nullptr,
+               const std::function<bool()>& cancel = nullptr);
+    void Clear();
+
+    bool Empty() const { return generation_ == 0; }
+    std::uint64_t Generation() const { return generation_; }   // data.generation it was built from
+    int Levels() const { return usedLevels_ + 1; }            // including the grid itself
+
+    // Range of a field over the whole grid (fixed colour scale however the view moves)
+    double Min(AxleHeatField f) const { return lo_[(int)f]; }
+    double Max(AxleHeatField f) const { return hi_[(int)f]; }
+
+    // Resample the view [thetaLo, thetaHi] x [accelLo, accelHi] of data into out
+    // (outRows x outCols, row-major, row 0 = thetaHi so it draws top-down like ImPlot heatmaps).
+    // Each output cell is the max (or min) over the grid cells it covers, read from the
+    // coarsest level at which no output cell is finer than a level cell, so peaks survive any
+    // zoom. data must be the grid the pyramid was built from. Returns the level used (0 = grid).
+    int Sample(const AxleData& data, AxleHeatField f, bool useMax,
+               double thetaLo, double thetaHi, double accelLo, double accelHi,
+               int outRows, int outCols, float* out) const;
+
+private:
+    struct Level {
+        int scale = 0;                           // grid cells per level cell, per side
+        AxleGridF lo[kAxleHeatFieldCount];
+        AxleGridF hi[kAxleHeatFieldCount];
+    };
+    std::vector<Level> levels_;
+    int usedLevels_ = 0;                         // levels_ may hold spare buffers past this
+    double lo_[kAxleHeatFieldCount] = {0.0, 0.0, 0.0};
+    double hi_[kAxleHeatFieldCount] = {0.0, 0.0, 0.0};
+    std::uint64_t generation_ = 0;
+};
+
+#endif // AXLE_PYRAMID_H
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cstring>
+#include "axleQuery.hpp"
+#include "threadPool.hpp"
+#include "profiler.hpp"
+
+/********************
+Program    - Axle Load Model - Query Protocol
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Whole-round evaluation in place, split over the pool by sample count
+********************/
+
+static_assert(sizeof(AxleQueryHeader) == 64, "query header is part of the wire format");
+static_assert(sizeof(AxleReplyHeader) == 32, "reply header is part of the wire format");
+
+void MakeQueryHeader(AxleQueryHeader& h, std::uint64_t id, std::uint32_t count, const VehicleParams& vp) {
+    std::memcpy(h.magic, "AXQR", 4);
+    h.version = kAxleQueryVersion;
+    h.id = id;
+    h.count = count;
+    h.reserved = 0;
+    h.m = vp.m; h.h = vp.h; h.L = vp.L; h.lf = vp.lf; h.lr = vp.lr;
+}
+
+void MakeReplyHeader(AxleReplyHeader& h, const AxleQueryHeader& q, AxleQueryStatus status) {
+    std::memcpy(h.magic, "AXQA", 4);
+    h.version = kAxleQueryVersion;
+    h.id = q.id;
+    h.count = status == AxleQueryStatus::Ok ? q.count : 0;
+    h.status = (std::uint32_t)status;
+    h.serverMicros = 0;
+    h.batchRequests = 0;
+}
+
+bool IsQueryHeader(const AxleQueryHeader& h) { return std::memcmp(h.magic, "AXQR", 4) == 0; }
+bool IsReplyHeader(const AxleReplyHeader& h) { return std::memcmp(h.magic, "AXQA", 4) == 0; }
+
+AxleQueryStatus CheckQuery(const AxleQueryHeader& h) {
+    if (h.version != kAxleQueryVersion) return AxleQueryStatus::BadVersion;
+    if (h.count > kAxleQueryMaxCount) return AxleQueryStatus::TooLarge;
+    // The model divides by L; anything non-finite or non-positive there is a caller bug
+    if (!(h.L > 0.0) || !(h.m > 0.0) || h.h != h.h || h.lf != h.lf || h.lr != h.lr)
+        return AxleQueryStatus::BadVehicle;
+    return AxleQueryStatus::Ok;
+}
+
+// Rounds with fewer samples than this run on the calling thread
+static const std::size_t kParallelMin = 1 << 16;
+// Samples per pool task; large requests are cut into pieces this size
+static const std::size_t kParallelChunk = 1 << 14;
+
+void AxleQueryBatcher::Evaluate(const std::vector<AxleQueryJob>& jobs) {
+    PROFILE_SCOPE("AxleQueryBatcher::Evaluate");
+    ThreadPool& pool = pool_ ? *pool_ : DefaultThreadPool();
+    std::size_t total = 0;
+    for (const AxleQueryJob& j : jobs) total += j.n;
+    if (total < kParallelMin || pool.Size() == 1) {
+        for (const AxleQueryJob& j : jobs) CalculateAxleLoadsBatch(j.vp, j.theta, j.accel, j.n, j.WF, j.WR);
+        return;
+    }
+
+    // Lay the round out as pieces of at most one chunk; each task runs a run of pieces worth
+    // about kParallelChunk samples, so small requests share a task and large ones span several
+    pieces_.clear();
+    tasks_.assign(1, 0);
+    std::size_t fill = 0;
+    for (int k = 0; k < (int)jobs.size(); ++k) {
+        for (std::size_t k0 = 0; k0 < jobs[k].n;) {
+            const std::size_t k1 = std::min(jobs[k].n, k0 + (kParallelChunk - fill));
+            pieces_.push_back({k, k0, k1});
+            fill += k1 - k0;
+            k0 = k1;
+            if (fill == kParallelChunk) {
+                tasks_.push_back((int)pieces_.size());
+                fill = 0;
+            }
+        }
+    }
+    if (tasks_.back() != (int)pieces_.size()) tasks_.push_back((int)pieces_.size());
+    pool.ParallelFor((int)tasks_.size() - 1, [&](int t, int) {
+        for (int p = tasks_[t]; p < tasks_[t + 1]; ++p) {
+            const AxleQueryJob& j = jobs[pieces_[p].job];
+            const std::size_t k0 = pieces_[p].k0, n = pieces_[p].k1 - k0;
+            CalculateAxleLoadsBatch(j.vp, j.theta + k0, j.accel + k0, n, j.WF + k0, j.WR + k0);
+        }
+    });
+}
+
+// Bucket layout: values below kSub map 1:1 into octave 0; above, octave o >= 1 covers
+// [32 << (o-1), 64 << (o-1)) in kSub equal steps
+void LatencyHistogram::Record(std::uint64_t ns) {
+    int idx;
+    if (ns < (std::uint64_t)kSub) {
+        idx = (int)ns;
+    } else {
+        int msb = 63;
+        while (!(ns >> msb)) --msb;
+        const int shift = msb - 5;
+        const int octave = std::min(shift + 1, kOctaves - 1);
+        const int sub = octave == shift + 1 ? (int)((ns >> shift) - kSub) : kSub - 1;
+        idx = octave * kSub + sub;
+    }
+    ++buckets_[idx];
+    ++count_;
+    sum_ += ns;
+    max_ = std::max(max_, ns);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+    for (int k = 0; k < kOctaves * kSub; ++k) buckets_[k] += other.buckets_[k];
+    count_ += other.count_;
+    sum_ += other.sum_;
+    max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::Reset() {
+    std::fill(buckets_, buckets_ + kOctaves * kSub, 0);
+    count_ = sum_ = max_ = 0;
+}
+
+std::uint64_t LatencyHistogram::PercentileNs(double q) const {
+    if (count_ == 0) return 0;
+    q = std::min(1.0, std::max(0.0, q));
+    const std::uint64_t rank = std::max<std::uint64_t>(1, (std::uint64_t)(q * (double)count_ + 0.5));
+    std::uint64_t seen = 0;
+    for (int k = 0; k < kOctaves * kSub; ++k) {
+        seen += buckets_[k];
+        if (seen < rank) continue;
+        const int octave = k / kSub, sub = k % kSub;
+        if (octave == 0) return (std::uint64_t)sub;
+        const int shift = octave - 1;
+        const std::uint64_t upper = (((std::uint64_t)(kSub + sub + 1)) << shift) - 1;
+        return std::min(upper, max_);
+    }
+    return max_;
+}
@@ -0,0 +1,105 @@
+/********************
+Program    - Axle Load Model - Query Protocol
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Binary query/reply framing, per-round batch evaluation, latency histogram
+********************/
+
+#ifndef AXLE_QUERY_H
+#define AXLE_QUERY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "axleLoads.hpp"
+
+// Query server framing (host byte order - the server only listens on a local socket):
+//   request  AxleQueryHeader, then f64 theta[count], then f64 accel[count]
+//   reply    AxleReplyHeader, then f64 WF[count],    then f64 WR[count]  (count = 0 on error)
+// Requests on one connection are answered in order; id is echoed back unchanged.
+struct AxleQueryHeader {
+    char          magic[4];      // 'AXQR'
+    std::uint32_t version;       // kAxleQueryVersion
+    std::uint64_t id;            // caller's tag
+    std::uint32_t count;         // (theta, accel) samples that follow
+    std::uint32_t reserved;      // 0
+    double m, h, L, lf, lr;      // vehicle (see VehicleParams)
+};
+
+enum class AxleQueryStatus : std::uint32_t { Ok = 0, BadVersion = 1, TooLarge = 2, BadVehicle = 3 };
+
+struct AxleReplyHeader {
+    char          magic[4];      // 'AXQA'
+    std::uint32_t version;       // kAxleQueryVersion
+    std::uint64_t id;            // from the request
+    std::uint32_t count;         // samples that follow
+    std::uint32_t status;        // AxleQueryStatus
+    std::uint32_t serverMicros;  // request fully received -> reply queued
+    std::uint32_t batchRequests; // requests evaluated in the same server round (incl. this one)
+};
+
+const std::uint32_t kAxleQueryVersion = 1;
+const std::uint32_t kAxleQueryMaxCount = 1u << 22;   // samples per request (64 MiB payload)
+
+void MakeQueryHeader(AxleQueryHeader& h, std::uint64_t id, std::uint32_t count, const VehicleParams& vp);
+void MakeReplyHeader(AxleReplyHeader& h, const AxleQueryHeader& q, AxleQueryStatus status);
+bool IsQueryHeader(const AxleQueryHeader& h);        // magic only; version is checked per request
+bool IsReplyHeader(const AxleReplyHeader& h);
+// Ok, or why the server refuses to evaluate the request
+AxleQueryStatus CheckQuery(const AxleQueryHeader& h);
+inline std::size_t QueryBytes(std::uint32_t count) { return sizeof(AxleQueryHeader) + 16u * (std::size_t)count; }
+inline std::size_t ReplyBytes(std::uint32_t count) { return sizeof(AxleReplyHeader) + 16u * (std::size_t)count; }
+
+// One decoded request whose results go straight to caller-owned memory (e.g. a reply buffer)
+struct AxleQueryJob {
+    VehicleParams vp;
+    const double* theta;
+    const double* accel;
+    std::size_t n;
+    double* WF;
+    double* WR;
+};
+
+class ThreadPool;
+
+// Evaluates every request of one server round in a single pass. Each request runs through
+// CalculateAxleLoadsBatch in place (request payload in, reply payload out, no copies); once the
+// round holds enough samples it is cut into ~16k-sample pieces spread over the pool, so a burst
+// of small requests and one huge request both keep every worker busy. Not thread-safe: one
+// batcher per evaluating thread.
+class AxleQueryBatcher {
+public:
+    explicit AxleQueryBatcher(ThreadPool* pool = nullptr) : pool_(pool) {}
+
+    void Evaluate(const std::vector<AxleQueryJob>& jobs);
+
+private:
+    struct Piece { int job; std::size_t k0, k1; };
+    ThreadPool* pool_;
+    std::vector<Piece> pieces_;
+    std::vector<int> tasks_;                  // first piece of each pool task, plus an end marker
+};
+
+// Latency histogram with ~3% resolution from 1 ns to several hours: log2 buckets split into 32 linear
+// sub-buckets. Fixed size, no allocation, mergeable.
+class LatencyHistogram {
+public:
+    void Record(std::uint64_t ns);
+    void Merge(const LatencyHistogram& other);
+    void Reset();
+    std::uint64_t Count() const { return count_; }
+    double MeanNs() const { return count_ ? (double)sum_ / (double)count_ : 0.0; }
+    std::uint64_t MaxNs() const { return max_; }
+    // Upper edge of the bucket holding quantile q in [0, 1]
+    std::uint64_t PercentileNs(double q) const;
+
+private:
+    static const int kSub = 32;
+    static const int kOctaves = 40;
+    std::uint64_t buckets_[kOctaves * kSub] = {};
+    std::uint64_t count_ = 0, sum_ = 0, max_ = 0;
+};
+
+#endif // AXLE_QUERY_H
@@ -0,0 +1,75 @@
+#include "axleSensitivity.hpp"
+#include "axleDual.hpp"
+#include "axleKernel.hpp"
+#include "profiler.hpp"
+
+/********************
+Program    - Axle Load Model - Parameter Sensitivities
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Dual-number row coefficients expanded by the row kernel per partial
+********************/
+
+const char* AxleParamName(AxleParam p) {
+    switch (p) {
+        case AxleParam::m:  return "m";
+        case AxleParam::h:  return "h";
+        case AxleParam::L:  return "L";
+        case AxleParam::lf: return "lf";
+        case AxleParam::lr: return "lr";
+    }
+    return "?";
+}
+
+// vp with one unit seed per parameter
+static VehicleParamsT<AxleDual> SeedVehicle(const VehicleParams& vp) {
+    VehicleParamsT<AxleDual> d;
+    d.m  = AxleDual::Seed(vp.m,  (int)AxleParam::m);
+    d.h  = AxleDual::Seed(vp.h,  (int)AxleParam::h);
+    d.L  = AxleDual::Seed(vp.L,  (int)AxleParam::L);
+    d.lf = AxleDual::Seed(vp.lf, (int)AxleParam::lf);
+    d.lr = AxleDual::Seed(vp.lr, (int)AxleParam::lr);
+    return d;
+}
+
+void PrepareAxleSensitivities(AxleSensitivityData& sens, const AxleData& loads) {
+    sens.theta = loads.theta;
+    sens.accel = loads.accel;
+    const int rows = (int)loads.theta.size(), cols = (int)loads.accel.size();
+    for (int p = 0; p < kAxleParamCount; ++p) {
+        sens.dWF[p].Resize(rows, cols);
+        sens.dWR[p].Resize(rows, cols);
+    }
+    sens.generation = NextAxleGeneration();
+}
+
+void CalculateAxleSensitivityRows(AxleData* loads, AxleSensitivityData& sens,
+                                  const VehicleParams& vp, int i0, int i1) {
+    const VehicleParamsT<AxleDual> dvp = SeedVehicle(vp);
+    const int cols = (int)sens.accel.size();
+    const double* accel = sens.accel.data();
+    for (int i = i0; i < i1; ++i) {
+        const AxleRowCoeffsT<AxleDual> rc = AxleRowCoefficients(dvp, AxleDual(sens.theta[i]));
+        if (loads) {
+            const AxleRowCoeffs v{rc.cF.v, rc.kF.v, rc.cR.v, rc.kR.v};
+            AxleRowKernel(v, accel, cols, loads->WF.Row(i), loads->WR.Row(i));
+        }
+        // Partials are affine in accel too: the same kernel expands each of them
+        for (int p = 0; p < kAxleParamCount; ++p) {
+            const AxleRowCoeffs d{rc.cF.d[p], rc.kF.d[p], rc.cR.d[p], rc.kR.d[p]};
+            AxleRowKernel(d, accel, cols, sens.dWF[p].Row(i), sens.dWR[p].Row(i));
+        }
+    }
+}
+
+void CalculateAxleLoadsWithSensitivities(AxleData& loads, AxleSensitivityData& sens,
+                                         const VehicleParams& vp,
+                                         double thetaMin, double thetaMax, int thetaSteps,
+                                         double accelMin, double accelMax, int accelSteps) {
+    PROFILE_SCOPE("CalculateAxleLoadsWithSensitivities");
+    PrepareAxleGrid(loads, thetaMin, thetaMax, thetaSteps, accelMin, accelMax, accelSteps);
+    PrepareAxleSensitivities(sens, loads);
+    CalculateAxleSensitivityRows(&loads, sens, vp, 0, loads.WF.Rows());
+}
@@ -0,0 +1,55 @@
+/********************
+Program    - Axle Load Model - Parameter Sensitivities
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Forward-mode (dual number) partials of WF/WR w.r.t. every vehicle parameter
+********************/
+
+#ifndef AXLE_SENSITIVITY_H
+#define AXLE_SENSITIVITY_H
+
+#include <cstdint>
+#include <vector>
+#include "axleGrid.hpp"
+#include "axleLoads.hpp"
+
+// Parameters the loads are differentiated by, in VehicleParams field order.
+// All five are independent inputs of the model (L is not derived from lf + lr).
+enum class AxleParam { m, h, L, lf, lr };
+const int kAxleParamCount = 5;
+
+const char* AxleParamName(AxleParam p);
+
+// d(WF)/d(param) and d(WR)/d(param) over the same theta x accel grid as the loads
+struct AxleSensitivityData {
+    std::vector<double> theta;               // Slope Angles (rad)
+    std::vector<double> accel;               // Accelerations(m/s^2)
+    AxleGrid dWF[kAxleParamCount];           // [param][theta][accel], N per unit of the parameter
+    AxleGrid dWR[kAxleParamCount];
+    std::uint64_t generation = 0;            // Unique per (re)fill; 0 = never filled
+
+    const AxleGrid& Front(AxleParam p) const { return dWF[(int)p]; }
+    const AxleGrid& Rear(AxleParam p)  const { return dWR[(int)p]; }
+};
+
+// Loads and all parameter partials in one pass over the grid.
+// Each row's affine coefficients (see AxleRowCoeffs) are evaluated once in dual numbers seeded
+// on m, h, L, lf, lr; the value and each partial row are then expanded by the SIMD row kernel.
+// loads is filled exactly as CalculateAxleLoads would fill it (bit-identical values), so one
+// call replaces 1 + 5 (forward differences) or 1 + 10 (central) model evaluations.
+// The lf/lr split at fixed L (CoG moved rearward by d) is dW/dlf - dW/dlr.
+void CalculateAxleLoadsWithSensitivities(AxleData& loads, AxleSensitivityData& sens,
+                                         const VehicleParams& vp,
+                                         double thetaMin, double thetaMax, int thetaSteps,
+                                         double accelMin, double accelMax, int accelSteps);
+
+// Shape sens to match a grid shaped by PrepareAxleGrid (axes copied, no partials computed)
+void PrepareAxleSensitivities(AxleSensitivityData& sens, const AxleData& loads);
+
+// Partials for rows [i0, i1) of a shaped grid; loads rows are written too unless loads is null
+void CalculateAxleSensitivityRows(AxleData* loads, AxleSensitivityData& sens,
+                                  const VehicleParams& vp, int i0, int i1);
+
+#endif // AXLE_SENSITIVITY_H
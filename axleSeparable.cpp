@@ -0,0 +1,79 @@
+#include <vector>
+#include "axleSeparable.hpp"
+
+/********************
+Program    - Axle Load Model - Separable Grid
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Separable grid build, slicing and materialization
+********************/
+
+void CalculateSeparableAxleLoads (
+    SeparableAxleData& data,
+    const VehicleParams& vp,
+    double thetaMin, double thetaMax, int thetaSteps,
+    double accelMin, double accelMax, int accelSteps
+) {
+    if (thetaSteps < 0) thetaSteps = 0;
+    if (accelSteps < 0) accelSteps = 0;
+
+    data.vp = vp;
+    data.theta.resize(thetaSteps);
+    data.accel.resize(accelSteps);
+    data.rows.resize(thetaSteps);
+
+    // Axes match CalculateAxleLoads exactly
+    const double dTheta = thetaSteps > 1 ? (thetaMax - thetaMin) / (thetaSteps - 1) : 0.0;
+    const double dAccel = accelSteps > 1 ? (accelMax - accelMin) / (accelSteps - 1) : 0.0;
+    for (int i = 0; i < thetaSteps; ++i) {
+        data.theta[i] = thetaMin + i * dTheta;
+        data.rows[i] = AxleRowCoefficients(vp, data.theta[i]);
+    }
+    for (int j = 0; j < accelSteps; ++j)
+        data.accel[j] = accelMin + j * dAccel;
+}
+
+void SeparableAxleData::FillRow(int i, double* WFout, double* WRout) const {
+    AxleRowKernel(rows[i], accel.data(), Cols(), WFout, WRout);
+}
+
+void SeparableAxleData::FillColumn(int j, double* WFout, double* WRout) const {
+    const double a = accel[j];
+    for (int i = 0; i < Rows(); ++i) {
+        WFout[i] = rows[i].cF + rows[i].kF * a;
+        WRout[i] = rows[i].cR + rows[i].kR * a;
+    }
+}
+
+void SeparableAxleData::SampleAtAccel(double a, int n, double* thetaOut, double* WFout, double* WRout) const {
+    if (Empty() || n < 2) return;
+    const double t0 = theta.front();
+    const double dt = (theta.back() - t0) / (n - 1);
+    for (int k = 0; k < n; ++k) {
+        thetaOut[k] = t0 + k * dt;
+        const AxleRowCoeffs rc = AxleRowCoefficients(vp, thetaOut[k]);
+        WFout[k] = rc.cF + rc.kF * a;
+        WRout[k] = rc.cR + rc.kR * a;
+    }
+}
+
+void SeparableAxleData::SampleAtTheta(double th, int n, double* accelOut, double* WFout, double* WRout) const {
+    if (Empty() || n < 2) return;
+    const double a0 = accel.front();
+    const double da = (accel.back() - a0) / (n - 1);
+    for (int k = 0; k < n; ++k)
+        accelOut[k] = a0 + k * da;
+    AxleRowKernel(AxleRowCoefficients(vp, th), accelOut, n, WFout, WRout);
+}
+
+void SeparableAxleData::Materialize(AxleData& out) const {
+    out.theta = theta;
+    out.accel = accel;
+    out.WF.Resize(Rows(), Cols());
+    out.WR.Resize(Rows(), Cols());
+    out.generation = NextAxleGeneration();
+    for (int i = 0; i < Rows(); ++i)
+        FillRow(i, out.WF.Row(i), out.WR.Row(i));
+}
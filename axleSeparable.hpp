@@ -0,0 +1,51 @@
+/********************
+Program    - Axle Load Model - Separable Grid
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - O(n+m) rank-2 grid backend with on-demand cells, rows, columns and fine slices
+********************/
+
+#ifndef AXLE_SEPARABLE_H
+#define AXLE_SEPARABLE_H
+
+#include <vector>
+#include "axleLoads.hpp"
+#include "axleKernel.hpp"
+
+// The quasi-static model is rank-2 separable:
+//   WF(theta, a) = cF(theta) + kF * a,   WR(theta, a) = cR(theta) + kR * a
+// so a grid is fully described by one coefficient pair per theta plus the accel axis.
+// Same axes as AxleData, O(thetaSteps + accelSteps) memory; nothing is materialized.
+struct SeparableAxleData {
+    VehicleParams vp{};                // kept for off-grid (fine slice) evaluation
+    std::vector<double> theta;         // Slope Angles (rad)
+    std::vector<double> accel;         // Accelerations(m/s^2)
+    std::vector<AxleRowCoeffs> rows;   // per-theta basis
+
+    int  Rows()  const { return (int)theta.size(); }
+    int  Cols()  const { return (int)accel.size(); }
+    bool Empty() const { return theta.empty() || accel.empty(); }
+
+    // Grid cells
+    double WF(int i, int j) const { return rows[i].cF + rows[i].kF * accel[j]; }
+    double WR(int i, int j) const { return rows[i].cR + rows[i].kR * accel[j]; }
+
+    // Grid slices (Cols() / Rows() values written to each output)
+    void FillRow(int i, double* WFout, double* WRout) const;
+    void FillColumn(int j, double* WFout, double* WRout) const;
+
+    // Slices at arbitrary resolution between the grid bounds (n >= 2 samples,
+    // uniformly spaced) - not limited to grid points.
+    void SampleAtAccel(double a, int n, double* thetaOut, double* WFout, double* WRout) const;
+    void SampleAtTheta(double th, int n, double* accelOut, double* WFout, double* WRout) const;
+
+    // Expand into a dense AxleData (same values as CalculateAxleLoads)
+    void Materialize(AxleData& out) const;
+};
+
+// Build the separable grid in place (reuses the vectors' capacity)
+void CalculateSeparableAxleLoads(SeparableAxleData&, const VehicleParams&, double, double, int, double, double, int);
+
+#endif // AXLE_SEPARABLE_H
@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <functional>
+#include <tuple>
+#include "axleWorker.hpp"
+#include "threadPool.hpp"
+#include "profiler.hpp"
+
+/********************
+Program    - Axle Load Model - Background Recompute
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Worker thread with cancellable jobs, progress and buffered results
+        - Version 1   - Profiler scope around job evaluation
+        - Version 2   - Monte Carlo envelope stage (cancellable, shares the progress bar)
+        - Version 3   - Grid cache lookup before evaluation, store after
+        - Version 4   - Parameter sensitivities in the same row pass as the grid
+        - Version 5   - Heatmap pyramid built from the finished grid
+        - Version 6   - Comparison variants (only those not already in the buffer are recomputed)
+        - Version 7   - Brake bias search on the finished grid
+        - Version 8   - Envelope steps capped; an envelope over budget is dropped, not the result
+        - Version 9   - Cache store only for jobs that ask for it
+        - Version 10  - Stop() joins the thread ahead of destruction
+        - Version 11  - Dense grid (and its cache lookup) skipped, and released, when no stage reads it
+        - Version 12  - Large dense grids released from idle result buffers
+********************/
+
+// Dense grids of a result: loads, sensitivities and the pyramid over them
+struct DenseGrids {
+    AxleData grid;
+    AxleSensitivityData sens;
+    AxleGridPyramid pyramid;
+};
+
+// Bytes held by a result's dense grids (own buffers plus an adopted cache mapping)
+static std::size_t DenseBytes(const AxleResult& r) {
+    std::size_t n = r.grid.WF.Capacity() + r.grid.WR.Capacity();
+    if (r.grid.WF.External()) n += 2 * (std::size_t)r.grid.WF.Rows() * r.grid.WF.Stride();
+    for (int p = 0; p < kAxleParamCount; ++p) n += r.sens.dWF[p].Capacity() + r.sens.dWR[p].Capacity();
+    return n * sizeof(double);
+}
+
+// Move r's dense grids into out (freed when out is destroyed) if they are over the idle budget
+static void TakeIdleGrids(AxleResult& r, DenseGrids& out) {
+    if (DenseBytes(r) <= kIdleGridKeepBytes) return;
+    std::swap(r.grid, out.grid);
+    std::swap(r.sens, out.sens);
+    std::swap(r.pyramid, out.pyramid);
+}
+
+AxleRecomputeWorker::AxleRecomputeWorker()
+    : front_(new AxleResult), back_(new AxleResult), ready_(new AxleResult) {
+    thread_ = std::thread(&AxleRecomputeWorker::Run, this);
+}
+
+AxleRecomputeWorker::~AxleRecomputeWorker() {
+    Stop();
+}
+
+void AxleRecomputeWorker::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    latestGen_.fetch_add(1, std::memory_order_release); // cancel the running job
+    wake_.notify_one();
+    if (thread_.joinable()) thread_.join();
+}
+
+std::uint64_t AxleRecomputeWorker::Submit(const AxleJob& job) {
+    std::uint64_t gen;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ = job;
+        gen = ++pendingGen_;
+        latestGen_.store(gen, std::memory_order_release);
+        busy_.store(true, std::memory_order_release);
+    }
+    wake_.notify_one();
+    return gen;
+}
+
+bool AxleRecomputeWorker::AcquireLatest() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!haveReady_) return false;
+        std::swap(front_, ready_);
+        haveReady_ = false;
+        trimReady_ = true;
+    }
+    wake_.notify_one(); // the worker releases the old front's grids if they are large
+    return true;
+}
+
+void AxleRecomputeWorker::SetReadyCallback(std::function<void()> cb) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    onReady_ = std::move(cb);
+}
+
+void AxleRecomputeWorker::SetGridCache(AxleGridCache* cache) {
+    cache_.store(cache, std::memory_order_release);
+}
+
+void AxleRecomputeWorker::Run() {
+    std::uint64_t done = 0;
+    for (;;) {
+        AxleJob job;
+        std::uint64_t gen;
+        DenseGrids idle;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return stop_ || pendingGen_ != done || trimReady_; });
+            if (stop_) return;
+            // Only taken here; freeing happens outside the lock
+            if (trimReady_ && !haveReady_) TakeIdleGrids(*ready_, idle);
+            trimReady_ = false;
+            if (pendingGen_ == done) continue;
+            job = pending_;
+            gen = done = pendingGen_;
+        }
+        idle = DenseGrids();
+
+        progress_.store(0.0f, std::memory_order_relaxed);
+        if (!Evaluate(job, gen, *back_)) continue; // superseded
+
+        std::function<void()> cb;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::swap(back_, ready_);
+            haveReady_ = true;
+            if (pendingGen_ == gen) busy_.store(false, std::memory_order_release);
+            cb = onReady_;
+        }
+        if (cb) cb();
+        // back_ now holds the previous ready result, which nobody reads until the next job
+        TakeIdleGrids(*back_, idle);
+    }
+}
+
+// Fill out in blocks of rows, bailing out as soon as a newer job is submitted
+bool AxleRecomputeWorker::Evaluate(const AxleJob& job, std::uint64_t gen, AxleResult& out) {
+    PROFILE_SCOPE("CalculateAxleLoads (worker)");
+    auto cancelled = [&] { return latestGen_.load(std::memory_order_acquire) != gen; };
+
+    out.job = job;
+    out.generation = gen;
+    CalculateSeparableAxleLoads(out.sep, job.vp, job.thetaMin, job.thetaMax, job.thetaSteps,
+                                job.accelMin, job.accelMax, job.accelSteps);
+    std::tie(out.WF0, out.WR0) = CalculateNominalAxleLoads(job.vp, job.thetaNom, job.accelNom);
+
+    ThreadPool& pool = DefaultThreadPool();
+    // With an envelope the grid is the quick first tenth of the progress bar
+    const float gridShare = job.envelopeSamples > 0 ? 0.1f : 1.0f;
+
+    AxleGridCache* cache = cache_.load(std::memory_order_acquire);
+    AxleGridKey key;
+    key.vp = job.vp;
+    key.thetaMin = job.thetaMin; key.thetaMax = job.thetaMax; key.thetaSteps = job.thetaSteps;
+    key.accelMin = job.accelMin; key.accelMax = job.accelMax; key.accelSteps = job.accelSteps;
+    // Run rowFn(i0, i1) over the grid in blocks, bailing out when superseded
+    auto fillRows = [&](const std::function<void(int, int)>& rowFn) {
+        const int rows = out.grid.WF.Rows();
+        const int cols = std::max(1, out.grid.WF.Cols());
+        // ~256k cells per block: frequent enough cancellation checks, big enough to spread over the pool
+        const int blockRows = std::max(1, (256 * 1024) / cols);
+        for (int i0 = 0; i0 < rows; i0 += blockRows) {
+            if (cancelled()) return false;
+            const int i1 = std::min(rows, i0 + blockRows);
+            const int per = std::max(1, (i1 - i0 + pool.Size() - 1) / pool.Size());
+            pool.ParallelFor((i1 - i0 + per - 1) / per, [&](int t, int) {
+                const int a = i0 + t * per;
+                rowFn(a, std::min(i1, a + per));
+            });
+            progress_.store(gridShare * (float)i1 / (float)rows, std::memory_order_relaxed);
+        }
+        return true;
+    };
+
+    out.sens.generation = 0;
+    out.gridCached = false;
+    if (!job.NeedsDenseGrid()) {
+        // Only the separable grid is drawn; give the buffer's dense grid back instead of
+        // keeping a copy nothing reads
+        out.grid = AxleData{};
+        progress_.store(gridShare, std::memory_order_relaxed);
+    } else if ((out.gridCached = cache && cache->Load(key, out.grid))) {
+        if (job.sensitivities) {
+            PrepareAxleSensitivities(out.sens, out.grid);
+            if (!fillRows([&](int a, int b) { CalculateAxleSensitivityRows(nullptr, out.sens, job.vp, a, b); }))
+                return false;
+        }
+        progress_.store(gridShare, std::memory_order_relaxed);
+    } else {
+        PrepareAxleGrid(out.grid, job.thetaMin, job.thetaMax, job.thetaSteps,
+                        job.accelMin, job.accelMax, job.accelSteps);
+        bool done;
+        if (job.sensitivities) {
+            // Loads and partials from the same dual-number row coefficients
+            PrepareAxleSensitivities(out.sens, out.grid);
+            done = fillRows([&](int a, int b) { CalculateAxleSensitivityRows(&out.grid, out.sens, job.vp, a, b); });
+        } else {
+            done = fillRows([&](int a, int b) { CalculateAxleLoadRows(out.grid, job.vp, a, b); });
+        }
+        if (!done) return false;
+        if (cache && job.cacheStore && !cancelled()) cache->Store(key, out.grid);
+    }
+
+    out.pyramid.Clear();
+    if (job.pyramid && !out.pyramid.Build(out.grid, &pool, cancelled))
+        return false;
+
+    // Each result buffer keeps its own variant grids, so only variants it does not hold yet are
+    // recomputed (typically just the ones edited since this buffer was last filled)
+    out.fleetRecomputed = 0;
+    if (job.fleet.empty()) {
+        out.fleet.Clear();
+    } else {
+        out.fleetRecomputed = out.fleet.Evaluate(job.fleet,
+            job.thetaMin, job.thetaMax, std::min(job.thetaSteps, kFleetMaxSteps),
+            job.accelMin, job.accelMax, std::min(job.accelSteps, kFleetMaxSteps), &pool, cancelled);
+        if (out.fleetRecomputed < 0) return false;
+    }
+
+    out.brakeBias.generation = 0;
+    if (job.brakeBias) {
+        BrakeBiasOptions bo = job.biasOptions;
+        bo.pool = &pool;
+        bo.progress = [&](float) { return !cancelled(); };
+        // No braking cells is a valid answer (generation stays 0); only cancellation aborts
+        if (!OptimizeBrakeBias(out.grid, bo, out.brakeBias) && cancelled()) return false;
+    }
+
+    out.envelope.generation = 0;
+    if (job.envelopeSamples > 0) {
+        MonteCarloOptions mc;
+        mc.samples = job.envelopeSamples;
+        mc.pool = &pool;
+        mc.progress = [&](float f) {
+            progress_.store(gridShare + (1.0f - gridShare) * f, std::memory_order_relaxed);
+            return !cancelled();
+        };
+        // Over the scratch budget the result simply has no bands; only cancellation aborts
+        if (!CalculateAxleLoadEnvelope(out.envelope, job.dist,
+                                       job.thetaMin, job.thetaMax, std::min(job.thetaSteps, kEnvelopeMaxSteps),
+                                       job.accelMin, job.accelMax, std::min(job.accelSteps, kEnvelopeMaxSteps), mc)
+            && cancelled())
+            return false;
+    }
+    return !cancelled();
+}
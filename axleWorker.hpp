@@ -0,0 +1,151 @@
+/********************
+Program    - Axle Load Model - Background Recompute
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Worker thread with cancellable jobs, progress and buffered results
+        - Version 1   - Optional Monte Carlo envelope per job
+        - Version 2   - Optional on-disk grid cache
+        - Version 3   - Optional parameter sensitivities per job
+        - Version 4   - Optional min/max pyramid for the heatmap view
+        - Version 5   - Vehicle comparison list evaluated with the job
+        - Version 6   - Optional brake bias optimization over the grid
+        - Version 7   - Envelope on a subgrid of at most kEnvelopeMaxSteps per axis
+        - Version 8   - Jobs choose whether their grid is written to the cache
+        - Version 9   - Caller ids travel with the comparison variants
+        - Version 10  - Stop() for callers that must outlive the ready callback's targets
+        - Version 11  - Dense grid only for jobs with a stage that reads it
+        - Version 12  - Idle result buffers release dense grids over kIdleGridKeepBytes
+********************/
+
+#ifndef AXLE_WORKER_H
+#define AXLE_WORKER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "axleBrakeBias.hpp"
+#include "axleFleet.hpp"
+#include "axleGridCache.hpp"
+#include "axleLoads.hpp"
+#include "axleMonteCarlo.hpp"
+#include "axlePyramid.hpp"
+#include "axleSensitivity.hpp"
+#include "axleSeparable.hpp"
+
+// Everything needed to produce one set of plot data
+struct AxleJob {
+    VehicleParams vp{};
+    double thetaMin = 0.0, thetaMax = 0.0; int thetaSteps = 0;
+    double accelMin = 0.0, accelMax = 0.0; int accelSteps = 0;
+    double thetaNom = 0.0, accelNom = 0.0;   // operating point
+    // Monte Carlo envelope over the same ranges, steps capped at kEnvelopeMaxSteps per axis
+    // (skipped when envelopeSamples == 0)
+    VehicleDistribution dist{};
+    std::uint64_t envelopeSamples = 0;
+    bool sensitivities = false;              // also compute dWF/dp, dWR/dp for every parameter
+    bool pyramid = false;                    // also build the heatmap pyramid over the grid
+    // Variants to compare over the same ranges (steps capped at kFleetMaxSteps per axis)
+    std::vector<VehicleParams> fleet;
+    std::vector<int> fleetIds;               // caller's id per fleet entry (labels), not used by the worker
+    bool cacheStore = true;                  // write a computed grid to the cache (off for live edits)
+    bool brakeBias = false;                  // also search the brake bias curve over the grid
+    BrakeBiasOptions biasOptions;            // pool and progress are set by the worker
+
+    // The pyramid, sensitivities and brake bias read the dense WF/WR grid. Without them the
+    // result only holds the separable grid, which is all the line plots need.
+    bool NeedsDenseGrid() const { return pyramid || sensitivities || brakeBias; }
+};
+
+const int kFleetMaxSteps = 1000;
+// Idle result buffers (the one the UI just swapped out, a superseded result) keep dense grids up
+// to this size for reuse and release larger ones. A big grid is then held only by the UI's result
+// and the one being computed.
+const std::size_t kIdleGridKeepBytes = (std::size_t)256 << 20;
+// Every pool worker keeps a histogram per envelope cell, so the envelope grid stays small;
+// the bands are drawn from their own axes
+const int kEnvelopeMaxSteps = 256;
+
+// One finished evaluation
+struct AxleResult {
+    AxleJob job;
+    AxleData grid;                           // empty (generation 0) unless job.NeedsDenseGrid()
+    SeparableAxleData sep;
+    AxleEnvelopeData envelope;               // generation 0 when the job had no envelope
+    AxleSensitivityData sens;                // generation 0 when the job had no sensitivities
+    AxleGridPyramid pyramid;                 // empty when the job had no pyramid
+    AxleFleet fleet;                         // one grid per AxleJob::fleet entry
+    int fleetRecomputed = 0;                 // variants this result had to recompute
+    BrakeBiasResult brakeBias;               // generation 0 when the job had no bias search
+    double WF0 = 0.0, WR0 = 0.0;             // loads at the operating point
+    bool gridCached = false;                 // grid was mapped from the cache, not computed
+    std::uint64_t generation = 0;            // Submit() id that produced it (0 = none yet)
+};
+
+// Evaluates AxleJobs on a background thread so the render loop never blocks.
+// - Submit() supersedes whatever is running: the old job stops at its next row block.
+// - Results are buffered: the UI reads Front(); the worker fills a back buffer; finished
+//   results sit in a ready slot until AcquireLatest() swaps them in. Each swap is a pointer
+//   exchange under a short lock, and buffers are reused so steady state does not allocate
+//   (up to kIdleGridKeepBytes of dense grids per idle buffer).
+class AxleRecomputeWorker {
+public:
+    AxleRecomputeWorker();
+    ~AxleRecomputeWorker();
+
+    AxleRecomputeWorker(const AxleRecomputeWorker&) = delete;
+    AxleRecomputeWorker& operator=(const AxleRecomputeWorker&) = delete;
+
+    // Queue a job, cancelling any older one. Returns its generation.
+    std::uint64_t Submit(const AxleJob& job);
+
+    // Swap in the newest finished result, if any. Call once per frame from the UI thread.
+    bool AcquireLatest();
+
+    // Result currently owned by the UI thread (valid until the next AcquireLatest)
+    const AxleResult& Front() const { return *front_; }
+
+    // True while a submitted job has not produced its result yet
+    bool  Busy() const { return busy_.load(std::memory_order_acquire); }
+    // Fraction of the running job's rows done, 0..1
+    float Progress() const { return progress_.load(std::memory_order_relaxed); }
+
+    // Called on the worker thread whenever a result becomes ready (e.g. to wake the UI)
+    void SetReadyCallback(std::function<void()> cb);
+
+    // Cancel the running job and join the thread. A callback already in flight has returned
+    // by then, so whatever it touches can be torn down afterwards. Submit() after Stop() queues
+    // nothing that will run. Also called by the destructor.
+    void Stop();
+
+    // Look grids up in (and add computed grids to) cache; nullptr disables.
+    // The cache must outlive the worker.
+    void SetGridCache(AxleGridCache* cache);
+
+private:
+    void Run();
+    bool Evaluate(const AxleJob& job, std::uint64_t gen, AxleResult& out);
+
+    std::unique_ptr<AxleResult> front_, back_, ready_;
+    bool haveReady_ = false;
+    bool trimReady_ = false;                    // ready_ was just swapped out of the UI
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    AxleJob pending_;
+    std::uint64_t pendingGen_ = 0;
+    std::atomic<std::uint64_t> latestGen_{0};   // newest submitted generation
+    bool stop_ = false;
+    std::atomic<bool> busy_{false};
+    std::atomic<float> progress_{0.0f};
+    std::function<void()> onReady_;
+    std::atomic<AxleGridCache*> cache_{nullptr};
+    std::thread thread_;
+};
+
+#endif // AXLE_WORKER_H
@@ -0,0 +1,274 @@
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "axleLoads.hpp"
+#include "axleKernel.hpp"
+#include "threadPool.hpp"
+
+/********************
+Program    - Axle Load Modelling for Brake Redistribution
+Maintainer - C.Holmes
+File       - Headless Batch Program
+Version    - 0
+    - Release Notes:
+        - Version 0   - Parallel batch sweeps of vehicle/range configurations to disk
+            -- build -> ✅
+            -- run   -> ./WheelLoadBatch configs.txt -o out [-j threads] [--format csv|bin]
+        - Version 1   - Job names must be plain, unique file names
+        - Version 2   - 'summary' is reserved in any case
+********************/
+
+// One line of the configuration file
+struct BatchJob {
+    std::string name;
+    VehicleParams vp;
+    double thetaMin, thetaMax; int thetaSteps;
+    double accelMin, accelMax; int accelSteps;
+};
+
+// Per-job result row for summary.csv
+struct BatchSummary {
+    bool ok = false;
+    double WFmin = 0.0, WFmax = 0.0, WRmin = 0.0, WRmax = 0.0;
+    double WF0 = 0.0, WR0 = 0.0;
+};
+
+enum class BatchFormat { Csv, Bin };
+
+static void PrintUsage() {
+    std::cerr <<
+        "Usage: WheelLoadBatch <config> [-o outdir] [-j threads] [--format csv|bin]\n"
+        "  config: one job per line, '#' starts a comment\n"
+        "    name m h L lf lr thetaMin thetaMax thetaSteps accelMin accelMax accelSteps\n"
+        "  name: unique file name without '/', '\\' or '..' (not 'summary' in any case)\n"
+        "  csv: <outdir>/<name>.csv, one 'theta,accel,WF,WR' line per cell\n"
+        "  bin: <outdir>/<name>.bin, 'AXLB' u32 version, i32 rows, i32 cols,\n"
+        "       then f64 theta[rows], accel[cols], and per theta row WF[cols], WR[cols]\n";
+}
+
+// Lower-cased, so names differing only in case are duplicates on any file system
+static std::string NameKey(std::string name) {
+    for (char& c : name) c = (char)std::tolower((unsigned char)c);
+    return name;
+}
+
+// A job name becomes <outDir>/<name>.<ext>, so it must stay inside outDir and not
+// replace summary.csv, in any case
+static bool ValidJobName(const std::string& name) {
+    return name.find('/') == std::string::npos && name.find('\\') == std::string::npos &&
+           name.find("..") == std::string::npos && NameKey(name) != "summary";
+}
+
+// Parse the configuration file; malformed lines are reported and skipped
+static bool LoadBatchJobs(const std::string& path, std::vector<BatchJob>& jobs) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Cannot open config file: " << path << std::endl;
+        return false;
+    }
+    std::string line;
+    int lineNo = 0;
+    std::set<std::string> names;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        const size_t hash = line.find('#');
+        if (hash != std::string::npos) line.resize(hash);
+        std::istringstream ss(line);
+        BatchJob job;
+        if (!(ss >> job.name)) continue; // blank/comment line
+        if (!(ss >> job.vp.m >> job.vp.h >> job.vp.L >> job.vp.lf >> job.vp.lr
+                 >> job.thetaMin >> job.thetaMax >> job.thetaSteps
+                 >> job.accelMin >> job.accelMax >> job.accelSteps)) {
+            std::cerr << path << ":" << lineNo << ": expected 12 fields, skipping" << std::endl;
+            continue;
+        }
+        if (job.thetaSteps < 1 || job.accelSteps < 1 || job.vp.L <= 0.0) {
+            std::cerr << path << ":" << lineNo << ": steps must be >= 1 and L > 0, skipping" << std::endl;
+            continue;
+        }
+        if (!ValidJobName(job.name)) {
+            std::cerr << path << ":" << lineNo << ": name '" << job.name
+                      << "' must not contain '/', '\\' or '..' or be 'summary' in any case, skipping" << std::endl;
+            continue;
+        }
+        if (!names.insert(NameKey(job.name)).second) {
+            std::cerr << path << ":" << lineNo << ": duplicate name '" << job.name << "', skipping" << std::endl;
+            continue;
+        }
+        jobs.push_back(job);
+    }
+    return true;
+}
+
+// Per-worker scratch, reused across jobs so steady state does not allocate
+struct BatchScratch {
+    std::vector<double> accel;
+    std::vector<double> WF, WR; // one block of rows
+    std::string text;           // formatted CSV block
+};
+
+// Evaluate one job a block of rows at a time and stream it to disk (bounded memory)
+static BatchSummary RunBatchJob(const BatchJob& job, const std::string& outDir, BatchFormat fmt, BatchScratch& s) {
+    BatchSummary sum;
+    const int rows = job.thetaSteps, cols = job.accelSteps;
+    const double dTheta = rows > 1 ? (job.thetaMax - job.thetaMin) / (rows - 1) : 0.0;
+    const double dAccel = cols > 1 ? (job.accelMax - job.accelMin) / (cols - 1) : 0.0;
+
+    s.accel.resize(cols);
+    for (int j = 0; j < cols; ++j) s.accel[j] = job.accelMin + j * dAccel;
+
+    const std::string path = outDir + "/" + job.name + (fmt == BatchFormat::Csv ? ".csv" : ".bin");
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        std::cerr << "Cannot write " << path << ": " << std::strerror(errno) << std::endl;
+        return sum;
+    }
+    static const size_t kFileBuf = 1 << 20;
+    std::setvbuf(f, nullptr, _IOFBF, kFileBuf);
+
+    // ~256k cells per block (2 x 2 MB)
+    const int blockRows = std::max(1, std::min(rows, (256 * 1024) / cols));
+    s.WF.resize((size_t)blockRows * cols);
+    s.WR.resize((size_t)blockRows * cols);
+
+    bool ok = true;
+    if (fmt == BatchFormat::Csv) {
+        ok = std::fputs("theta,accel,WF,WR\n", f) >= 0;
+    } else {
+        const char magic[4] = {'A', 'X', 'L', 'B'};
+        const unsigned version = 1;
+        ok = std::fwrite(magic, 1, 4, f) == 4
+          && std::fwrite(&version, sizeof(version), 1, f) == 1
+          && std::fwrite(&rows, sizeof(rows), 1, f) == 1
+          && std::fwrite(&cols, sizeof(cols), 1, f) == 1;
+        for (int i = 0; i < rows && ok; ++i) {
+            const double th = job.thetaMin + i * dTheta;
+            ok = std::fwrite(&th, sizeof(th), 1, f) == 1;
+        }
+        ok = ok && std::fwrite(s.accel.data(), sizeof(double), cols, f) == (size_t)cols;
+    }
+
+    sum.WFmin = sum.WRmin =  1e300;
+    sum.WFmax = sum.WRmax = -1e300;
+
+    for (int i0 = 0; i0 < rows && ok; i0 += blockRows) {
+        const int n = std::min(blockRows, rows - i0);
+        for (int r = 0; r < n; ++r) {
+            const double th = job.thetaMin + (i0 + r) * dTheta;
+            AxleRowKernel(AxleRowCoefficients(job.vp, th), s.accel.data(), cols,
+                          s.WF.data() + (size_t)r * cols, s.WR.data() + (size_t)r * cols);
+        }
+        const size_t cells = (size_t)n * cols;
+        for (size_t k = 0; k < cells; ++k) {
+            sum.WFmin = std::min(sum.WFmin, s.WF[k]); sum.WFmax = std::max(sum.WFmax, s.WF[k]);
+            sum.WRmin = std::min(sum.WRmin, s.WR[k]); sum.WRmax = std::max(sum.WRmax, s.WR[k]);
+        }
+
+        if (fmt == BatchFormat::Csv) {
+            s.text.clear();
+            char buf[128];
+            for (int r = 0; r < n; ++r) {
+                const double th = job.thetaMin + (i0 + r) * dTheta;
+                for (int j = 0; j < cols; ++j) {
+                    const size_t k = (size_t)r * cols + j;
+                    const int len = std::snprintf(buf, sizeof(buf), "%.9g,%.9g,%.10g,%.10g\n",
+                                                  th, s.accel[j], s.WF[k], s.WR[k]);
+                    s.text.append(buf, len);
+                }
+            }
+            ok = std::fwrite(s.text.data(), 1, s.text.size(), f) == s.text.size();
+        } else {
+            for (int r = 0; r < n && ok; ++r) {
+                ok = std::fwrite(s.WF.data() + (size_t)r * cols, sizeof(double), cols, f) == (size_t)cols
+                  && std::fwrite(s.WR.data() + (size_t)r * cols, sizeof(double), cols, f) == (size_t)cols;
+            }
+        }
+    }
+
+    if (std::fclose(f) != 0) ok = false;
+    if (!ok) {
+        std::cerr << "Write failed: " << path << std::endl;
+        return sum;
+    }
+
+    std::tie(sum.WF0, sum.WR0) = CalculateNominalAxleLoads(job.vp, 0.0, 0.0);
+    sum.ok = true;
+    return sum;
+}
+
+int main(int argc, char** argv) {
+    std::string configPath, outDir = ".";
+    int threads = 0;
+    BatchFormat fmt = BatchFormat::Csv;
+
+    for (int k = 1; k < argc; ++k) {
+        const std::string arg = argv[k];
+        if ((arg == "-o" || arg == "--out") && k + 1 < argc)          outDir = argv[++k];
+        else if ((arg == "-j" || arg == "--threads") && k + 1 < argc) threads = std::atoi(argv[++k]);
+        else if (arg == "--format" && k + 1 < argc) {
+            const std::string f = argv[++k];
+            if (f == "csv") fmt = BatchFormat::Csv;
+            else if (f == "bin") fmt = BatchFormat::Bin;
+            else { PrintUsage(); return 2; }
+        }
+        else if (arg == "-h" || arg == "--help") { PrintUsage(); return 0; }
+        else if (configPath.empty() && arg[0] != '-') configPath = arg;
+        else { PrintUsage(); return 2; }
+    }
+    if (configPath.empty()) { PrintUsage(); return 2; }
+
+    std::vector<BatchJob> jobs;
+    if (!LoadBatchJobs(configPath, jobs)) return 1;
+    if (jobs.empty()) {
+        std::cerr << "No jobs in " << configPath << std::endl;
+        return 1;
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(outDir, ec);
+    if (ec) {
+        std::cerr << "Cannot create " << outDir << ": " << ec.message() << std::endl;
+        return 1;
+    }
+
+    ThreadPool pool(threads);
+    std::cout << "Jobs: " << jobs.size() << "  threads: " << pool.Size()
+              << "  kernel: " << AxleKernelName(ActiveAxleKernel()) << std::endl;
+
+    // Whole jobs are the unit of work; each worker streams its own files
+    std::vector<BatchScratch> scratch(pool.Size());
+    std::vector<BatchSummary> results(jobs.size());
+    pool.ParallelFor((int)jobs.size(), [&](int job, int worker) {
+        results[job] = RunBatchJob(jobs[job], outDir, fmt, scratch[worker]);
+    });
+
+    // Summary in config order
+    const std::string sumPath = outDir + "/summary.csv";
+    FILE* f = std::fopen(sumPath.c_str(), "w");
+    if (!f) {
+        std::cerr << "Cannot write " << sumPath << std::endl;
+        return 1;
+    }
+    std::fprintf(f, "name,ok,WFmin,WFmax,WRmin,WRmax,WF0,WR0\n");
+    int failed = 0;
+    for (size_t k = 0; k < jobs.size(); ++k) {
+        const BatchSummary& r = results[k];
+        if (!r.ok) ++failed;
+        std::fprintf(f, "%s,%d,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g\n", jobs[k].name.c_str(), r.ok ? 1 : 0,
+                     r.WFmin, r.WFmax, r.WRmin, r.WRmax, r.WF0, r.WR0);
+    }
+    std::fclose(f);
+
+    std::cout << "Done: " << jobs.size() - failed << " ok, " << failed << " failed -> " << outDir << std::endl;
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,674 @@
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include "axleBrakeBias.hpp"
+#include "axleFleet.hpp"
+#include "axleGridCache.hpp"
+#include "axleLoads.hpp"
+#include "axleKernel.hpp"
+#include "axleLut.hpp"
+#include "axleMonteCarlo.hpp"
+#include "axlePitch.hpp"
+#include "axlePyramid.hpp"
+#include "axleQuery.hpp"
+#include "axleSensitivity.hpp"
+#include "frameScheduler.hpp"
+#include "plotSeries.hpp"
+#include "threadPool.hpp"
+
+/********************
+Program    - Axle Load Modelling for Brake Redistribution
+Maintainer - C.Holmes
+File       - Benchmark Program
+Version    - 0
+    - Release Notes:
+        - Version 0   - Grid, batch point and plot-series benchmarks with JSON + baseline compare
+            -- build -> ✅
+            -- run   -> ./WheelLoadBench [--sizes 5x100,1000x1000] [--json out.json] [--baseline base.json]
+        - Version 1   - float32 grid/point cases, --accuracy float vs double report
+        - Version 2   - Lookup table query case + measured vs guaranteed table error
+        - Version 3   - Monte Carlo envelope case
+        - Version 4   - Grid cache load case (mapped grid vs recompute)
+        - Version 5   - Batched RK4 pitch dynamics case
+        - Version 6   - Dual-number sensitivities vs central differences
+        - Version 7   - Heatmap pyramid build and 512x512 view resample cases
+        - Version 8   - Vehicle comparison: batched fleet vs separate grids, single-variant edit
+        - Version 9   - Query server round: batcher vs per-request loop
+        - Version 10  - Brake bias optimizer (column reduction + 3-knot curve search)
+        - Version 11  - Scratch grid cache without a size budget
+        - Version 12  - --idle: frame scheduler checks + simulated UI loop CPU, every vsync vs event-driven
+        - Version 13  - points/lut-scalar
+        - Version 14  - pyramid/view512-full (whole-grid view, coarsest level)
+        - Version 15  - Frame scheduler checks moved to WheelLoadTests; --idle only measures
+********************/
+
+// Allocation counting - replaces the global operator new for this executable only
+static std::atomic<long long> allocCount{0};
+
+void* operator new(std::size_t n) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t n) { return operator new(n); }
+#if defined(_WIN32)
+static void* AlignedAlloc(std::size_t a, std::size_t n) { return _aligned_malloc(n, a); }
+static void  AlignedFree(void* p) { _aligned_free(p); }
+#else
+static void* AlignedAlloc(std::size_t a, std::size_t n) { return std::aligned_alloc(a, (n + a - 1) / a * a); }
+static void  AlignedFree(void* p) { std::free(p); }
+#endif
+void* operator new(std::size_t n, std::align_val_t al) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = AlignedAlloc((std::size_t)al, n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t n, std::align_val_t al) { return operator new(n, al); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { AlignedFree(p); }
+
+struct BenchResult {
+    std::string name;
+    double nsPerItem = 0.0;   // best run
+    double gbPerSec = 0.0;    // bytes written / best time
+    double allocsPerRun = 0.0;
+    long long items = 0;      // cells / samples per run
+};
+
+struct BenchOptions {
+    double minSeconds = 0.25; // keep repeating until this much time was measured
+    int minRuns = 3;
+};
+
+// Run fn repeatedly, keep the fastest run. bytes = bytes written per run.
+static BenchResult Measure(const std::string& name, long long items, double bytes,
+                           const BenchOptions& opt, const std::function<void()>& fn) {
+    using clock = std::chrono::steady_clock;
+    fn(); // warm-up: page in buffers, size scratch
+    double best = 1e300, total = 0.0;
+    long long allocs = 0;
+    int runs = 0;
+    while (runs < opt.minRuns || total < opt.minSeconds) {
+        const long long a0 = allocCount.load(std::memory_order_relaxed);
+        const auto t0 = clock::now();
+        fn();
+        const double dt = std::chrono::duration<double>(clock::now() - t0).count();
+        allocs += allocCount.load(std::memory_order_relaxed) - a0;
+        best = std::min(best, dt);
+        total += dt;
+        ++runs;
+    }
+    BenchResult r;
+    r.name = name;
+    r.items = items;
+    r.nsPerItem = best * 1e9 / (double)items;
+    r.gbPerSec = bytes / best / 1e9;
+    r.allocsPerRun = (double)allocs / runs;
+    std::printf("%-40s %12.3f ns/item %9.2f GB/s %8.1f allocs/run\n",
+                r.name.c_str(), r.nsPerItem, r.gbPerSec, r.allocsPerRun);
+    std::fflush(stdout);
+    return r;
+}
+
+static void PrintUsage() {
+    std::cerr <<
+        "Usage: WheelLoadBench [--sizes RxC,...] [--points N] [--threads N] [--scaling]\n"
+        "                      [--json out.json] [--baseline base.json] [--tolerance 0.10] [--accuracy] [--idle]\n"
+        "  Default sizes: 5x100,100x1000,1000x1000,4096x4096,10000x10000\n"
+        "  --accuracy    only report float vs double model error over the operating envelope\n"
+        "  --idle        only measure a simulated UI loop's CPU, every vsync vs event-driven\n"
+        "  --scaling     also run the parallel grid fill at 1..threads threads\n"
+        "  --baseline    compare ns/item with a previous --json run; exit 1 on regression\n";
+}
+
+static bool ParseSizes(const std::string& s, std::vector<std::pair<int, int>>& out) {
+    out.clear();
+    std::stringstream ss(s);
+    std::string tok;
+    while (std::getline(ss, tok, ',')) {
+        int r = 0, c = 0;
+        if (std::sscanf(tok.c_str(), "%dx%d", &r, &c) != 2 || r < 1 || c < 1) return false;
+        out.emplace_back(r, c);
+    }
+    return !out.empty();
+}
+
+// Max errors of one float path against the double reference
+struct AccuracyStats {
+    double maxAbsF = 0.0, maxAbsR = 0.0; // N
+    double maxRelW = 0.0;                // |error| / (m*g)
+    void Add(double refF, double refR, double f, double r, double W) {
+        const double eF = std::fabs(f - refF), eR = std::fabs(r - refR);
+        maxAbsF = std::max(maxAbsF, eF);
+        maxAbsR = std::max(maxAbsR, eR);
+        maxRelW = std::max(maxRelW, std::max(eF, eR) / W);
+    }
+};
+
+static void PrintAccuracy(const char* vehicle, const char* path, const AccuracyStats& a) {
+    std::printf("%-10s %-16s %12.4g %12.4g %14.3g\n", vehicle, path, a.maxAbsF, a.maxAbsR, a.maxRelW);
+}
+
+// float vs double across the realistic envelope: +-0.35 rad (about +-20 deg, beyond the
+// steepest public roads) and +-12 m/s^2 (beyond full braking / traction on dry tarmac).
+// The reference is the double model with libm trig.
+static void AccuracyReport() {
+    const double thMin = -0.35, thMax = 0.35, aMin = -12.0, aMax = 12.0;
+    const int rows = 1001, cols = 1001;
+    struct Vehicle { const char* name; VehicleParams vp; };
+    const Vehicle vehicles[] = {
+        {"city",  {900.0,  0.50, 2.30, 0.92, 1.38}},
+        {"sedan", {1475.0, 0.55, 2.636, 1.0544, 1.5816}},
+        {"van",   {3500.0, 0.95, 3.66, 1.65, 2.01}},
+    };
+    std::printf("accuracy: float vs double, theta [%.2f, %.2f] rad, accel [%.0f, %.0f] m/s^2\n",
+                thMin, thMax, aMin, aMax);
+    std::printf("%-10s %-16s %12s %12s %14s\n", "vehicle", "path", "max|dWF| N", "max|dWR| N", "max err/(m*g)");
+
+    AxleData ref;
+    AxleDataF grid;
+    std::vector<float> thF((std::size_t)rows * cols), aF(thF.size()), WF(thF.size()), WR(thF.size());
+    for (const Vehicle& v : vehicles) {
+        const VehicleParamsF vpF = ConvertVehicleParams<float>(v.vp);
+        const double W = v.vp.m * g;
+        CalculateAxleLoads(ref, v.vp, thMin, thMax, rows, aMin, aMax, cols);
+        CalculateAxleLoads(grid, vpF, thMin, thMax, rows, aMin, aMax, cols);
+
+        // Grid fill, point kernel and nominal model, all on the same cells
+        AccuracyStats sGrid, sBatch, sNominal;
+        for (int i = 0; i < rows; ++i)
+            for (int j = 0; j < cols; ++j) {
+                const std::size_t k = (std::size_t)i * cols + j;
+                thF[k] = grid.theta[i];
+                aF[k] = grid.accel[j];
+            }
+        CalculateAxleLoadsBatch(vpF, thF.data(), aF.data(), thF.size(), WF.data(), WR.data());
+        for (int i = 0; i < rows; ++i)
+            for (int j = 0; j < cols; ++j) {
+                const std::size_t k = (std::size_t)i * cols + j;
+                // Reference at the float inputs, so only arithmetic error is measured
+                const auto [rF, rR] = CalculateNominalAxleLoads(v.vp, (double)thF[k], (double)aF[k]);
+                sGrid.Add(rF, rR, grid.WF(i, j), grid.WR(i, j), W);
+                sBatch.Add(rF, rR, WF[k], WR[k], W);
+                const auto [nF, nR] = CalculateNominalAxleLoads(vpF, thF[k], aF[k]);
+                sNominal.Add(rF, rR, nF, nR, W);
+            }
+        PrintAccuracy(v.name, "grid", sGrid);
+        PrintAccuracy(v.name, "batch", sBatch);
+        PrintAccuracy(v.name, "nominal", sNominal);
+
+        // Lookup table (double) against its guaranteed bound, at off-node points
+        AxleLoadLut lut;
+        if (lut.BuildForError(v.vp, thMin, thMax, aMin, aMax, 0.01)) {
+            AccuracyStats sLut;
+            std::vector<double> th(thF.size()), a(thF.size()), lF(thF.size()), lR(thF.size());
+            for (std::size_t k = 0; k < th.size(); ++k) {
+                th[k] = thMin + (thMax - thMin) * ((double)(k % 997) + 0.5) / 997.0;
+                a[k]  = aMin + (aMax - aMin) * ((double)(k / 997 % 991) + 0.37) / 991.0;
+            }
+            lut.Query(th.data(), a.data(), th.size(), lF.data(), lR.data());
+            for (std::size_t k = 0; k < th.size(); ++k) {
+                const auto [rF, rR] = CalculateNominalAxleLoads(v.vp, th[k], a[k]);
+                sLut.Add(rF, rR, lF[k], lR[k], W);
+            }
+            char path[48];
+            std::snprintf(path, sizeof(path), "lut %dx%d", lut.ThetaNodes(), lut.AccelNodes());
+            PrintAccuracy(v.name, path, sLut);
+            std::printf("%-10s %-16s %12.4g N guaranteed\n", v.name, "lut bound", lut.ErrorBound());
+        }
+    }
+    std::printf("float epsilon: %.3g (relative error floor for one rounding)\n", (double)FLT_EPSILON);
+}
+
+static bool WriteJson(const std::string& path, const std::vector<BenchResult>& results, int threads) {
+    std::ofstream f(path);
+    if (!f) return false;
+    f << "{\n  \"kernel\": \"" << AxleKernelName(ActiveAxleKernel()) << "\",\n"
+      << "  \"threads\": " << threads << ",\n  \"results\": [\n";
+    for (size_t k = 0; k < results.size(); ++k) {
+        const BenchResult& r = results[k];
+        char line[512];
+        std::snprintf(line, sizeof(line),
+            "    {\"name\": \"%s\", \"items\": %lld, \"ns_per_item\": %.6g, \"gb_per_s\": %.6g, \"allocs_per_run\": %.6g}%s\n",
+            r.name.c_str(), r.items, r.nsPerItem, r.gbPerSec, r.allocsPerRun, k + 1 < results.size() ? "," : "");
+        f << line;
+    }
+    f << "  ]\n}\n";
+    return (bool)f;
+}
+
+// Reads back what WriteJson produced: name -> ns_per_item
+static bool ReadBaseline(const std::string& path, std::map<std::string, double>& out) {
+    std::ifstream f(path);
+    if (!f) return false;
+    std::stringstream ss;
+    ss << f.rdbuf();
+    const std::string s = ss.str();
+    size_t pos = 0;
+    while ((pos = s.find("\"name\": \"", pos)) != std::string::npos) {
+        pos += 9;
+        const size_t end = s.find('"', pos);
+        const size_t ns = s.find("\"ns_per_item\": ", end);
+        if (end == std::string::npos || ns == std::string::npos) break;
+        out[s.substr(pos, end - pos)] = std::atof(s.c_str() + ns + 15);
+        pos = ns;
+    }
+    return true;
+}
+
+// Stand-in for glfwWaitEventsTimeout / glfwPostEmptyEvent
+struct FakeEventQueue {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool event = false;
+    void Post() {
+        { std::lock_guard<std::mutex> lock(mutex); event = true; }
+        cv.notify_one();
+    }
+    void Wait(double seconds) {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait_for(lock, std::chrono::duration<double>(seconds), [&] { return event; });
+        event = false;
+    }
+};
+
+struct IdleLoopStats { double cpuPercent, fps; std::uint64_t frames; };
+
+// The GUI loop without a window: wait as the scheduler says, build a frame (frameMs of busy
+// CPU), then block until the next 60 Hz vsync as glfwSwapBuffers would. postAt > 0 posts one
+// "result ready" wake-up (RequestFrames(1) + Post) from another thread at that time.
+static IdleLoopStats RunIdleLoop(bool eventDriven, double seconds, double frameMs, double postAt) {
+    using clock = std::chrono::steady_clock;
+    FrameScheduler scheduler;
+    scheduler.SetEventDriven(eventDriven);
+    FakeEventQueue events;
+    std::thread poster;
+    if (postAt > 0.0)
+        poster = std::thread([&] {
+            std::this_thread::sleep_for(std::chrono::duration<double>(postAt));
+            scheduler.RequestFrames(1);
+            events.Post();
+        });
+    const auto vsync = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / 60.0));
+    const double cpu0 = ProcessCpuSeconds();
+    const auto t0 = clock::now(), stop = t0 + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(seconds));
+    auto nextVsync = t0;
+    while (clock::now() < stop) {
+        const double wait = scheduler.WaitTimeout(1.0);
+        if (wait > 0.0) events.Wait(std::min(wait, std::chrono::duration<double>(stop - clock::now()).count()));
+        const auto busyUntil = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(frameMs * 1e-3));
+        while (clock::now() < busyUntil) {}
+        scheduler.FrameDrawn();
+        while (nextVsync <= clock::now()) nextVsync += vsync;
+        std::this_thread::sleep_until(nextVsync);
+    }
+    const double wall = std::chrono::duration<double>(clock::now() - t0).count();
+    const double cpu = ProcessCpuSeconds() - cpu0;
+    if (poster.joinable()) poster.join();
+    return {100.0 * cpu / wall, scheduler.FramesDrawn() / wall, scheduler.FramesDrawn()};
+}
+
+// CPU of the simulated loop, every vsync vs event-driven. The scheduler's rules are checked in
+// WheelLoadTests; this only measures. The figures are for a synthetic frame, not the real GUI.
+static void IdleReport() {
+    // Synthetic frame cost: the real one depends on the GPU driver and plot sizes
+    const double frameMs = 3.0, seconds = 3.0;
+    std::printf("simulated UI loop (no window), %.0f ms CPU per frame, 60 Hz vsync, %.0f s each\n", frameMs, seconds);
+    const IdleLoopStats vsyncLoop = RunIdleLoop(false, seconds, frameMs, 0.0);
+    const IdleLoopStats idleLoop = RunIdleLoop(true, seconds, frameMs, 0.0);
+    const IdleLoopStats wokenLoop = RunIdleLoop(true, seconds, frameMs, 1.5);
+    std::printf("  %-40s %6.2f%% CPU %6.1f fps %5llu frames\n", "every vsync (before)", vsyncLoop.cpuPercent, vsyncLoop.fps,
+                (unsigned long long)vsyncLoop.frames);
+    std::printf("  %-40s %6.2f%% CPU %6.1f fps %5llu frames\n", "event-driven, idle", idleLoop.cpuPercent, idleLoop.fps,
+                (unsigned long long)idleLoop.frames);
+    std::printf("  %-40s %6.2f%% CPU %6.1f fps %5llu frames\n", "event-driven, one result mid-run", wokenLoop.cpuPercent, wokenLoop.fps,
+                (unsigned long long)wokenLoop.frames);
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::pair<int, int>> sizes = {{5, 100}, {100, 1000}, {1000, 1000}, {4096, 4096}, {10000, 10000}};
+    std::string jsonPath, baselinePath;
+    long long points = 1 << 22;
+    int threads = 0;
+    bool scaling = false;
+    bool accuracy = false;
+    bool idle = false;
+    double tolerance = 0.10;
+
+    for (int k = 1; k < argc; ++k) {
+        const std::string arg = argv[k];
+        if (arg == "--sizes" && k + 1 < argc) {
+            if (!ParseSizes(argv[++k], sizes)) { PrintUsage(); return 2; }
+        }
+        else if (arg == "--points" && k + 1 < argc)    points = std::atoll(argv[++k]);
+        else if (arg == "--threads" && k + 1 < argc)   threads = std::atoi(argv[++k]);
+        else if (arg == "--scaling")                   scaling = true;
+        else if (arg == "--accuracy")                  accuracy = true;
+        else if (arg == "--idle")                      idle = true;
+        else if (arg == "--json" && k + 1 < argc)      jsonPath = argv[++k];
+        else if (arg == "--baseline" && k + 1 < argc)  baselinePath = argv[++k];
+        else if (arg == "--tolerance" && k + 1 < argc) tolerance = std::atof(argv[++k]);
+        else if (arg == "-h" || arg == "--help") { PrintUsage(); return 0; }
+        else { PrintUsage(); return 2; }
+    }
+
+    if (accuracy) {
+        AccuracyReport();
+        return 0;
+    }
+    if (idle) {
+        IdleReport();
+        return 0;
+    }
+
+    ThreadPool pool(threads);
+    const BenchOptions opt;
+    const VehicleParams vp{1475.0, 0.55, 2.636, 1.0544, 1.5816};
+    std::vector<BenchResult> results;
+    std::printf("kernel: %s  threads: %d\n", AxleKernelName(ActiveAxleKernel()), pool.Size());
+
+    // Grid fills (serial and parallel), reusing one AxleData like the GUI does
+    for (const auto& sz : sizes) {
+        const int rows = sz.first, cols = sz.second;
+        const long long cells = (long long)rows * cols;
+        const double bytes = (double)cells * 2 * sizeof(double);
+        const std::string tag = std::to_string(rows) + "x" + std::to_string(cols);
+        AxleData data;
+        results.push_back(Measure("grid/serial/" + tag, cells, bytes, opt, [&] {
+            CalculateAxleLoads(data, vp, -0.3, 0.3, rows, -10.0, 10.0, cols);
+        }));
+        results.push_back(Measure("grid/parallel/" + tag, cells, bytes, opt, [&] {
+            CalculateAxleLoadsParallel(data, vp, -0.3, 0.3, rows, -10.0, 10.0, cols, pool);
+        }));
+        {
+            AxleDataF dataF;
+            const VehicleParamsF vpF = ConvertVehicleParams<float>(vp);
+            results.push_back(Measure("grid/serial-f32/" + tag, cells, bytes / 2, opt, [&] {
+                CalculateAxleLoads(dataF, vpF, -0.3, 0.3, rows, -10.0, 10.0, cols);
+            }));
+        }
+        // Cache hit: map + validate the stored grid (scratch cache directory, removed below)
+        {
+            AxleGridCache gridCache((std::filesystem::temp_directory_path() / "wheelload_bench_cache").string(), UINT64_MAX);
+            AxleGridKey key;
+            key.vp = vp;
+            key.thetaMin = -0.3; key.thetaMax = 0.3; key.thetaSteps = rows;
+            key.accelMin = -10.0; key.accelMax = 10.0; key.accelSteps = cols;
+            CalculateAxleLoads(data, vp, -0.3, 0.3, rows, -10.0, 10.0, cols);
+            if (gridCache.Store(key, data)) {
+                AxleData mapped;
+                results.push_back(Measure("cache/load/" + tag, cells, bytes, opt, [&] {
+                    gridCache.Load(key, mapped);
+                }));
+            }
+            std::error_code ec;
+            std::filesystem::remove_all(gridCache.Directory(), ec);
+        }
+        // Heatmap: pyramid build, then 512x512 resamples of the centre quarter (a zoomed view) and
+        // of the whole grid
+        {
+            CalculateAxleLoads(data, vp, -0.3, 0.3, rows, -10.0, 10.0, cols);
+            AxleGridPyramid pyramid;
+            results.push_back(Measure("pyramid/build/" + tag, cells, bytes, opt, [&] {
+                pyramid.Build(data, &pool);
+            }));
+            std::vector<float> view(512 * 512);
+            results.push_back(Measure("pyramid/view512/" + tag, 512 * 512, 512.0 * 512 * sizeof(float), opt, [&] {
+                pyramid.Sample(data, AxleHeatField::Front, true, -0.15, 0.15, -5.0, 5.0, 512, 512, view.data());
+            }));
+            results.push_back(Measure("pyramid/view512-full/" + tag, 512 * 512, 512.0 * 512 * sizeof(float), opt, [&] {
+                pyramid.Sample(data, AxleHeatField::Front, true, -0.3, 0.3, -10.0, 10.0, 512, 512, view.data());
+            }));
+        }
+        // Plot data prep: forced rebuild of 2 and 16 slices at 1000 px
+        AxlePlotSeriesCache cache;
+        for (int slices : {2, 16}) {
+            const long long pts = 2LL * slices * (std::min(rows, 1000) + std::min(cols, 1000));
+            results.push_back(Measure("plotprep/" + std::to_string(slices) + "slices/" + tag, pts,
+                                      (double)pts * 2 * sizeof(double), opt, [&] {
+                data.generation = NextAxleGeneration();
+                cache.Update(data, slices, 1000);
+            }));
+        }
+    }
+
+    // Scaling sweep of the parallel fill
+    if (scaling) {
+        const int rows = 4096, cols = 4096;
+        AxleData data;
+        for (int t = 1; t <= pool.Size(); ++t) {
+            ThreadPool sub(t);
+            results.push_back(Measure("scaling/" + std::to_string(t) + "threads/4096x4096", (long long)rows * cols,
+                                      (double)rows * cols * 16.0, opt, [&] {
+                CalculateAxleLoadsParallel(data, vp, -0.3, 0.3, rows, -10.0, 10.0, cols, sub);
+            }));
+        }
+    }
+
+    // Monte Carlo envelope on the GUI's grid (items = sampled cells)
+    {
+        VehicleDistribution dist = VehicleDistribution::FromVehicle(vp);
+        dist.m  = ParamSpread::Uniform(vp.m - 200.0, vp.m + 200.0);
+        dist.h  = ParamSpread::Normal(vp.h, 0.05);
+        dist.lf = ParamSpread::Uniform(vp.lf - 0.05, vp.lf + 0.05);
+        MonteCarloOptions mc;
+        mc.samples = 20000;
+        mc.pool = &pool;
+        AxleEnvelopeData env;
+        const long long cells = (long long)mc.samples * 5 * 100;
+        results.push_back(Measure("montecarlo/20000samples/5x100", cells, 5.0 * 100 * 10 * sizeof(double), opt, [&] {
+            CalculateAxleLoadEnvelope(env, dist, -0.3, 0.3, 5, -10.0, 10.0, 100, mc);
+        }));
+    }
+
+    // Loads + all 5 parameter partials: one dual-number pass vs 1 + 10 central-difference grids
+    // (1000x1000 only: 12 grids of this size are already ~100 MB)
+    {
+        const int rows = 1000, cols = 1000;
+        const long long cells = (long long)rows * cols;
+        AxleData data;
+        AxleSensitivityData sens;
+        results.push_back(Measure("sens/dual/1000x1000", cells, (double)cells * 12 * sizeof(double), opt, [&] {
+            CalculateAxleLoadsWithSensitivities(data, sens, vp, -0.3, 0.3, rows, -10.0, 10.0, cols);
+        }));
+        AxleData lo, hi;
+        results.push_back(Measure("sens/central-diff/1000x1000", cells, (double)cells * 22 * sizeof(double), opt, [&] {
+            CalculateAxleLoads(data, vp, -0.3, 0.3, rows, -10.0, 10.0, cols);
+            double VehicleParams::* const fields[kAxleParamCount] =
+                {&VehicleParams::m, &VehicleParams::h, &VehicleParams::L, &VehicleParams::lf, &VehicleParams::lr};
+            for (int p = 0; p < kAxleParamCount; ++p) {
+                const double step = 1e-6 * std::max(1.0, std::fabs(vp.*fields[p]));
+                VehicleParams a = vp, b = vp;
+                a.*fields[p] -= step;
+                b.*fields[p] += step;
+                CalculateAxleLoads(lo, a, -0.3, 0.3, rows, -10.0, 10.0, cols);
+                CalculateAxleLoads(hi, b, -0.3, 0.3, rows, -10.0, 10.0, cols);
+                const double inv = 0.5 / step;
+                for (int i = 0; i < rows; ++i) {
+                    double* dF = sens.dWF[p].Row(i);
+                    double* dR = sens.dWR[p].Row(i);
+                    for (int j = 0; j < cols; ++j) {
+                        dF[j] = (hi.WF(i, j) - lo.WF(i, j)) * inv;
+                        dR[j] = (hi.WR(i, j) - lo.WR(i, j)) * inv;
+                    }
+                }
+            }
+        }));
+    }
+
+    // Vehicle comparison: 24 variants on the GUI's capped comparison grid (items = cells of all variants)
+    {
+        const int rows = 1000, cols = 1000, count = 24;
+        std::vector<VehicleParams> fleetParams;
+        for (int k = 0; k < count; ++k)
+            fleetParams.push_back({vp.m + 20.0 * k, vp.h + 0.005 * k, vp.L, vp.lf + 0.01 * k, vp.lr - 0.01 * k});
+        const long long cells = (long long)rows * cols * count;
+        const double bytes = (double)cells * 2 * sizeof(double);
+        // Every variant edited each run, so all are recomputed into their existing buffers
+        AxleFleet fleet;
+        int flipAll = 0;
+        results.push_back(Measure("fleet/batched/24x1000x1000", cells, bytes, opt, [&] {
+            const double dm = (flipAll ^= 1) ? 1.0 : -1.0;
+            for (VehicleParams& p : fleetParams) p.m += dm;
+            fleet.Evaluate(fleetParams, -0.3, 0.3, rows, -10.0, 10.0, cols, &pool);
+        }));
+        std::vector<AxleData> separate(count);
+        results.push_back(Measure("fleet/separate/24x1000x1000", cells, bytes, opt, [&] {
+            for (int k = 0; k < count; ++k)
+                CalculateAxleLoadsParallel(separate[k], fleetParams[k], -0.3, 0.3, rows, -10.0, 10.0, cols, pool);
+        }));
+        // One variant edited: only its grid is recomputed (items still count the whole fleet)
+        int flip = 0;
+        results.push_back(Measure("fleet/edit-one/24x1000x1000", cells, bytes, opt, [&] {
+            fleetParams[7].m += (flip ^= 1) ? 1.0 : -1.0;
+            fleet.Evaluate(fleetParams, -0.3, 0.3, rows, -10.0, 10.0, cols, &pool);
+        }));
+    }
+
+    // Pitch dynamics: 4096 braking scenarios, 2 s at 1 ms (items = scenario steps)
+    {
+        std::vector<PitchScenario> scenarios(4096);
+        for (int k = 0; k < (int)scenarios.size(); ++k) {
+            scenarios[k].vp = PitchVehicleParams::FromVehicle(vp, 1.1 + 0.0001 * k, 1.4, 0.2 + 0.00005 * k);
+            scenarios[k].event.accel1 = -2.0 - (k % 8);
+        }
+        PitchSimOptions po;
+        po.pool = &pool;
+        PitchSimData sim;
+        const long long steps = (long long)scenarios.size() * 2000;
+        results.push_back(Measure("pitch/rk4/4096scenarios/2s", steps, (double)scenarios.size() * 201 * 6 * sizeof(double), opt, [&] {
+            SimulatePitchDynamics(sim, scenarios, po);
+        }));
+    }
+
+    // Batch point evaluation vs the scalar nominal model
+    {
+        std::vector<double> th(points), a(points), WF(points), WR(points);
+        std::uint64_t state = 0x9E3779B97F4A7C15ull;
+        auto uniform = [&](double lo, double hi) {
+            state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+            return lo + (hi - lo) * (double)(state >> 11) / 9007199254740992.0;
+        };
+        for (long long k = 0; k < points; ++k) { th[k] = uniform(-0.4, 0.4); a[k] = uniform(-10.0, 10.0); }
+        const double bytes = (double)points * 2 * sizeof(double);
+        results.push_back(Measure("points/batch", points, bytes, opt, [&] {
+            CalculateAxleLoadsBatch(vp, th.data(), a.data(), (std::size_t)points, WF.data(), WR.data());
+        }));
+        {
+            const VehicleParamsF vpF = ConvertVehicleParams<float>(vp);
+            std::vector<float> thF(th.begin(), th.end()), aF(a.begin(), a.end()), WFf(points), WRf(points);
+            results.push_back(Measure("points/batch-f32", points, bytes / 2, opt, [&] {
+                CalculateAxleLoadsBatch(vpF, thF.data(), aF.data(), (std::size_t)points, WFf.data(), WRf.data());
+            }));
+        }
+        {
+            AxleLoadLut lut;
+            lut.BuildForError(vp, -0.4, 0.4, -10.0, 10.0, 0.01);
+            results.push_back(Measure("points/lut", points, bytes, opt, [&] {
+                lut.Query(th.data(), a.data(), (std::size_t)points, WF.data(), WR.data());
+            }));
+            // One query at a time, as a controller loop calls it
+            results.push_back(Measure("points/lut-scalar", points, bytes, opt, [&] {
+                for (long long k = 0; k < points; ++k)
+                    std::tie(WF[k], WR[k]) = lut.Query(th[k], a[k]);
+            }));
+        }
+        results.push_back(Measure("points/nominal-scalar", points, bytes, opt, [&] {
+            for (long long k = 0; k < points; ++k)
+                std::tie(WF[k], WR[k]) = CalculateNominalAxleLoads(vp, th[k], a[k]);
+        }));
+        // Query server round: small requests over 4 vehicles through the batcher vs a bare loop
+        for (const int perRequest : {1, 8}) {
+            const int fleetSize = 4;
+            const int requests = (int)std::min<long long>(4096, points / perRequest);
+            std::vector<AxleQueryJob> jobs;
+            for (int r = 0; r < requests; ++r) {
+                const std::size_t at = (std::size_t)r * perRequest;
+                VehicleParams q = vp;
+                q.m += 25.0 * (r % fleetSize);
+                jobs.push_back({q, th.data() + at, a.data() + at, (std::size_t)perRequest, WF.data() + at, WR.data() + at});
+            }
+            const long long items = (long long)requests * perRequest;
+            const std::string shape = std::to_string(requests) + "x" + std::to_string(perRequest);
+            AxleQueryBatcher batcher(&pool);
+            results.push_back(Measure("query/round/" + shape, items, (double)items * 4 * sizeof(double), opt, [&] {
+                batcher.Evaluate(jobs);
+            }));
+            results.push_back(Measure("query/per-request/" + shape, items, (double)items * 4 * sizeof(double), opt, [&] {
+                for (const AxleQueryJob& j : jobs) CalculateAxleLoadsBatch(j.vp, j.theta, j.accel, j.n, j.WF, j.WR);
+            }));
+        }
+    }
+
+    // Brake bias: ideal-share reduction over the grid plus the 3-knot curve search (items = cells)
+    {
+        const int rows = 1000, cols = 1000;
+        const long long cells = (long long)rows * cols;
+        AxleData data;
+        CalculateAxleLoadsParallel(data, vp, -0.3, 0.3, rows, -10.0, 10.0, cols, pool);
+        BrakeBiasOptions bo;
+        bo.pool = &pool;
+        BrakeBiasResult bias;
+        results.push_back(Measure("bias/optimize/1000x1000", cells, (double)cells * 2 * sizeof(double), opt, [&] {
+            OptimizeBrakeBias(data, bo, bias);
+        }));
+    }
+
+    if (!jsonPath.empty()) {
+        if (!WriteJson(jsonPath, results, pool.Size())) {
+            std::cerr << "Cannot write " << jsonPath << std::endl;
+            return 1;
+        }
+        std::printf("wrote %s\n", jsonPath.c_str());
+    }
+
+    // Regression check against a stored baseline
+    if (!baselinePath.empty()) {
+        std::map<std::string, double> base;
+        if (!ReadBaseline(baselinePath, base)) {
+            std::cerr << "Cannot read " << baselinePath << std::endl;
+            return 1;
+        }
+        int regressions = 0;
+        std::printf("\n%-40s %12s %12s %8s\n", "vs baseline", "base ns", "now ns", "change");
+        for (const BenchResult& r : results) {
+            auto it = base.find(r.name);
+            if (it == base.end() || it->second <= 0.0) continue;
+            const double change = r.nsPerItem / it->second - 1.0;
+            const bool bad = change > tolerance;
+            regressions += bad;
+            std::printf("%-40s %12.3f %12.3f %+7.1f%%%s\n", r.name.c_str(), it->second, r.nsPerItem,
+                        change * 100.0, bad ? "  REGRESSION" : "");
+        }
+        if (regressions) {
+            std::printf("%d regression(s) beyond %.0f%%\n", regressions, tolerance * 100.0);
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,242 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "axleLut.hpp"
+#include "driveLog.hpp"
+#include "mappedFile.hpp"
+#include "threadPool.hpp"
+
+/********************
+Program    - Axle Load Model - Drive Log Streaming
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Mapped binary / block-read CSV input, wave-parallel evaluation
+        - Version 1   - Optional lookup-table evaluation
+********************/
+
+// One task's worth of samples
+struct DriveLogChunk {
+    std::size_t n = 0;
+    std::vector<double> t, theta, accel, WF, WR;
+    std::string out;  // encoded output for this chunk
+
+    void Reserve(std::size_t cap) {
+        t.resize(cap); theta.resize(cap); accel.resize(cap);
+        WF.resize(cap); WR.resize(cap);
+    }
+};
+
+// Evaluate a filled chunk and encode it for output
+static void EvaluateChunk(const VehicleParams& vp, const DriveLogOptions& opts, DriveLogChunk& c) {
+    const DriveLogFormat fmt = opts.outFormat;
+    if (opts.lut)
+        opts.lut->Query(c.theta.data(), c.accel.data(), c.n, c.WF.data(), c.WR.data());
+    else
+        CalculateAxleLoadsBatch(vp, c.theta.data(), c.accel.data(), c.n, c.WF.data(), c.WR.data());
+
+    if (fmt == DriveLogFormat::Bin) {
+        c.out.resize(c.n * 3 * sizeof(double));
+        char* p = &c.out[0];
+        for (std::size_t k = 0; k < c.n; ++k) {
+            const double rec[3] = {c.t[k], c.WF[k], c.WR[k]};
+            std::memcpy(p, rec, sizeof(rec));
+            p += sizeof(rec);
+        }
+        return;
+    }
+
+    // CSV - to_chars is locale-free and several times faster than printf
+    c.out.resize(c.n * 72);
+    char* p = &c.out[0];
+    char* end = p + c.out.size();
+    for (std::size_t k = 0; k < c.n; ++k) {
+        p = std::to_chars(p, end, c.t[k]).ptr;   *p++ = ',';
+        p = std::to_chars(p, end, c.WF[k], std::chars_format::general, 10).ptr; *p++ = ',';
+        p = std::to_chars(p, end, c.WR[k], std::chars_format::general, 10).ptr; *p++ = '\n';
+    }
+    c.out.resize(p - c.out.data());
+}
+
+static bool WriteHeader(FILE* f, const char magic[4], std::uint64_t count) {
+    DriveLogHeader h;
+    std::memcpy(h.magic, magic, 4);
+    h.version = kDriveLogVersion;
+    h.count = count;
+    return std::fwrite(&h, sizeof(h), 1, f) == 1;
+}
+
+// Parse one 't,theta,accel' line; false for headers/blank/malformed lines
+static bool ParseCsvSample(const char* b, const char* e, double& t, double& th, double& a) {
+    auto skip = [&](const char* p) { while (p < e && (*p == ' ' || *p == '\t')) ++p; return p; };
+    const char* p = skip(b);
+    auto r = std::from_chars(p, e, t);
+    if (r.ec != std::errc()) return false;
+    p = skip(r.ptr); if (p >= e || *p != ',') return false;
+    r = std::from_chars(skip(p + 1), e, th);
+    if (r.ec != std::errc()) return false;
+    p = skip(r.ptr); if (p >= e || *p != ',') return false;
+    r = std::from_chars(skip(p + 1), e, a);
+    return r.ec == std::errc();
+}
+
+bool ProcessDriveLog(const std::string& inPath, const std::string& outPath,
+                     const VehicleParams& vp, const DriveLogOptions& opts, DriveLogStats& stats) {
+    const auto t0 = std::chrono::steady_clock::now();
+    ThreadPool& pool = opts.pool ? *opts.pool : DefaultThreadPool();
+    const std::size_t chunk = (std::size_t)std::max(1024, opts.chunkSamples);
+    const int wave = pool.Size();
+    static const char kOutMagic[4] = {'A', 'X', 'D', 'O'};
+
+    stats = DriveLogStats{};
+    std::vector<DriveLogChunk> chunks(wave);
+    for (auto& c : chunks) c.Reserve(chunk);
+
+    FILE* out = std::fopen(outPath.c_str(), "wb");
+    if (!out) {
+        std::cerr << "Cannot write " << outPath << std::endl;
+        return false;
+    }
+    std::setvbuf(out, nullptr, _IOFBF, 1 << 20);
+    bool ok = true;
+
+    // Write a finished wave in input order
+    auto flushWave = [&](int used) {
+        for (int k = 0; k < used && ok; ++k)
+            ok = std::fwrite(chunks[k].out.data(), 1, chunks[k].out.size(), out) == chunks[k].out.size();
+    };
+
+    MappedFile map;
+    const bool isBinary = map.Open(inPath) && map.Size() >= sizeof(DriveLogHeader)
+                       && std::memcmp(map.Data(), "AXDL", 4) == 0;
+
+    if (isBinary) {
+        DriveLogHeader h;
+        std::memcpy(&h, map.Data(), sizeof(h));
+        const std::uint64_t avail = (map.Size() - sizeof(h)) / (3 * sizeof(double));
+        if (h.version != kDriveLogVersion || h.count > avail) {
+            std::cerr << inPath << ": unsupported version or truncated log" << std::endl;
+            std::fclose(out);
+            return false;
+        }
+        map.AdviseSequential();
+        const char* records = map.Data() + sizeof(h);
+
+        if (opts.outFormat == DriveLogFormat::Bin) ok = WriteHeader(out, kOutMagic, h.count);
+        else ok = std::fputs("t,WF,WR\n", out) >= 0;
+
+        // Each wave: one chunk per participant, de-interleaved, evaluated and encoded in parallel
+        for (std::uint64_t base = 0; base < h.count && ok; base += (std::uint64_t)wave * chunk) {
+            int used = 0;
+            for (int k = 0; k < wave; ++k) {
+                const std::uint64_t b = base + (std::uint64_t)k * chunk;
+                chunks[k].n = b < h.count ? (std::size_t)std::min<std::uint64_t>(chunk, h.count - b) : 0;
+                if (chunks[k].n) used = k + 1;
+            }
+            pool.ParallelFor(used, [&](int k, int) {
+                DriveLogChunk& c = chunks[k];
+                const char* src = records + (base + (std::uint64_t)k * chunk) * 3 * sizeof(double);
+                for (std::size_t s = 0; s < c.n; ++s) {
+                    double rec[3];
+                    std::memcpy(rec, src + s * sizeof(rec), sizeof(rec));
+                    c.t[s] = rec[0]; c.theta[s] = rec[1]; c.accel[s] = rec[2];
+                }
+                EvaluateChunk(vp, opts, c);
+            });
+            flushWave(used);
+            stats.samples += std::min<std::uint64_t>((std::uint64_t)wave * chunk, h.count - base);
+        }
+    } else {
+        map.Close();
+        FILE* in = std::fopen(inPath.c_str(), "rb");
+        if (!in) {
+            std::cerr << "Cannot open " << inPath << std::endl;
+            std::fclose(out);
+            return false;
+        }
+        if (opts.outFormat == DriveLogFormat::Bin) ok = WriteHeader(out, kOutMagic, 0); // patched below
+        else ok = std::fputs("t,WF,WR\n", out) >= 0;
+
+        // Parse serially into the wave's chunks, evaluate + encode in parallel
+        std::vector<char> buf(4 << 20);
+        std::size_t have = 0;
+        bool eof = false;
+        int k = 0;
+        for (auto& c : chunks) c.n = 0;
+        auto runWave = [&] {
+            const int used = chunks[k].n ? k + 1 : k;
+            pool.ParallelFor(used, [&](int i, int) { EvaluateChunk(vp, opts, chunks[i]); });
+            flushWave(used);
+            for (int i = 0; i < used; ++i) { stats.samples += chunks[i].n; chunks[i].n = 0; }
+            k = 0;
+        };
+        while (ok && !eof) {
+            if (have == buf.size()) {
+                std::cerr << inPath << ": line longer than read buffer" << std::endl;
+                ok = false;
+                break;
+            }
+            const std::size_t got = std::fread(buf.data() + have, 1, buf.size() - have, in);
+            eof = got == 0;
+            have += got;
+            const char* p = buf.data();
+            const char* end = buf.data() + have;
+            for (;;) {
+                const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+                if (!nl && !eof) break;        // partial line, wait for more input
+                const char* le = nl ? nl : end;
+                if (le == p && !nl) break;
+                DriveLogChunk& c = chunks[k];
+                if (ParseCsvSample(p, le, c.t[c.n], c.theta[c.n], c.accel[c.n]) && ++c.n == chunk) {
+                    if (++k == wave) runWave();
+                }
+                if (!nl) { p = end; break; }
+                p = nl + 1;
+            }
+            have = end - p;
+            std::memmove(buf.data(), p, have);
+        }
+        if (ok && (k > 0 || chunks[0].n > 0)) runWave();
+        std::fclose(in);
+
+        if (ok && opts.outFormat == DriveLogFormat::Bin) {
+            ok = std::fseek(out, 0, SEEK_SET) == 0 && WriteHeader(out, kOutMagic, stats.samples);
+        }
+    }
+
+    if (std::fclose(out) != 0) ok = false;
+    if (!ok) std::cerr << "Write failed: " << outPath << std::endl;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return ok;
+}
+
+bool WriteSyntheticDriveLog(const std::string& path, std::uint64_t samples, double rateHz) {
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        std::cerr << "Cannot write " << path << std::endl;
+        return false;
+    }
+    static const char kMagic[4] = {'A', 'X', 'D', 'L'};
+    bool ok = WriteHeader(f, kMagic, samples);
+    const double kPi = 3.14159265358979323846;
+    std::vector<double> block;
+    block.reserve(3 * 8192);
+    for (std::uint64_t k = 0; k < samples && ok; ) {
+        block.clear();
+        for (int s = 0; s < 8192 && k < samples; ++s, ++k) {
+            const double t = (double)k / rateHz;
+            block.push_back(t);
+            block.push_back(0.08 * std::sin(2.0 * kPi * t / 300.0));  // rolling hills
+            block.push_back(4.0 * std::sin(2.0 * kPi * t / 20.0));    // accel/brake cycles
+        }
+        ok = std::fwrite(block.data(), sizeof(double), block.size(), f) == block.size();
+    }
+    if (std::fclose(f) != 0) ok = false;
+    return ok;
+}
@@ -0,0 +1,58 @@
+/********************
+Program    - Axle Load Model - Drive Log Streaming
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Chunked, parallel per-sample axle loads for recorded drive logs
+        - Version 1   - Lookup-table evaluation option
+********************/
+
+#ifndef DRIVE_LOG_H
+#define DRIVE_LOG_H
+
+#include <cstdint>
+#include <string>
+#include "axleLoads.hpp"
+
+// Binary drive log (little-endian):
+//   'AXDL' u32 version, u64 count, then count records of f64 {t, theta, accel}
+// Binary result:
+//   'AXDO' u32 version, u64 count, then count records of f64 {t, WF, WR}
+// CSV input is 't,theta,accel' per line (lines that do not parse, e.g. a header, are skipped);
+// CSV output is 't,WF,WR' per line.
+struct DriveLogHeader {
+    char          magic[4];
+    std::uint32_t version;
+    std::uint64_t count;
+};
+
+const std::uint32_t kDriveLogVersion = 1;
+
+enum class DriveLogFormat { Bin, Csv };
+
+class ThreadPool;
+class AxleLoadLut;
+
+struct DriveLogOptions {
+    DriveLogFormat outFormat = DriveLogFormat::Bin;
+    int chunkSamples = 1 << 16;  // samples per task; memory ~ pool size x chunk x 80 B
+    ThreadPool* pool = nullptr;  // nullptr -> DefaultThreadPool()
+    const AxleLoadLut* lut = nullptr; // evaluate through this table instead of the model (vp unused)
+};
+
+struct DriveLogStats {
+    std::uint64_t samples = 0;
+    double seconds = 0.0;        // wall time for the whole pass
+};
+
+// Stream inPath (binary log, memory-mapped, or CSV read in blocks) to outPath.
+// Samples are evaluated in parallel chunks and written in input order with bounded memory.
+// Returns false and prints the reason to std::cerr on any I/O or format error.
+bool ProcessDriveLog(const std::string& inPath, const std::string& outPath,
+                     const VehicleParams& vp, const DriveLogOptions& opts, DriveLogStats& stats);
+
+// Write a synthetic binary log (slow slope undulation + braking/acceleration cycles)
+bool WriteSyntheticDriveLog(const std::string& path, std::uint64_t samples, double rateHz);
+
+#endif // DRIVE_LOG_H
@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <chrono>
+#include "frameScheduler.hpp"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+/********************
+Program    - Axle Load Model - Frame Scheduling
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Pending-frame counter + per-frame refresh deadline, getrusage / GetProcessTimes meter
+********************/
+
+void FrameScheduler::RequestFrames(int n) {
+    int cur = pending_.load(std::memory_order_relaxed);
+    while (cur < n && !pending_.compare_exchange_weak(cur, n, std::memory_order_relaxed)) {}
+}
+
+void FrameScheduler::RequestRefresh(double seconds) {
+    seconds = std::max(0.0, seconds);
+    refresh_ = refresh_ < 0.0 ? seconds : std::min(refresh_, seconds);
+}
+
+double FrameScheduler::WaitTimeout(double idleSeconds) {
+    const double refresh = refresh_;
+    refresh_ = -1.0;
+    if (!eventDriven_ || pending_.load(std::memory_order_relaxed) > 0) return 0.0;
+    return refresh < 0.0 ? idleSeconds : std::min(refresh, idleSeconds);
+}
+
+void FrameScheduler::FrameDrawn() {
+    ++frames_;
+    int cur = pending_.load(std::memory_order_relaxed);
+    while (cur > 0 && !pending_.compare_exchange_weak(cur, cur - 1, std::memory_order_relaxed)) {}
+}
+
+double ProcessCpuSeconds() {
+#if defined(_WIN32)
+    FILETIME created, exited, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user)) return -1.0;
+    auto seconds = [](const FILETIME& t) {
+        return (double)(((unsigned long long)t.dwHighDateTime << 32) | t.dwLowDateTime) * 1e-7;
+    };
+    return seconds(kernel) + seconds(user);
+#else
+    rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) return -1.0;
+    return (double)ru.ru_utime.tv_sec + 1e-6 * (double)ru.ru_utime.tv_usec +
+           (double)ru.ru_stime.tv_sec + 1e-6 * (double)ru.ru_stime.tv_usec;
+#endif
+}
+
+bool ProcessCpuMeter::Sample() {
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    if (lastWall_ < 0.0) {
+        lastWall_ = wall;
+        lastCpu_ = ProcessCpuSeconds();
+        frames_ = 0;
+        return false;
+    }
+    const double dt = wall - lastWall_;
+    if (dt < window_) return false;
+    const double cpu = ProcessCpuSeconds();
+    percent_ = cpu >= 0.0 && lastCpu_ >= 0.0 ? 100.0 * (cpu - lastCpu_) / dt : 0.0;
+    fps_ = (double)frames_ / dt;
+    lastWall_ = wall;
+    lastCpu_ = cpu;
+    frames_ = 0;
+    return true;
+}
@@ -0,0 +1,72 @@
+/********************
+Program    - Axle Load Model - Frame Scheduling
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Dirty-flag frame scheduler for an event-driven UI loop, process CPU meter
+********************/
+
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include <atomic>
+#include <cstdint>
+
+// Decides when the UI loop draws. Nothing is redrawn unless something raised a dirty flag:
+// RequestFrames() for discrete changes (input events, edited parameters, a finished result),
+// RequestRefresh() for things that animate while they last (progress bar, text caret).
+// The loop asks WaitTimeout() how long it may block in glfwWaitEventsTimeout before drawing;
+// anything that raises a flag from another thread must also wake the loop (glfwPostEmptyEvent).
+// With event-driven scheduling off every call returns 0, i.e. draw every vsync as before.
+class FrameScheduler {
+public:
+    // Frames to draw after an event: ImGui layout lags input by a frame, popups by two
+    static const int kSettleFrames = 3;
+
+    void SetEventDriven(bool on) { eventDriven_ = on; }
+    bool EventDriven() const { return eventDriven_; }
+
+    // Draw at least the next n frames (thread-safe)
+    void RequestFrames(int n = kSettleFrames);
+    // Draw again within `seconds`; holds for the frame being built only (UI thread)
+    void RequestRefresh(double seconds);
+
+    // Seconds the loop may wait for events before the next frame, 0 = draw now. idleSeconds caps
+    // the wait when nothing is pending, so periodic readouts still update. Resets the refresh
+    // request, so call once per loop iteration (UI thread).
+    double WaitTimeout(double idleSeconds);
+    // Call once per drawn frame (UI thread)
+    void FrameDrawn();
+    std::uint64_t FramesDrawn() const { return frames_; }
+
+private:
+    std::atomic<int> pending_{kSettleFrames};
+    double refresh_ = -1.0;                   // < 0: no animation this frame
+    bool eventDriven_ = true;
+    std::uint64_t frames_ = 0;
+};
+
+// CPU time used by this process (all threads) as a share of one core, over a sliding window of
+// at least windowSeconds; Sample() is cheap and meant to be called every frame.
+class ProcessCpuMeter {
+public:
+    explicit ProcessCpuMeter(double windowSeconds = 1.0) : window_(windowSeconds) {}
+    // Returns true when a new figure was computed
+    bool Sample();
+    double Percent() const { return percent_; }   // 100 = one core fully busy
+    double FramesPerSecond() const { return fps_; }
+    // Count one drawn frame towards FramesPerSecond()
+    void CountFrame() { ++frames_; }
+
+private:
+    double window_;
+    double lastWall_ = -1.0, lastCpu_ = 0.0;
+    double percent_ = 0.0, fps_ = 0.0;
+    std::uint64_t frames_ = 0;
+};
+
+// User + system CPU seconds consumed by this process so far, -1 if unavailable
+double ProcessCpuSeconds();
+
+#endif // FRAME_SCHEDULER_H
@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "axleLoads.hpp"
+#include "axleQuery.hpp"
+
+/********************
+Program    - Axle Load Modelling for Brake Redistribution
+Maintainer - C.Holmes
+File       - Query Server Load Generator
+Version    - 0
+    - Release Notes:
+        - Version 0   - Closed-loop load generator for WheelLoadServer
+            -- build -> ✅
+            -- run   -> ./WheelLoadLoadgen [--socket /tmp/wheelload.sock] [-c 8] [--points 64] [--seconds 5]
+********************/
+
+static void PrintUsage() {
+    std::cerr <<
+        "Usage: WheelLoadLoadgen [--socket path] [-c connections] [--points n] [--seconds s]\n"
+        "                        [--pipeline depth] [--vehicles v] [--verify]\n"
+        "  Each connection runs on its own thread and keeps <depth> requests of <points> random\n"
+        "  (theta, accel) samples in flight. Requests cycle through <v> vehicle variants.\n"
+        "  --verify checks every reply against CalculateNominalAxleLoads.\n";
+}
+
+struct LoadOptions {
+    std::string path = "/tmp/wheelload.sock";
+    int connections = 8;
+    int points = 64;
+    double seconds = 5.0;
+    int pipeline = 1;
+    int vehicles = 1;
+    bool verify = false;
+};
+
+struct ClientResult {
+    std::uint64_t requests = 0, samples = 0, batchRequests = 0, mismatches = 0, failures = 0;
+    LatencyHistogram client;      // send -> reply read
+    LatencyHistogram server;      // as reported by the server
+    std::string error;
+};
+
+static int Connect(const std::string& path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) return -1;
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    if (connect(fd, (const sockaddr*)&addr, sizeof(addr)) != 0) { close(fd); return -1; }
+    return fd;
+}
+
+static bool WriteAll(int fd, const char* p, std::size_t n) {
+    while (n > 0) {
+        const ssize_t w = write(fd, p, n);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return false;
+        p += w; n -= (std::size_t)w;
+    }
+    return true;
+}
+
+static bool ReadAll(int fd, char* p, std::size_t n) {
+    while (n > 0) {
+        const ssize_t r = read(fd, p, n);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        p += r; n -= (std::size_t)r;
+    }
+    return true;
+}
+
+static VehicleParams Variant(int v) {
+    // The GUI's default vehicle, mass and CoG height nudged per variant
+    return VehicleParams{1475.0 + 25.0 * v, 0.55 + 0.005 * v, 2.636, 1.0544, 1.5816};
+}
+
+static void RunClient(const LoadOptions& opt, int index, ClientResult& res) {
+    using Clock = std::chrono::steady_clock;
+    const int fd = Connect(opt.path);
+    if (fd < 0) { res.error = "cannot connect to " + opt.path + ": " + std::strerror(errno); return; }
+
+    std::mt19937_64 rng(0x5EED + (std::uint64_t)index);
+    std::uniform_real_distribution<double> slope(-0.35, 0.35), decel(-12.0, 4.0);
+    const std::uint32_t n = (std::uint32_t)opt.points;
+    std::vector<char> request(QueryBytes(n)), reply(ReplyBytes(n));
+    std::vector<double> theta(n), accel(n);
+
+    struct InFlight { std::uint64_t id; int vehicle; Clock::time_point sent; std::vector<double> theta, accel; };
+    std::deque<InFlight> inFlight;
+    std::uint64_t nextId = (std::uint64_t)index << 40;
+    const Clock::time_point stopAt = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                         std::chrono::duration<double>(opt.seconds));
+
+    auto send = [&]() {
+        const int v = (int)(nextId % (std::uint64_t)opt.vehicles);
+        for (std::uint32_t k = 0; k < n; ++k) { theta[k] = slope(rng); accel[k] = decel(rng); }
+        AxleQueryHeader h;
+        MakeQueryHeader(h, nextId, n, Variant(v));
+        std::memcpy(request.data(), &h, sizeof(h));
+        std::memcpy(request.data() + sizeof(h), theta.data(), n * sizeof(double));
+        std::memcpy(request.data() + sizeof(h) + n * sizeof(double), accel.data(), n * sizeof(double));
+        InFlight f{nextId++, v, Clock::now(), {}, {}};
+        if (opt.verify) { f.theta = theta; f.accel = accel; }
+        inFlight.push_back(std::move(f));
+        return WriteAll(fd, request.data(), request.size());
+    };
+
+    bool ok = true;
+    for (int k = 0; k < opt.pipeline && ok; ++k) ok = send();
+    while (ok && !inFlight.empty()) {
+        AxleReplyHeader r;
+        if (!ReadAll(fd, (char*)&r, sizeof(r))) { res.error = "server closed the connection"; break; }
+        const Clock::time_point now = Clock::now();
+        InFlight f = std::move(inFlight.front());
+        inFlight.pop_front();
+        if (!IsReplyHeader(r) || r.id != f.id) { res.error = "reply out of order or malformed"; break; }
+        if (r.status != (std::uint32_t)AxleQueryStatus::Ok || r.count != n) {
+            ++res.failures;
+            if (r.count != 0) { res.error = "unexpected reply size"; break; }
+        } else {
+            if (!ReadAll(fd, reply.data() + sizeof(r), 16u * (std::size_t)n)) { res.error = "truncated reply"; break; }
+            if (opt.verify) {
+                const double* WF = (const double*)(reply.data() + sizeof(r));
+                const double* WR = WF + n;
+                const VehicleParams vp = Variant(f.vehicle);
+                for (std::uint32_t k = 0; k < n; ++k) {
+                    const std::pair<double, double> e = CalculateNominalAxleLoads(vp, f.theta[k], f.accel[k]);
+                    const double tol = 1e-9 * (std::fabs(e.first) + std::fabs(e.second));
+                    if (!(std::fabs(WF[k] - e.first) <= tol && std::fabs(WR[k] - e.second) <= tol)) ++res.mismatches;
+                }
+            }
+        }
+        ++res.requests;
+        res.samples += r.count;
+        res.batchRequests += r.batchRequests;
+        res.client.Record((std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now - f.sent).count());
+        res.server.Record((std::uint64_t)r.serverMicros * 1000);
+        if (now < stopAt) ok = send();
+    }
+    close(fd);
+}
+
+int main(int argc, char** argv) {
+    LoadOptions opt;
+    for (int k = 1; k < argc; ++k) {
+        const std::string arg = argv[k];
+        if (arg == "--socket" && k + 1 < argc) opt.path = argv[++k];
+        else if (arg == "-c" && k + 1 < argc) opt.connections = std::max(1, std::atoi(argv[++k]));
+        else if (arg == "--points" && k + 1 < argc) opt.points = std::atoi(argv[++k]);
+        else if (arg == "--seconds" && k + 1 < argc) opt.seconds = std::atof(argv[++k]);
+        else if (arg == "--pipeline" && k + 1 < argc) opt.pipeline = std::max(1, std::atoi(argv[++k]));
+        else if (arg == "--vehicles" && k + 1 < argc) opt.vehicles = std::max(1, std::atoi(argv[++k]));
+        else if (arg == "--verify") opt.verify = true;
+        else if (arg == "-h" || arg == "--help") { PrintUsage(); return 0; }
+        else { PrintUsage(); return 2; }
+    }
+    if (opt.points < 1 || (std::uint32_t)opt.points > kAxleQueryMaxCount) {
+        std::cerr << "--points must be in [1, " << kAxleQueryMaxCount << "]" << std::endl;
+        return 2;
+    }
+
+    std::vector<ClientResult> results(opt.connections);
+    std::vector<std::thread> threads;
+    const auto start = std::chrono::steady_clock::now();
+    for (int c = 0; c < opt.connections; ++c)
+        threads.emplace_back(RunClient, std::cref(opt), c, std::ref(results[c]));
+    for (std::thread& t : threads) t.join();
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    ClientResult total;
+    bool failed = false;
+    for (const ClientResult& r : results) {
+        total.requests += r.requests; total.samples += r.samples; total.batchRequests += r.batchRequests;
+        total.mismatches += r.mismatches; total.failures += r.failures;
+        total.client.Merge(r.client); total.server.Merge(r.server);
+        if (!r.error.empty()) { std::cerr << "error: " << r.error << std::endl; failed = true; }
+    }
+
+    std::printf("%d connections x pipeline %d, %d points/request, %d vehicle(s), %.2f s\n",
+                opt.connections, opt.pipeline, opt.points, opt.vehicles, elapsed);
+    std::printf("throughput    %.0f req/s, %.3g samples/s\n", total.requests / elapsed, total.samples / elapsed);
+    std::printf("client (us)   p50 %.1f  p90 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n",
+                total.client.PercentileNs(0.50) / 1e3, total.client.PercentileNs(0.90) / 1e3,
+                total.client.PercentileNs(0.99) / 1e3, total.client.PercentileNs(0.999) / 1e3,
+                total.client.MaxNs() / 1e3);
+    std::printf("server (us)   p50 %.0f  p99 %.0f  p99.9 %.0f\n",
+                total.server.PercentileNs(0.50) / 1e3, total.server.PercentileNs(0.99) / 1e3,
+                total.server.PercentileNs(0.999) / 1e3);
+    std::printf("coalescing    %.1f requests per server round (mean over replies)\n",
+                total.requests ? (double)total.batchRequests / total.requests : 0.0);
+    if (total.failures) std::printf("rejected      %llu requests\n", (unsigned long long)total.failures);
+    if (opt.verify) std::printf("verify        %llu mismatching samples\n", (unsigned long long)total.mismatches);
+    return failed || total.mismatches || total.failures ? 1 : 0;
+}
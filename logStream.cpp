@@ -0,0 +1,106 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "axleKernel.hpp"
+#include "axleLut.hpp"
+#include "driveLog.hpp"
+#include "threadPool.hpp"
+
+/********************
+Program    - Axle Load Modelling for Brake Redistribution
+Maintainer - C.Holmes
+File       - Headless Drive Log Program
+Version    - 0
+    - Release Notes:
+        - Version 0   - Per-sample axle loads for recorded drive logs
+            -- build -> ✅
+            -- run   -> ./WheelLoadLog drive.bin loads.bin [--format bin|csv] [-j threads]
+        - Version 1   - Feed-forward lookup tables (--make-lut, --lut)
+********************/
+
+static void PrintUsage() {
+    std::cerr <<
+        "Usage: WheelLoadLog <in.bin|in.csv> <out> [--format bin|csv] [-j threads]\n"
+        "                    [--chunk samples] [--vehicle m h L lf lr]\n"
+        "                    [--lut table.axlt]\n"
+        "       WheelLoadLog --make-test-log <out.bin> <samples> [rateHz]\n"
+        "       WheelLoadLog --make-lut <out.axlt> [--vehicle m h L lf lr] [--max-error N]\n"
+        "                    [--theta min max] [--accel min max]\n"
+        "  Binary input is 'AXDL' + {t, theta, accel} f64 records (see driveLog.hpp),\n"
+        "  anything else is read as 't,theta,accel' CSV.\n";
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 4 && std::string(argv[1]) == "--make-test-log") {
+        const double rate = argc >= 5 ? std::atof(argv[4]) : 1000.0;
+        const unsigned long long n = std::strtoull(argv[3], nullptr, 10);
+        if (!WriteSyntheticDriveLog(argv[2], n, rate > 0.0 ? rate : 1000.0)) return 1;
+        std::cout << "Wrote " << n << " samples to " << argv[2] << std::endl;
+        return 0;
+    }
+
+    VehicleParams vp{1475.0, 0.55, 2.636, 1.0544, 1.5816};  // m, h, L, CoG Fr, CoG Rr
+    DriveLogOptions opts;
+    std::string inPath, outPath, lutPath, makeLutPath;
+    int threads = 0;
+    // Lookup table envelope and target error
+    double lutThMin = -0.35, lutThMax = 0.35, lutAMin = -12.0, lutAMax = 12.0, lutError = 0.01;
+
+    for (int k = 1; k < argc; ++k) {
+        const std::string arg = argv[k];
+        if (arg == "--format" && k + 1 < argc) {
+            const std::string f = argv[++k];
+            if (f == "bin") opts.outFormat = DriveLogFormat::Bin;
+            else if (f == "csv") opts.outFormat = DriveLogFormat::Csv;
+            else { PrintUsage(); return 2; }
+        }
+        else if ((arg == "-j" || arg == "--threads") && k + 1 < argc) threads = std::atoi(argv[++k]);
+        else if (arg == "--chunk" && k + 1 < argc) opts.chunkSamples = std::atoi(argv[++k]);
+        else if (arg == "--vehicle" && k + 5 < argc) {
+            vp.m  = std::atof(argv[++k]); vp.h  = std::atof(argv[++k]); vp.L = std::atof(argv[++k]);
+            vp.lf = std::atof(argv[++k]); vp.lr = std::atof(argv[++k]);
+        }
+        else if (arg == "--lut" && k + 1 < argc) lutPath = argv[++k];
+        else if (arg == "--make-lut" && k + 1 < argc) makeLutPath = argv[++k];
+        else if (arg == "--max-error" && k + 1 < argc) lutError = std::atof(argv[++k]);
+        else if (arg == "--theta" && k + 2 < argc) { lutThMin = std::atof(argv[++k]); lutThMax = std::atof(argv[++k]); }
+        else if (arg == "--accel" && k + 2 < argc) { lutAMin = std::atof(argv[++k]); lutAMax = std::atof(argv[++k]); }
+        else if (arg == "-h" || arg == "--help") { PrintUsage(); return 0; }
+        else if (inPath.empty() && arg[0] != '-') inPath = arg;
+        else if (outPath.empty() && arg[0] != '-') outPath = arg;
+        else { PrintUsage(); return 2; }
+    }
+
+    if (!makeLutPath.empty()) {
+        AxleLoadLut lut;
+        if (!lut.BuildForError(vp, lutThMin, lutThMax, lutAMin, lutAMax, lutError)) {
+            std::cerr << "Cannot build a lookup table for max error " << lutError << " N" << std::endl;
+            return 1;
+        }
+        if (!lut.Save(makeLutPath)) return 1;
+        std::cout << "Wrote " << makeLutPath << ": " << lut.ThetaNodes() << " x " << lut.AccelNodes()
+                  << " nodes, " << lut.Bytes() << " bytes, error bound " << lut.ErrorBound() << " N" << std::endl;
+        return 0;
+    }
+    if (inPath.empty() || outPath.empty()) { PrintUsage(); return 2; }
+
+    AxleLoadLut lut;
+    if (!lutPath.empty()) {
+        if (!lut.Load(lutPath)) return 1;
+        opts.lut = &lut;
+        std::cout << "Using " << lutPath << " (error bound " << lut.ErrorBound() << " N inside theta ["
+                  << lut.ThetaMin() << ", " << lut.ThetaMax() << "], accel [" << lut.AccelMin() << ", "
+                  << lut.AccelMax() << "])" << std::endl;
+    }
+
+    ThreadPool pool(threads);
+    opts.pool = &pool;
+    DriveLogStats stats;
+    if (!ProcessDriveLog(inPath, outPath, vp, opts, stats)) return 1;
+
+    const double rate = stats.seconds > 0.0 ? stats.samples / stats.seconds : 0.0;
+    std::cout << stats.samples << " samples in " << stats.seconds << " s ("
+              << rate * 60.0 / 1e6 << " M samples/min, " << pool.Size() << " threads, "
+              << AxleKernelName(ActiveAxleKernel()) << ")" << std::endl;
+    return 0;
+}
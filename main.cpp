@@ -3,6 +3,8 @@
 #include <cmath>
 #include <cstdio>
 #include <string>
+#include <algorithm>
+#include <cstdlib>
 
 // ImGui + GLFW
 #include "imgui.h"
@@ -15,6 +17,11 @@
 #include "plots.hpp"
 // Model Includes
 #include "axleLoads.hpp"
+#include "axleGridCache.hpp"
+#include "axlePitch.hpp"
+#include "axleWorker.hpp"
+#include "frameScheduler.hpp"
+#include "profiler.hpp"
 
 /********************
 Program    - Axle Load Modelling for Brake Redistribution
@@ -25,8 +32,38 @@ Version    - 0
         - Version 0   - Program Test Structure
             -- build -> ✅
             -- run   -> ./WheelLoadDistributor
+        - Version 1   - Model evaluation on a background worker, live recompute
+        - Version 2   - Frame profiler (scopes, panel, Chrome trace export)
+        - Version 3   - Monte Carlo payload uncertainty bands
+        - Version 4   - On-disk grid cache (AXLE_CACHE=0 disables)
+        - Version 5   - Braking transient (pitch dynamics) panel
+        - Version 6   - Parameter sensitivity heatmap panel
+        - Version 7   - Load heatmap panel (grid resolution, pyramid, linked cursor)
+        - Version 8   - Vehicle comparison list and overlay plots
+        - Version 9   - Event-driven redraw (wait for input / results), CPU and frame rate readout
+        - Version 10  - Brake bias optimizer panel
+        - Version 11  - Monte Carlo sample count capped at 1e6
+        - Version 12  - Live edits read the grid cache but do not write it
+        - Version 13  - Grid steps capped to what the triple-buffered results can hold
+        - Version 14  - Comparison labels follow the result's variants, not the current list
+        - Version 15  - Worker joined before GLFW teardown
+        - Version 16  - Line and comparison plots from the separable grid; dense grid only when read
+        - Version 17  - Grid steps up to 10000 per axis (idle result buffers release large grids)
 ********************/
 
+// Longest the loop sleeps with nothing to draw; keeps the CPU readout current
+static const double kIdleWakeSeconds = 1.0;
+
+// Grid steps per axis. Only the UI's result and the one being computed hold a large dense grid
+// (WF + WR + heatmap pyramid, 10000^2: ~1.8 GB each); sensitivities add twenty grids per
+// result, so they get a smaller cap (2048^2: ~0.75 GB each)
+static const int kMaxGridSteps = 10000;
+static const int kMaxGridStepsSens = 2048;
+
+// Any input redraws a few frames; the scheduler rides on the window user pointer
+static void RequestUiFrames(GLFWwindow* window) {
+    static_cast<FrameScheduler*>(glfwGetWindowUserPointer(window))->RequestFrames();
+}
 
 int main() {
     // Init GLFW
@@ -56,6 +93,19 @@ int main() {
     glfwMakeContextCurrent(window);
     glfwSwapInterval(1);
 
+    // Redraw only when something changed. Installed before ImGui, which chains to these.
+    FrameScheduler scheduler;
+    glfwSetWindowUserPointer(window, &scheduler);
+    glfwSetCursorPosCallback(window, [](GLFWwindow* w, double, double) { RequestUiFrames(w); });
+    glfwSetMouseButtonCallback(window, [](GLFWwindow* w, int, int, int) { RequestUiFrames(w); });
+    glfwSetScrollCallback(window, [](GLFWwindow* w, double, double) { RequestUiFrames(w); });
+    glfwSetKeyCallback(window, [](GLFWwindow* w, int, int, int, int) { RequestUiFrames(w); });
+    glfwSetCharCallback(window, [](GLFWwindow* w, unsigned int) { RequestUiFrames(w); });
+    glfwSetWindowFocusCallback(window, [](GLFWwindow* w, int) { RequestUiFrames(w); });
+    glfwSetCursorEnterCallback(window, [](GLFWwindow* w, int) { RequestUiFrames(w); });
+    glfwSetFramebufferSizeCallback(window, [](GLFWwindow* w, int, int) { RequestUiFrames(w); });
+    glfwSetWindowRefreshCallback(window, [](GLFWwindow* w) { RequestUiFrames(w); });
+
     // Init ImGui
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
@@ -72,18 +122,50 @@ int main() {
     // Model Function Calls   
     //********************//
     VehicleParams vp{1475.0, 0.55, 2.636, 1.0544, 1.5816};  // m, h, L, CoG Fr, CoG Rr
-    // , 5 slopes, 100 accel points
-    AxleData AxleLoadData = CalculateAxleLoads(vp, -0.3, 0.3, 5, -10.0, 10.0, 100); // vp, thetaMin -0.1, thetaMax 0.1, thetaSteps 5, accelMin -6, accelMax 6, accelSteps 100
     double thetaNom = 0.0;
     double accelNom = 0.0;
     auto [WF0, WR0]  = CalculateNominalAxleLoads(vp, thetaNom, accelNom);
     std::cout << "Nominal Front Load: " << WF0 << " N\n";
     std::cout << "Nominal Rear Load:  " << WR0 << " N\n";
 
+    // Grids already computed for the same inputs are mapped from disk instead of recomputed
+    AxleGridCache gridCache(AxleGridCache::DefaultDirectory());
+    const char* cacheEnv = std::getenv("AXLE_CACHE");
+    const bool useGridCache = !(cacheEnv && *cacheEnv == '0');
 
+    // Model evaluation runs on a background worker; the loop below only swaps in results
+    AxleRecomputeWorker worker;
+    if (useGridCache) worker.SetGridCache(&gridCache);
+    // A finished result wakes the loop from glfwWaitEventsTimeout
+    worker.SetReadyCallback([&scheduler] {
+        scheduler.RequestFrames(1);
+        glfwPostEmptyEvent();
+    });
+    {
+        // , 5 slopes, 100 accel points
+        AxleJob job;
+        job.vp = vp;
+        job.thetaMin = -0.3; job.thetaMax = 0.3; job.thetaSteps = 5;      // vp, thetaMin -0.1, thetaMax 0.1, thetaSteps 5
+        job.accelMin = -10.0; job.accelMax = 10.0; job.accelSteps = 100;  // accelMin -6, accelMax 6, accelSteps 100
+        job.thetaNom = thetaNom; job.accelNom = accelNom;
+        worker.Submit(job);
+    }
 
+    // Frame profiler: off until enabled from the panel or with AXLE_PROFILE=1
+    static bool showProfiler = false;
+    if (const char* env = std::getenv("AXLE_PROFILE"); env && *env && *env != '0') {
+        GlobalProfiler().SetEnabled(true);
+        showProfiler = true;
+    }
+
+    static bool eventDriven = true;
+    ProcessCpuMeter cpuMeter;
     while (!glfwWindowShouldClose(window)) {
-        glfwPollEvents();
+        scheduler.SetEventDriven(eventDriven && !showProfiler);  // profiler wants every vsync
+        const double wait = scheduler.WaitTimeout(kIdleWakeSeconds);
+        if (wait > 0.0) glfwWaitEventsTimeout(wait);
+        else glfwPollEvents();
+        cpuMeter.Sample();
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
@@ -105,19 +187,108 @@ int main() {
         static const double def_ui_L = ui_L;
         static const double def_ui_cogFrPct = ui_cogFrPct;
         static const double def_ui_cogRrPct = ui_cogRrPct;
-        ImGui::SetNextItemWidth(140); ImGui::InputDouble("mass (kg)", &ui_m, 10.0, 100.0, "%.1f");
-        ImGui::SameLine();             ImGui::SetNextItemWidth(140); ImGui::InputDouble("CoG height h (m)", &ui_h, 0.01, 0.1, "%.3f");
-        ImGui::SameLine();             ImGui::SetNextItemWidth(140); ImGui::InputDouble("wheelbase L (m)", &ui_L, 0.01, 0.1, "%.3f");
-        ImGui::SetNextItemWidth(140); ImGui::InputDouble("Front mass (%)", &ui_cogFrPct, 0.5, 5.0, "%.2f");
-        ImGui::SameLine();             ImGui::SetNextItemWidth(140); ImGui::InputDouble("Rear mass (%)",  &ui_cogRrPct, 0.5, 5.0, "%.2f");
+        bool vehicleEdited = false;
+        ImGui::SetNextItemWidth(140); vehicleEdited |= ImGui::InputDouble("mass (kg)", &ui_m, 10.0, 100.0, "%.1f");
+        ImGui::SameLine();             ImGui::SetNextItemWidth(140); vehicleEdited |= ImGui::InputDouble("CoG height h (m)", &ui_h, 0.01, 0.1, "%.3f");
+        ImGui::SameLine();             ImGui::SetNextItemWidth(140); vehicleEdited |= ImGui::InputDouble("wheelbase L (m)", &ui_L, 0.01, 0.1, "%.3f");
+        ImGui::SetNextItemWidth(140); vehicleEdited |= ImGui::InputDouble("Front mass (%)", &ui_cogFrPct, 0.5, 5.0, "%.2f");
+        ImGui::SameLine();             ImGui::SetNextItemWidth(140); vehicleEdited |= ImGui::InputDouble("Rear mass (%)",  &ui_cogRrPct, 0.5, 5.0, "%.2f");
+
+        // Payload uncertainty: mass +- uniform, CoG height normal, CoG position +- uniform
+        static bool mcEnabled = false;
+        static double mcMassSpread = 200.0;  // kg, +-
+        static double mcHeightSd = 0.05;     // m, 1 sigma
+        static double mcCogSpread = 0.05;    // m, +- on lf
+        static int mcSamples = 20000;
+        if (ImGui::CollapsingHeader("Uncertainty (Monte Carlo)")) {
+            vehicleEdited |= ImGui::Checkbox("Envelope bands", &mcEnabled);
+            ImGui::SameLine(); ImGui::SetNextItemWidth(140);
+            vehicleEdited |= ImGui::InputInt("samples", &mcSamples, 1000, 10000);
+            mcSamples = std::clamp(mcSamples, 1, 1000000);  // each sample is a full grid pass
+            ImGui::SetNextItemWidth(140); vehicleEdited |= ImGui::InputDouble("mass +- (kg)", &mcMassSpread, 10.0, 100.0, "%.0f");
+            ImGui::SameLine();             ImGui::SetNextItemWidth(140); vehicleEdited |= ImGui::InputDouble("h sigma (m)", &mcHeightSd, 0.005, 0.05, "%.3f");
+            ImGui::SameLine();             ImGui::SetNextItemWidth(140); vehicleEdited |= ImGui::InputDouble("lf +- (m)", &mcCogSpread, 0.01, 0.1, "%.3f");
+        }
+
+        // Vehicle variants compared side by side (evaluated with every job, only edited ones recomputed)
+        struct VehicleVariant { int id; char name[32]; double m, h, L, frontPct; };
+        static std::vector<VehicleVariant> variants;
+        static int nextVariantId = 0;
+        static bool compareEnabled = false;
+        if (ImGui::CollapsingHeader("Compare vehicles")) {
+            vehicleEdited |= ImGui::Checkbox("Overlay variants", &compareEnabled);
+            ImGui::SameLine();
+            if (ImGui::Button("Add current vehicle")) {
+                VehicleVariant v;
+                v.id = nextVariantId++;
+                std::snprintf(v.name, sizeof(v.name), "Variant %d", (int)variants.size() + 1);
+                v.m = ui_m; v.h = ui_h; v.L = ui_L;
+                const double sum = ui_cogFrPct + ui_cogRrPct;
+                v.frontPct = sum > 0.0 ? 100.0 * ui_cogFrPct / sum : 50.0;
+                variants.push_back(v);
+                vehicleEdited = true;
+            }
+            for (int k = 0; k < (int)variants.size(); ++k) {
+                VehicleVariant& v = variants[k];
+                ImGui::PushID(k);
+                ImGui::SetNextItemWidth(120); ImGui::InputText("##name", v.name, sizeof(v.name));
+                ImGui::SameLine(); ImGui::SetNextItemWidth(110); vehicleEdited |= ImGui::InputDouble("m", &v.m, 10.0, 100.0, "%.1f");
+                ImGui::SameLine(); ImGui::SetNextItemWidth(110); vehicleEdited |= ImGui::InputDouble("h", &v.h, 0.01, 0.1, "%.3f");
+                ImGui::SameLine(); ImGui::SetNextItemWidth(110); vehicleEdited |= ImGui::InputDouble("L", &v.L, 0.01, 0.1, "%.3f");
+                ImGui::SameLine(); ImGui::SetNextItemWidth(110); vehicleEdited |= ImGui::InputDouble("front %", &v.frontPct, 0.5, 5.0, "%.2f");
+                v.frontPct = std::clamp(v.frontPct, 0.0, 100.0);
+                ImGui::SameLine();
+                const bool remove = ImGui::Button("Remove");
+                ImGui::PopID();
+                if (remove) {
+                    variants.erase(variants.begin() + k);
+                    vehicleEdited = true;
+                    break;
+                }
+            }
+        }
         ImGui::Separator();
 
+        // Panels further down (heatmap, sensitivities) change the job too; their edits are
+        // submitted next frame
+        static bool sensEnabled = false;
+        static bool heatmapEnabled = false;
+        static int thetaSteps = 5;
+        static int accelSteps = 100;
+        static bool biasEnabled = false;
+        static BrakeBiasOptions biasOptions;
+        static bool panelEdited = false;
+        const int maxGridSteps = sensEnabled ? kMaxGridStepsSens : kMaxGridSteps;
+        if (thetaSteps > maxGridSteps || accelSteps > maxGridSteps) {
+            thetaSteps = std::min(thetaSteps, maxGridSteps);
+            accelSteps = std::min(accelSteps, maxGridSteps);
+            panelEdited = true;
+        }
+        vehicleEdited |= panelEdited;
+        panelEdited = false;
+
         // Range controls (above plots). Defaults mirror initial computation above.
         static PlotRanges ranges{-0.35, 0.35, -10.0, 10.0};
         static const PlotRanges defaults{-0.35, 0.35, -10.0, 10.0};
-        const int thetaSteps = 5;
-        const int accelSteps = 100;
 
+        // Vehicle params from the UI fields (convert CoG % to distances using L)
+        auto uiParams = [&]() {
+            VehicleParams p;
+            p.m = ui_m;
+            p.h = ui_h;
+            p.L = ui_L;
+            // Convert mass percentages to distances using L
+            double pF = ui_cogFrPct / 100.0;
+            double pR = ui_cogRrPct / 100.0;
+            double sum = pF + pR;
+            if (sum > 0.0) { pF /= sum; pR /= sum; }
+            // Front mass % = lr/L; Rear mass % = lf/L
+            p.lr = pF * p.L;
+            p.lf = pR * p.L;
+            return p;
+        };
+
+        static bool liveRecompute = true;
         if (auto ctrl = RenderRangeControls(ranges, defaults); true) {
             if (ctrl.reset) {
                 // Restore UI vehicle parameters to defaults
@@ -127,43 +298,222 @@ int main() {
                 ui_cogFrPct = def_ui_cogFrPct;
                 ui_cogRrPct = def_ui_cogRrPct;
             }
-            if (ctrl.apply) {
-                // Apply updated vehicle parameters (convert CoG % to distances using L)
-                vp.m = ui_m;
-                vp.h = ui_h;
-                vp.L = ui_L;
-                // Convert mass percentages to distances using L
-                double pF = ui_cogFrPct / 100.0;
-                double pR = ui_cogRrPct / 100.0;
-                double sum = pF + pR;
-                if (sum > 0.0) { pF /= sum; pR /= sum; }
-                // Front mass % = lr/L; Rear mass % = lf/L
-                vp.lr = pF * vp.L;
-                vp.lf = pR * vp.L;
-
-                AxleLoadData = CalculateAxleLoads(
-                    vp,
-                    ranges.thetaMin, ranges.thetaMax, thetaSteps,
-                    ranges.accelMin, ranges.accelMax, accelSteps
-                );
-                // OP remains at (thetaNom, accelNom); recompute loads in case model changed
-                std::tie(WF0, WR0) = CalculateNominalAxleLoads(vp, thetaNom, accelNom);
+            // Apply, or any edit while live recompute is on, queues a new job;
+            // a job still running for older inputs is cancelled by the worker
+            if (vehicleEdited || ctrl.changed || ctrl.reset) scheduler.RequestFrames();
+            if (ctrl.apply || (liveRecompute && (vehicleEdited || ctrl.changed || ctrl.reset))) {
+                AxleJob job;
+                job.vp = uiParams();
+                job.thetaMin = std::min(ranges.thetaMin, ranges.thetaMax);
+                job.thetaMax = std::max(ranges.thetaMin, ranges.thetaMax);
+                job.thetaSteps = thetaSteps;
+                job.accelMin = std::min(ranges.accelMin, ranges.accelMax);
+                job.accelMax = std::max(ranges.accelMin, ranges.accelMax);
+                job.accelSteps = accelSteps;
+                // OP remains at (thetaNom, accelNom); loads recomputed with the grid
+                job.thetaNom = thetaNom;
+                job.accelNom = accelNom;
+                if (mcEnabled) {
+                    job.dist = VehicleDistribution::FromVehicle(job.vp);
+                    job.dist.m  = ParamSpread::Uniform(job.vp.m - std::fabs(mcMassSpread), job.vp.m + std::fabs(mcMassSpread));
+                    job.dist.h  = ParamSpread::Normal(job.vp.h, std::fabs(mcHeightSd));
+                    job.dist.lf = ParamSpread::Uniform(job.vp.lf - std::fabs(mcCogSpread), job.vp.lf + std::fabs(mcCogSpread));
+                    job.envelopeSamples = (std::uint64_t)mcSamples;
+                }
+                job.sensitivities = sensEnabled;
+                job.pyramid = heatmapEnabled;
+                job.brakeBias = biasEnabled;
+                job.biasOptions = biasOptions;
+                if (compareEnabled) {
+                    for (const VehicleVariant& v : variants) {
+                        VehicleParams p;
+                        p.m = v.m; p.h = v.h; p.L = v.L;
+                        // Front mass % = lr/L
+                        p.lr = v.frontPct / 100.0 * v.L;
+                        p.lf = v.L - p.lr;
+                        job.fleet.push_back(p);
+                        job.fleetIds.push_back(v.id);
+                    }
+                }
+                // Intermediate values while typing or dragging would fill the cache; only
+                // Apply (and the initial grid) store
+                job.cacheStore = ctrl.apply;
+                worker.Submit(job);
+            }
+        }
+
+        ImGui::SameLine();
+        ImGui::Checkbox("Recompute as you type", &liveRecompute);
+        ImGui::SameLine();
+        ImGui::Checkbox("Profiler", &showProfiler);
+        ImGui::SameLine();
+        ImGui::Checkbox("Redraw on change only", &eventDriven);
+        ImGui::SameLine();
+        ImGui::TextDisabled("CPU %.1f%%  %.1f fps", cpuMeter.Percent(), cpuMeter.FramesPerSecond());
+        if (worker.Busy()) {
+            ImGui::SameLine();
+            ImGui::ProgressBar(worker.Progress(), ImVec2(160, 0));
+            scheduler.RequestRefresh(1.0 / 30.0);
+        }
+        // Keep the text caret blinking while a field is being edited
+        if (io.WantTextInput) scheduler.RequestRefresh(0.5);
+
+        // Swap in the newest finished result (never blocks); its frame is already requested
+        worker.AcquireLatest();
+        const AxleResult& result = worker.Front();
+        if (result.generation != 0 && result.gridCached && !worker.Busy()) {
+            ImGui::SameLine();
+            ImGui::TextDisabled("(grid from cache)");
+        }
+        vp = result.job.vp;
+        WF0 = result.WF0;
+        WR0 = result.WR0;
+
+        // Whole grid as a heatmap; the cell under the mouse becomes an extra slice in the line plots
+        static int heatField = (int)AxleHeatField::Front;
+        static bool heatMin = false;
+        static GridCursor cursor;
+        if (ImGui::CollapsingHeader("Heatmap")) {
+            panelEdited |= ImGui::Checkbox("Show heatmap", &heatmapEnabled);
+            ImGui::SameLine(); ImGui::SetNextItemWidth(140);
+            ImGui::Combo("field", &heatField, "Front load\0Rear load\0Front share\0");
+            ImGui::SameLine(); ImGui::Checkbox("Min per pixel", &heatMin);
+            ImGui::SetNextItemWidth(140); panelEdited |= ImGui::InputInt("theta steps", &thetaSteps, 100, 1000);
+            ImGui::SameLine(); ImGui::SetNextItemWidth(140); panelEdited |= ImGui::InputInt("accel steps", &accelSteps, 100, 1000);
+            thetaSteps = std::clamp(thetaSteps, 2, maxGridSteps);
+            accelSteps = std::clamp(accelSteps, 2, maxGridSteps);
+            if (heatmapEnabled && result.generation != 0)
+                RenderAxleHeatmap(result.grid, result.pyramid, heatField, !heatMin, cursor);
+        }
+        if (!heatmapEnabled) cursor = GridCursor{};
+
+        // Per-pixel slices from the separable grid; the dense grid is only built for the panels
+        // that read it (heatmap, sensitivities, brake bias)
+        static int plotSlices = 2;
+        ImGui::SetNextItemWidth(140); ImGui::SliderInt("slices", &plotSlices, 2, 16);
+        if (result.generation != 0)
+            RenderAxleLoadPlots(vp, result.sep, thetaNom, accelNom, WF0, WR0, plotSlices, &result.envelope, &cursor);
+
+        // Variants overlaid at the operating point's slope / accel
+        if (compareEnabled && result.generation != 0 && result.fleet.Size() > 0) {
+            // The result may predate the last Add / Remove: label its variants by id, with the
+            // current name (renames show at once) or as removed
+            static std::vector<std::string> names;
+            names.resize(result.job.fleetIds.size());
+            for (size_t k = 0; k < names.size(); ++k) {
+                auto it = std::find_if(variants.begin(), variants.end(),
+                                       [&](const VehicleVariant& v) { return v.id == result.job.fleetIds[k]; });
+                names[k] = it != variants.end() ? std::string(it->name)
+                                                : "(removed)##" + std::to_string(result.job.fleetIds[k]);
+            }
+            ImGui::TextDisabled("%d variants, %d recomputed for this result", result.fleet.Size(), result.fleetRecomputed);
+            RenderFleetPlots(result.fleet, names, &result.sep, thetaNom, accelNom);
+        }
+
+        // Transient loads for a braking event from the operating point (one scenario, microseconds
+        // to integrate, so it simply reruns on the UI thread whenever its inputs change)
+        static double brakeDecel = -8.0;  // m/s^2
+        static double brakeRamp = 0.1;    // s
+        static double rideHzF = 1.3, rideHzR = 1.5, rideZeta = 0.3;
+        static PitchSimData pitchSim;
+        static std::uint64_t pitchForGen = 0;
+        if (ImGui::CollapsingHeader("Braking transient (pitch dynamics)")) {
+            bool pitchEdited = false;
+            ImGui::SetNextItemWidth(140); pitchEdited |= ImGui::InputDouble("decel (m/s^2)", &brakeDecel, 0.5, 2.0, "%.2f");
+            ImGui::SameLine(); ImGui::SetNextItemWidth(140); pitchEdited |= ImGui::InputDouble("ramp (s)", &brakeRamp, 0.02, 0.1, "%.3f");
+            ImGui::SetNextItemWidth(140); pitchEdited |= ImGui::InputDouble("front ride (Hz)", &rideHzF, 0.1, 0.5, "%.2f");
+            ImGui::SameLine(); ImGui::SetNextItemWidth(140); pitchEdited |= ImGui::InputDouble("rear ride (Hz)", &rideHzR, 0.1, 0.5, "%.2f");
+            ImGui::SameLine(); ImGui::SetNextItemWidth(140); pitchEdited |= ImGui::InputDouble("damping ratio", &rideZeta, 0.05, 0.1, "%.2f");
+            brakeRamp = std::max(0.0, brakeRamp);
+            rideHzF = std::max(0.1, rideHzF);
+            rideHzR = std::max(0.1, rideHzR);
+            rideZeta = std::max(0.0, rideZeta);
+            if (result.generation != 0 && (pitchEdited || pitchForGen != result.generation)) {
+                PitchScenario sc;
+                sc.vp = PitchVehicleParams::FromVehicle(vp, rideHzF, rideHzR, rideZeta);
+                sc.event.theta = thetaNom;
+                sc.event.accel0 = accelNom;
+                sc.event.accel1 = brakeDecel;
+                sc.event.tStart = 0.2;
+                sc.event.tRamp = brakeRamp;
+                PitchSimOptions po;
+                po.duration = 2.0;
+                po.outputEvery = 5;
+                SimulatePitchDynamics(pitchSim, {sc}, po);
+                pitchForGen = result.generation;
             }
+            RenderPitchDynamicsPlot(pitchSim);
         }
 
-        RenderAxleLoadPlots(vp, AxleLoadData, thetaNom, accelNom, WF0, WR0);
+        // d(load)/d(parameter) over the grid, from the same pass as the loads
+        static int sensParam = (int)AxleParam::h;
+        static bool sensRear = false;
+        if (ImGui::CollapsingHeader("Sensitivities")) {
+            panelEdited |= ImGui::Checkbox("Compute sensitivities", &sensEnabled);
+            ImGui::SameLine(); ImGui::SetNextItemWidth(140);
+            ImGui::Combo("parameter", &sensParam, "m\0h\0L\0lf\0lr\0CoG shift (lf - lr)\0");
+            ImGui::SameLine(); ImGui::Checkbox("Rear axle", &sensRear);
+            if (sensEnabled) RenderSensitivityHeatmap(result.sens, sensParam, sensRear);
+            if (sensEnabled) ImGui::TextDisabled("Grid steps are limited to %d per axis while sensitivities are on", kMaxGridStepsSens);
+        }
+
+        // Front brake share that keeps lock-up risk lowest over the braking part of the grid
+        if (ImGui::CollapsingHeader("Brake bias")) {
+            panelEdited |= ImGui::Checkbox("Optimize brake bias", &biasEnabled);
+            ImGui::SameLine(); ImGui::SetNextItemWidth(140);
+            panelEdited |= ImGui::InputInt("knots", &biasOptions.knots, 1, 1);
+            biasOptions.knots = std::clamp(biasOptions.knots, 1, 6);
+            ImGui::SameLine(); ImGui::SetNextItemWidth(140);
+            panelEdited |= ImGui::InputDouble("rear-lock weight", &biasOptions.rearWeight, 0.5, 1.0, "%.2f");
+            biasOptions.rearWeight = std::max(1.0, biasOptions.rearWeight);
+            ImGui::SameLine(); ImGui::SetNextItemWidth(140);
+            panelEdited |= ImGui::InputDouble("min decel (m/s^2)", &biasOptions.minDecel, 0.1, 1.0, "%.2f");
+            biasOptions.minDecel = std::max(0.0, biasOptions.minDecel);
+            const BrakeBiasResult& bb = result.brakeBias;
+            if (biasEnabled && bb.generation != 0) {
+                ImGui::Text("Best fixed bias %.1f%% front, risk %.3f", 100.0 * bb.fixedBias, bb.fixedRisk);
+                std::string knots;
+                char buf[48];
+                for (size_t k = 0; k < bb.curve.decel.size(); ++k) {
+                    std::snprintf(buf, sizeof(buf), "%s%.1f m/s^2: %.1f%%", k ? ", " : "",
+                                  bb.curve.decel[k], 100.0 * bb.curve.bias[k]);
+                    knots += buf;
+                }
+                ImGui::Text("Curve %s", knots.c_str());
+                ImGui::Text("Risk %.3f, efficiency %.1f%%, rear locks first in %.1f%% of cells",
+                            bb.risk, 100.0 * bb.efficiency, 100.0 * bb.rearFirstShare);
+                ImGui::TextDisabled("Worst cell theta %.3f rad, accel %.2f m/s^2; %lld curves over %lld braking cells",
+                                    bb.worstTheta, bb.worstAccel, bb.candidates, bb.cells);
+                RenderBrakeBiasPlot(bb);
+            } else if (biasEnabled && result.job.brakeBias) {
+                ImGui::TextDisabled("No braking cells at least min decel in the accel range");
+            }
+        }
         ImGui::End();       
 
+        if (showProfiler) RenderProfilerPanel(&showProfiler);
+
         ImGui::Render();
         int display_w, display_h;
         glfwGetFramebufferSize(window, &display_w, &display_h);
         glViewport(0, 0, display_w, display_h);
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-        glfwSwapBuffers(window);
+        {
+            PROFILE_SCOPE("ImGui_ImplOpenGL3_RenderDrawData");
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
+        {
+            PROFILE_SCOPE("glfwSwapBuffers");
+            glfwSwapBuffers(window);
+        }
+        GlobalProfiler().FrameMark();
+        scheduler.FrameDrawn();
+        cpuMeter.CountFrame();
     }
-    // Cleanup
+    // Cleanup. Join the worker first: its ready callback calls glfwPostEmptyEvent, which must
+    // not run once glfwTerminate has started
+    worker.Stop();
     ImPlot::DestroyContext();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
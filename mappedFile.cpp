@@ -0,0 +1,83 @@
+#include "mappedFile.hpp"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/********************
+Program    - Axle Load Model - Mapped Files
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Read-only memory-mapped file (POSIX mmap / Win32 file mapping)
+        - Version 1   - Copy-on-write mappings (MAP_PRIVATE + PROT_WRITE / FILE_MAP_COPY)
+********************/
+
+#if defined(_WIN32)
+
+bool MappedFile::Open(const std::string& path, bool copyOnWrite) {
+    Close();
+    HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                           OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (f == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(f, &sz) || sz.QuadPart == 0) { CloseHandle(f); return false; }
+    HANDLE m = CreateFileMappingA(f, nullptr, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+    if (!m) { CloseHandle(f); return false; }
+    const void* p = MapViewOfFile(m, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+    if (!p) { CloseHandle(m); CloseHandle(f); return false; }
+    file_ = f;
+    mapping_ = m;
+    data_ = static_cast<const char*>(p);
+    size_ = (std::size_t)sz.QuadPart;
+    writable_ = copyOnWrite;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle((HANDLE)mapping_);
+    if (file_) CloseHandle((HANDLE)file_);
+    data_ = nullptr; mapping_ = nullptr; file_ = nullptr;
+    size_ = 0;
+    writable_ = false;
+}
+
+void MappedFile::AdviseSequential() const {}
+
+#else
+
+bool MappedFile::Open(const std::string& path, bool copyOnWrite) {
+    Close();
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) { ::close(fd); return false; }
+    const int prot = copyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* p = ::mmap(nullptr, (std::size_t)st.st_size, prot, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping keeps the file referenced
+    if (p == MAP_FAILED) return false;
+    data_ = static_cast<const char*>(p);
+    size_ = (std::size_t)st.st_size;
+    writable_ = copyOnWrite;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data_) ::munmap(const_cast<char*>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+    writable_ = false;
+}
+
+void MappedFile::AdviseSequential() const {
+    if (data_) ::madvise(const_cast<char*>(data_), size_, MADV_SEQUENTIAL);
+}
+
+#endif
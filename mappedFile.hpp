@@ -0,0 +1,50 @@
+/********************
+Program    - Axle Load Model - Mapped Files
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Read-only memory-mapped file (POSIX mmap / Win32 file mapping)
+        - Version 1   - Copy-on-write mappings
+********************/
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// View of a whole file mapped into memory.
+// Open() returns false (and leaves the object empty) when the file cannot be mapped.
+// With copyOnWrite the pages are also writable through MutableData(); writes stay
+// private to this mapping and never reach the file.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& path, bool copyOnWrite = false);
+    void Close();
+
+    bool        IsOpen() const { return data_ != nullptr; }
+    const char* Data()   const { return data_; }
+    char*       MutableData() const { return writable_ ? const_cast<char*>(data_) : nullptr; }
+    std::size_t Size()   const { return size_; }
+
+    // Tell the OS the mapping will be read front to back
+    void AdviseSequential() const;
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool writable_ = false;
+#if defined(_WIN32)
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include "plotSeries.hpp"
+
+/********************
+Program    - Axle Load Model - Plot Series Cache
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Cached, LTTB-downsampled slice series for the axle load plots
+        - Version 1   - Cursor slices, cached per (row, col)
+********************/
+
+int DownsampleLTTB(const double* x, const GridView& y, int n, int threshold, double* outX, double* outY) {
+    if (n <= 0) return 0;
+    if (threshold >= n || threshold < 3) {
+        for (int k = 0; k < n; ++k) { outX[k] = x[k]; outY[k] = y[k]; }
+        return n;
+    }
+
+    // Buckets over the interior points; each picks the point forming the largest
+    // triangle with the previous pick and the next bucket's centroid
+    const double every = (double)(n - 2) / (threshold - 2);
+    int a = 0;
+    int out = 0;
+    outX[out] = x[0]; outY[out] = y[0]; ++out;
+
+    for (int b = 0; b < threshold - 2; ++b) {
+        const int avgStart = (int)std::floor((b + 1) * every) + 1;
+        const int avgEnd   = std::min((int)std::floor((b + 2) * every) + 1, n);
+        double avgX = 0.0, avgY = 0.0;
+        for (int k = avgStart; k < avgEnd; ++k) { avgX += x[k]; avgY += y[k]; }
+        const int avgN = avgEnd - avgStart;
+        if (avgN > 0) { avgX /= avgN; avgY /= avgN; }
+        else          { avgX = x[n - 1]; avgY = y[n - 1]; }
+
+        const int rangeStart = (int)std::floor(b * every) + 1;
+        const int rangeEnd   = std::min((int)std::floor((b + 1) * every) + 1, n - 1);
+        const double ax = x[a], ay = y[a];
+        double maxArea = -1.0;
+        int pick = rangeStart;
+        for (int k = rangeStart; k < rangeEnd; ++k) {
+            const double area = std::fabs((ax - avgX) * (y[k] - ay) - (ax - x[k]) * (avgY - ay));
+            if (area > maxArea) { maxArea = area; pick = k; }
+        }
+        outX[out] = x[pick]; outY[out] = y[pick]; ++out;
+        a = pick;
+    }
+
+    outX[out] = x[n - 1]; outY[out] = y[n - 1]; ++out;
+    return out;
+}
+
+void EvenSliceIndices(int n, int count, std::vector<int>& out) {
+    out.clear();
+    if (n <= 0 || count <= 0) return;
+    if (count > n) count = n;
+    if (count == 1) { out.push_back(0); return; }
+    for (int k = 0; k < count; ++k)
+        out.push_back((int)((long long)k * (n - 1) / (count - 1)));
+}
+
+// Fill one series from a strided source, downsampling to the point budget
+static void FillSeries(PlotSeries& s, const double* x, const GridView& y, int n, int maxPoints) {
+    const int cap = std::min(n, std::max(3, maxPoints));
+    if ((int)s.x.size() < cap) { s.x.resize(cap); s.y.resize(cap); }
+    s.count = DownsampleLTTB(x, y, n, cap, s.x.data(), s.y.data());
+}
+
+bool AxlePlotSeriesCache::Update(const AxleData& data, int slices, int maxPoints) {
+    if (data.generation == generation_ && slices == slices_ && maxPoints == maxPoints_)
+        return false;
+    generation_ = data.generation;
+    slices_ = slices;
+    maxPoints_ = maxPoints;
+
+    const int rows = data.WF.Rows();
+    const int cols = data.WF.Cols();
+    if (rows == 0 || cols == 0 || (int)data.theta.size() != rows || (int)data.accel.size() != cols) {
+        vsSlope_.clear();
+        vsAccel_.clear();
+        return true;
+    }
+
+    // vs slope: columns of the grid at evenly spread accel slices
+    EvenSliceIndices(cols, slices, idx_);
+    vsSlope_.resize(2 * idx_.size());
+    for (size_t k = 0; k < idx_.size(); ++k) {
+        const int j = idx_[k];
+        PlotSeries& f = vsSlope_[2 * k];
+        PlotSeries& r = vsSlope_[2 * k + 1];
+        std::snprintf(f.label, sizeof(f.label), "Front Load (a=%.2f)", data.accel[j]);
+        std::snprintf(r.label, sizeof(r.label), "Rear Load (a=%.2f)", data.accel[j]);
+        FillSeries(f, data.theta.data(), data.WF.ColView(j), rows, maxPoints);
+        FillSeries(r, data.theta.data(), data.WR.ColView(j), rows, maxPoints);
+    }
+
+    // vs accel: rows of the grid at evenly spread theta slices
+    EvenSliceIndices(rows, slices, idx_);
+    vsAccel_.resize(2 * idx_.size());
+    for (size_t k = 0; k < idx_.size(); ++k) {
+        const int i = idx_[k];
+        PlotSeries& f = vsAccel_[2 * k];
+        PlotSeries& r = vsAccel_[2 * k + 1];
+        std::snprintf(f.label, sizeof(f.label), "Front Load (theta =%.3f rad)", data.theta[i]);
+        std::snprintf(r.label, sizeof(r.label), "Rear Load (theta =%.3f rad)", data.theta[i]);
+        FillSeries(f, data.accel.data(), data.WF.RowView(i), cols, maxPoints);
+        FillSeries(r, data.accel.data(), data.WR.RowView(i), cols, maxPoints);
+    }
+    return true;
+}
+
+bool AxlePlotSeriesCache::UpdateCursor(const AxleData& data, int row, int col, int maxPoints) {
+    const int rows = data.WF.Rows();
+    const int cols = data.WF.Cols();
+    if (row >= rows || col >= cols || (int)data.theta.size() != rows || (int)data.accel.size() != cols)
+        row = col = -1;
+    if (data.generation == cursorGen_ && row == cursorRow_ && col == cursorCol_ && maxPoints == cursorPoints_)
+        return false;
+    cursorGen_ = data.generation;
+    cursorRow_ = row;
+    cursorCol_ = col;
+    cursorPoints_ = maxPoints;
+    if (row < 0 || col < 0) {
+        cursorSlope_.clear();
+        cursorAccel_.clear();
+        return true;
+    }
+
+    cursorSlope_.resize(2);
+    std::snprintf(cursorSlope_[0].label, sizeof(cursorSlope_[0].label), "Front Load (cursor a=%.2f)", data.accel[col]);
+    std::snprintf(cursorSlope_[1].label, sizeof(cursorSlope_[1].label), "Rear Load (cursor a=%.2f)", data.accel[col]);
+    FillSeries(cursorSlope_[0], data.theta.data(), data.WF.ColView(col), rows, maxPoints);
+    FillSeries(cursorSlope_[1], data.theta.data(), data.WR.ColView(col), rows, maxPoints);
+
+    cursorAccel_.resize(2);
+    std::snprintf(cursorAccel_[0].label, sizeof(cursorAccel_[0].label), "Front Load (cursor theta =%.3f rad)", data.theta[row]);
+    std::snprintf(cursorAccel_[1].label, sizeof(cursorAccel_[1].label), "Rear Load (cursor theta =%.3f rad)", data.theta[row]);
+    FillSeries(cursorAccel_[0], data.accel.data(), data.WF.RowView(row), cols, maxPoints);
+    FillSeries(cursorAccel_[1], data.accel.data(), data.WR.RowView(row), cols, maxPoints);
+    return true;
+}
@@ -0,0 +1,68 @@
+/********************
+Program    - Axle Load Model - Plot Series Cache
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Cached, LTTB-downsampled slice series for the axle load plots
+        - Version 1   - Cursor slices (one grid row + column picked from the heatmap)
+********************/
+
+#ifndef PLOT_SERIES_H
+#define PLOT_SERIES_H
+
+#include <cstdint>
+#include <vector>
+#include "axleGrid.hpp"
+#include "axleLoads.hpp"
+
+// One prepared line: label + x/y points ready to hand to ImPlot
+struct PlotSeries {
+    char label[64];
+    std::vector<double> x, y;
+    int count = 0;
+};
+
+// Largest-Triangle-Three-Buckets downsampling of (x[k], y[k]), k < n, to at most
+// threshold points (first and last always kept). Copies when n <= threshold.
+// Returns the number of points written to outX/outY.
+int DownsampleLTTB(const double* x, const GridView& y, int n, int threshold, double* outX, double* outY);
+
+// Pick count indices spread evenly over [0, n) - always includes 0 and n-1
+void EvenSliceIndices(int n, int count, std::vector<int>& out);
+
+// Slice series for both plots, rebuilt only when the data generation, slice count or
+// point budget changes. Series objects and their buffers are reused, so a rebuild of the
+// same shape and every unchanged frame perform no heap allocation.
+class AxlePlotSeriesCache {
+public:
+    // Returns true when the series were rebuilt this call.
+    bool Update(const AxleData& data, int slices, int maxPoints);
+
+    // Front and rear load vs slope, one pair per accel slice: [2k] front, [2k+1] rear
+    const std::vector<PlotSeries>& VsSlope() const { return vsSlope_; }
+    // Front and rear load vs accel, one pair per theta slice: [2k] front, [2k+1] rear
+    const std::vector<PlotSeries>& VsAccel() const { return vsAccel_; }
+
+    std::uint64_t Generation() const { return generation_; }
+
+    // Slices through one grid cell (the heatmap cursor): front/rear vs slope at accel[col] and
+    // front/rear vs accel at theta[row], same layout as above. Rebuilt only when the cell, data
+    // generation or point budget changes; row or col < 0 clears them. Returns true when rebuilt.
+    bool UpdateCursor(const AxleData& data, int row, int col, int maxPoints);
+    const std::vector<PlotSeries>& CursorVsSlope() const { return cursorSlope_; }
+    const std::vector<PlotSeries>& CursorVsAccel() const { return cursorAccel_; }
+
+private:
+    std::uint64_t generation_ = 0;
+    int slices_ = 0;
+    int maxPoints_ = 0;
+    std::vector<int> idx_;
+    std::vector<PlotSeries> vsSlope_, vsAccel_;
+
+    std::uint64_t cursorGen_ = 0;
+    int cursorRow_ = -1, cursorCol_ = -1, cursorPoints_ = 0;
+    std::vector<PlotSeries> cursorSlope_, cursorAccel_;
+};
+
+#endif // PLOT_SERIES_H
@@ -1,4 +1,6 @@
 #include "plots.hpp"
+#include "plotSeries.hpp"
+#include "profiler.hpp"
 #include <string>
 #include <vector>
 #include <cstdio>
@@ -12,150 +14,193 @@ File       - Program Header
 Version    - 0
     - Release Notes:
         - Version 0   - Row 1 plots for axle loads
+        - Version 1   - Plot straight from flat AxleGrid storage (strided columns)
+        - Version 2   - Pixel-resolution slices from the separable grid backend
+        - Version 3   - Cached/downsampled slice series, any number of slices
+        - Version 4   - Profiler scopes + frame profiler panel
+        - Version 5   - Shaded Monte Carlo envelope bands
+        - Version 6   - Pitch dynamics transient vs quasi-static loads
+        - Version 7   - Parameter sensitivity heatmap
+        - Version 8   - Pyramid-backed load heatmap, cursor slices in the line plots
+        - Version 9   - Vehicle comparison overlay (per-variant cached slices)
+        - Version 10  - Brake bias plot
+        - Version 11  - Load and comparison plots drawn from the separable grid only
 ********************/
 
 // ImGui/ImPlot headers are included via plots.hpp
 
-// Render the axle load plots (front+rear vs slope, front+rear vs acceleration)
+// Slope plot axes: radians on X1, degrees on a secondary top X2 axis
+static void SetupSlopeAxes(double xmin, double xmax) {
+    // Primary X axis in radians, add a secondary top X axis in degrees for reference
+    ImPlot::SetupAxes("Slope (rad)", "Front Load (N)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+    // Enable secondary X2 axis first, then set its limits/format
+    ImPlot::SetupAxis(ImAxis_X2, "Slope (deg)");
+    // Ensure X and X2 share the same limits so 0 aligns across both axes
+    if (xmax < xmin) std::swap(xmin, xmax);
+    ImPlot::SetupAxisLimits(ImAxis_X1, xmin, xmax, ImPlotCond_Once);
+    ImPlot::SetupAxisLimits(ImAxis_X2, xmin, xmax, ImPlotCond_Once);
+    ImPlot::SetupAxisFormat(ImAxis_X2,
+        [](double v, char* buff, int size, void*) {
+            double deg = v * 180.0 / 3.14159265358979323846;
+            return std::snprintf(buff, size, "%.1f", deg);
+        }
+    );
+}
+
+// Front/rear operating point markers at x
+static void PlotOperatingPoints(double x, double WF0, double WR0) {
+    const double xOP[1] = {x};
+    const double yOP[1] = {WF0};
+    const double yOPr[1] = {WR0};
+    ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 6.0f, ImVec4(1,0,0,1), 2.0f, ImVec4(1,1,1,1));
+    ImPlot::PlotScatter("Front OP", xOP, yOP, 1);
+    ImPlot::SetNextMarkerStyle(ImPlotMarker_Asterisk, 6.0f, ImVec4(1,0,0,1), 2.0f, ImVec4(1,1,1,1));
+    ImPlot::PlotScatter("Rear OP", xOP, yOPr, 1);
+}
+
+// Envelope bands: min..max lightly shaded, pLow..pHigh darker. Items share one label per
+// axle and band so every slice lands on the same legend entry / colour.
+static bool HasEnvelope(const AxleEnvelopeData* env) {
+    return env && env->generation != 0 && env->samples > 0 && !env->WF.min.Empty();
+}
+
+static void BandLabels(const AxleEnvelopeData& env, char (&pct)[2][48], char (&range)[2][48]) {
+    const char* axle[2] = {"Front", "Rear"};
+    for (int k = 0; k < 2; ++k) {
+        std::snprintf(pct[k], sizeof(pct[k]), "%s P%g-P%g", axle[k], env.pLow * 100.0, env.pHigh * 100.0);
+        std::snprintf(range[k], sizeof(range[k]), "%s min-max", axle[k]);
+    }
+}
+
+// Bands vs slope at evenly spread accel columns (strided columns copied to scratch)
+static void PlotEnvelopeVsSlope(const AxleEnvelopeData& env, int slices) {
+    static std::vector<int> idx;
+    static std::vector<double> lo, hi, mn, mx;
+    const int rows = (int)env.theta.size(), cols = (int)env.accel.size();
+    EvenSliceIndices(cols, slices, idx);
+    if ((int)lo.size() < rows) { lo.resize(rows); hi.resize(rows); mn.resize(rows); mx.resize(rows); }
+    char pct[2][48], range[2][48];
+    BandLabels(env, pct, range);
+    for (int j : idx) {
+        for (int k = 0; k < 2; ++k) {
+            const AxleLoadBands& B = k == 0 ? env.WF : env.WR;
+            for (int i = 0; i < rows; ++i) {
+                lo[i] = B.pLow(i, j); hi[i] = B.pHigh(i, j);
+                mn[i] = B.min(i, j);  mx[i] = B.max(i, j);
+            }
+            ImPlot::SetNextFillStyle(IMPLOT_AUTO_COL, 0.15f);
+            ImPlot::PlotShaded(range[k], env.theta.data(), mn.data(), mx.data(), rows);
+            ImPlot::SetNextFillStyle(IMPLOT_AUTO_COL, 0.35f);
+            ImPlot::PlotShaded(pct[k], env.theta.data(), lo.data(), hi.data(), rows);
+        }
+    }
+}
+
+// Bands vs accel at evenly spread theta rows (rows are contiguous, no copy)
+static void PlotEnvelopeVsAccel(const AxleEnvelopeData& env, int slices) {
+    static std::vector<int> idx;
+    const int rows = (int)env.theta.size(), cols = (int)env.accel.size();
+    EvenSliceIndices(rows, slices, idx);
+    char pct[2][48], range[2][48];
+    BandLabels(env, pct, range);
+    for (int i : idx) {
+        for (int k = 0; k < 2; ++k) {
+            const AxleLoadBands& B = k == 0 ? env.WF : env.WR;
+            ImPlot::SetNextFillStyle(IMPLOT_AUTO_COL, 0.15f);
+            ImPlot::PlotShaded(range[k], env.accel.data(), B.min.Row(i), B.max.Row(i), cols);
+            ImPlot::SetNextFillStyle(IMPLOT_AUTO_COL, 0.35f);
+            ImPlot::PlotShaded(pct[k], env.accel.data(), B.pLow.Row(i), B.pHigh.Row(i), cols);
+        }
+    }
+}
+
+// Render the two side-by-side axle load plots from a separable grid.
+// Slices are evaluated at one sample per horizontal pixel rather than at grid points,
+// so they stay smooth however coarse the grid is.
 void RenderAxleLoadPlots(const VehicleParams& vp,
-                         const AxleData& AxleLoadData,
+                         const SeparableAxleData& AxleLoadData,
                          double thetaNom,
                          double accelNom,
                          double WF0,
-                         double WR0) {
-    if (AxleLoadData.WF.empty() || AxleLoadData.theta.empty() || AxleLoadData.accel.empty())
-        return;
+                         double WR0,
+                         int slices,
+                         const AxleEnvelopeData* envelope,
+                         const GridCursor* cursor) {
+    PROFILE_SCOPE("RenderAxleLoadPlots");
+    (void)vp;
+    if (AxleLoadData.Empty()) return;
+    const bool cursorOn = cursor && cursor->row >= 0 && cursor->row < AxleLoadData.Rows()
+                       && cursor->col >= 0 && cursor->col < AxleLoadData.Cols();
+    const bool bands = HasEnvelope(envelope);
 
-    const int nThetaAvail = (int)AxleLoadData.theta.size();
-    const int nThetaRows  = (int)AxleLoadData.WF.size();
-    const int rows = nThetaAvail < nThetaRows ? nThetaAvail : nThetaRows;
-    const int nAccel = (int)AxleLoadData.accel.size();
-
-    // Compute equal widths for two side-by-side plots
     float full_row = ImGui::GetContentRegionAvail().x;
     float spacing = ImGui::GetStyle().ItemSpacing.x;
     float plot_w = (full_row - spacing) * 0.5f;
+    const int n = plot_w > 2.0f ? (int)plot_w : 2;
+    if (slices < 1) slices = 1;
 
-    // Row: Front & Rear vs Slope
-    if (rows > 0 && nAccel > 0) {
-        if (ImPlot::BeginPlot("Axle Loads vs Slope", ImVec2(plot_w, 0))) {
-            // Primary X axis in radians, add a secondary top X axis in degrees for reference
-            ImPlot::SetupAxes("Slope (rad)", "Front Load (N)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
-            // Enable secondary X2 axis first, then set its limits/format
-            ImPlot::SetupAxis(ImAxis_X2, "Slope (deg)");
-            // Ensure X and X2 share the same limits so 0 aligns across both axes
-            if (!AxleLoadData.theta.empty()) {
-                double xmin = AxleLoadData.theta.front();
-                double xmax = AxleLoadData.theta.back();
-                if (xmax < xmin) std::swap(xmin, xmax);
-                ImPlot::SetupAxisLimits(ImAxis_X1, xmin, xmax, ImPlotCond_Once);
-                ImPlot::SetupAxisLimits(ImAxis_X2, xmin, xmax, ImPlotCond_Once);
-            }
-            ImPlot::SetupAxisFormat(ImAxis_X2,
-                [](double v, char* buff, int size, void*) {
-                    double deg = v * 180.0 / 3.14159265358979323846;
-                    return std::snprintf(buff, size, "%.1f", deg);
-                }
-            );
-            const int j_idx[2] = {0, nAccel - 1};
-            auto fmt = [](double v){ char b[32]; std::snprintf(b, sizeof(b), "%.2f", v); return std::string(b); };
-            const double a_min = AxleLoadData.accel.front();
-            const double a_max = AxleLoadData.accel.back();
-            const std::string lblFrontAmin = std::string("Front Load (min a=") + fmt(a_min) + ")";
-            const std::string lblFrontAmax = std::string("Front Load (max a=") + fmt(a_max) + ")";
-            for (int k = 0; k < 2; ++k) {
-                const int j = j_idx[k];
-                if (j < 0 || j >= nAccel) continue;
-                bool row_ok = true;
-                std::vector<double> y(rows, 0.0);
-                for (int i = 0; i < rows; ++i) {
-                    if ((int)AxleLoadData.WF[i].size() != nAccel) { row_ok = false; break; }
-                    y[i] = AxleLoadData.WF[i][j];
-                }
-                if (row_ok) {
-                    const char* label = (k == 0) ? lblFrontAmin.c_str() : lblFrontAmax.c_str();
-                    ImPlot::PlotLine(label, AxleLoadData.theta.data(), y.data(), rows);
-                }
-            }
-
-            // Overlay rear axle traces at same accel slices (min/max)
-            const std::string lblRearAmin = std::string("Rear Load (min a=") + fmt(a_min) + ")";
-            const std::string lblRearAmax = std::string("Rear Load (max a=") + fmt(a_max) + ")";
-            for (int k = 0; k < 2; ++k) {
-                const int j = j_idx[k];
-                if (j < 0 || j >= nAccel) continue;
-                bool row_ok = true;
-                std::vector<double> yR(rows, 0.0);
-                for (int i = 0; i < rows; ++i) {
-                    if ((int)AxleLoadData.WR[i].size() != nAccel) { row_ok = false; break; }
-                    yR[i] = AxleLoadData.WR[i][j];
-                }
-                if (row_ok) {
-                    const char* label = (k == 0) ? lblRearAmin.c_str() : lblRearAmax.c_str();
-                    ImPlot::PlotLine(label, AxleLoadData.theta.data(), yR.data(), rows);
-                }
-            }
-
-            // Operating point markers from model: x = thetaNom, y = WF0/WR0
-            const double xOP[1] = {thetaNom};
-            const double yOP[1] = {WF0};
-            const double yOPr[1] = {WR0};
-            ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 6.0f, ImVec4(1,0,0,1), 2.0f, ImVec4(1,1,1,1));
-            ImPlot::PlotScatter("Front OP", xOP, yOP, 1);
-            ImPlot::SetNextMarkerStyle(ImPlotMarker_Asterisk, 6.0f, ImVec4(1,0,0,1), 2.0f, ImVec4(2,1,1,1));
-            ImPlot::PlotScatter("Rear OP", xOP, yOPr, 1);
+    // Scratch reused across frames (grows only when the window gets wider)
+    static std::vector<double> x, yF, yR;
+    if ((int)x.size() < n) { x.resize(n); yF.resize(n); yR.resize(n); }
+    char lblF[64], lblR[64];
 
-            ImPlot::EndPlot();
+    if (ImPlot::BeginPlot("Axle Loads vs Slope", ImVec2(plot_w, 0))) {
+        SetupSlopeAxes(AxleLoadData.theta.front(), AxleLoadData.theta.back());
+        if (bands) PlotEnvelopeVsSlope(*envelope, slices);
+        const double a0 = AxleLoadData.accel.front(), a1 = AxleLoadData.accel.back();
+        for (int k = 0; k < slices; ++k) {
+            const double a = slices > 1 ? a0 + (a1 - a0) * k / (slices - 1) : a0;
+            AxleLoadData.SampleAtAccel(a, n, x.data(), yF.data(), yR.data());
+            std::snprintf(lblF, sizeof(lblF), "Front Load (a=%.2f)", a);
+            std::snprintf(lblR, sizeof(lblR), "Rear Load (a=%.2f)", a);
+            ImPlot::PlotLine(lblF, x.data(), yF.data(), n);
+            ImPlot::PlotLine(lblR, x.data(), yR.data(), n);
         }
+        if (cursorOn) {
+            const double a = AxleLoadData.accel[cursor->col];
+            AxleLoadData.SampleAtAccel(a, n, x.data(), yF.data(), yR.data());
+            std::snprintf(lblF, sizeof(lblF), "Front Load (cursor a=%.2f)", a);
+            std::snprintf(lblR, sizeof(lblR), "Rear Load (cursor a=%.2f)", a);
+            ImPlot::SetNextLineStyle(IMPLOT_AUTO_COL, 2.5f);
+            ImPlot::PlotLine(lblF, x.data(), yF.data(), n);
+            ImPlot::SetNextLineStyle(IMPLOT_AUTO_COL, 2.5f);
+            ImPlot::PlotLine(lblR, x.data(), yR.data(), n);
+        }
+        PlotOperatingPoints(thetaNom, WF0, WR0);
+        ImPlot::EndPlot();
     }
 
-    // Place the acceleration plot on the same row as the slope plot
-    if (nAccel > 0 && nThetaRows > 0) {
-        ImGui::SameLine();
-        if (ImPlot::BeginPlot("Axle Loads vs Accel", ImVec2(plot_w, 0))) {
-            ImPlot::SetupAxes("Acceleration (m/s^2)", "Front Load (N)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
-            const int row_idx[2] = {0, rows - 1};
-            auto fmt2 = [](double v){ char b[32]; std::snprintf(b, sizeof(b), "%.3f", v); return std::string(b); };
-            const double th_min = AxleLoadData.theta.front();
-            const double th_max = AxleLoadData.theta.back();
-            const std::string lblFrontTmin = std::string("Front Load (min theta =") + fmt2(th_min) + " rad)";
-            const std::string lblFrontTmax = std::string("Front Load (max theta =") + fmt2(th_max) + " rad)";
-            for (int k = 0; k < 2; ++k) {
-                const int i = row_idx[k];
-                if (i < 0 || i >= nThetaRows) continue;
-                if ((int)AxleLoadData.WF[i].size() == nAccel) {
-                    const char* label = (k == 0) ? lblFrontTmin.c_str() : lblFrontTmax.c_str();
-                    ImPlot::PlotLine(label, AxleLoadData.accel.data(), AxleLoadData.WF[i].data(), nAccel);
-                }
-            }
-
-            // Overlay rear axle traces at the same slope slices (min/max θ)
-            const std::string lblRearTmin = std::string("Rear Load (min theta =") + fmt2(th_min) + " rad)";
-            const std::string lblRearTmax = std::string("Rear Load (max theta =") + fmt2(th_max) + " rad)";
-            for (int k = 0; k < 2; ++k) {
-                const int i = row_idx[k];
-                if (i < 0 || i >= nThetaRows) continue;
-                if ((int)AxleLoadData.WR[i].size() == nAccel) {
-                    const char* label = (k == 0) ? lblRearTmin.c_str() : lblRearTmax.c_str();
-                    ImPlot::PlotLine(label, AxleLoadData.accel.data(), AxleLoadData.WR[i].data(), nAccel);
-                }
-            }
-
-            // Operating point markers from model: x = accelNom, y = WF0/WR0
-            const double xOP2[1] = {accelNom};
-            const double yOP2[1] = {WF0};
-            const double yOP2r[1] = {WR0};
-            ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 6.0f, ImVec4(1,0,0,1), 2.0f, ImVec4(1,1,1,1));
-            ImPlot::PlotScatter("Front OP", xOP2, yOP2, 1);
-            ImPlot::SetNextMarkerStyle(ImPlotMarker_Asterisk, 6.0f, ImVec4(1,0,0,1), 2.0f, ImVec4(1,1,1,1));
-            ImPlot::PlotScatter("Rear OP", xOP2, yOP2r, 1);
-
-            ImPlot::EndPlot();
+    ImGui::SameLine();
+    if (ImPlot::BeginPlot("Axle Loads vs Accel", ImVec2(plot_w, 0))) {
+        ImPlot::SetupAxes("Acceleration (m/s^2)", "Front Load (N)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        if (bands) PlotEnvelopeVsAccel(*envelope, slices);
+        const double t0 = AxleLoadData.theta.front(), t1 = AxleLoadData.theta.back();
+        for (int k = 0; k < slices; ++k) {
+            const double th = slices > 1 ? t0 + (t1 - t0) * k / (slices - 1) : t0;
+            AxleLoadData.SampleAtTheta(th, n, x.data(), yF.data(), yR.data());
+            std::snprintf(lblF, sizeof(lblF), "Front Load (theta =%.3f rad)", th);
+            std::snprintf(lblR, sizeof(lblR), "Rear Load (theta =%.3f rad)", th);
+            ImPlot::PlotLine(lblF, x.data(), yF.data(), n);
+            ImPlot::PlotLine(lblR, x.data(), yR.data(), n);
         }
+        if (cursorOn) {
+            const double th = AxleLoadData.theta[cursor->row];
+            AxleLoadData.SampleAtTheta(th, n, x.data(), yF.data(), yR.data());
+            std::snprintf(lblF, sizeof(lblF), "Front Load (cursor theta =%.3f rad)", th);
+            std::snprintf(lblR, sizeof(lblR), "Rear Load (cursor theta =%.3f rad)", th);
+            ImPlot::SetNextLineStyle(IMPLOT_AUTO_COL, 2.5f);
+            ImPlot::PlotLine(lblF, x.data(), yF.data(), n);
+            ImPlot::SetNextLineStyle(IMPLOT_AUTO_COL, 2.5f);
+            ImPlot::PlotLine(lblR, x.data(), yR.data(), n);
+        }
+        PlotOperatingPoints(accelNom, WF0, WR0);
+        ImPlot::EndPlot();
     }
 }
+
 ControlResult RenderRangeControls(PlotRanges& ranges, const PlotRanges& defaults) {
-    ControlResult res{false,false};
+    PROFILE_SCOPE("RenderRangeControls");
+    ControlResult res{false,false,false};
 
     ImGui::TextUnformatted("Input Ranges");
     ImGui::Separator();
@@ -163,17 +208,17 @@ ControlResult RenderRangeControls(PlotRanges& ranges, const PlotRanges& defaults
 
     // Theta controls (min/max)
     ImGui::SetNextItemWidth(140);
-    ImGui::InputDouble("theta min (rad)", &ranges.thetaMin, 0.01, 0.1, "%.3f");
+    res.changed |= ImGui::InputDouble("theta min (rad)", &ranges.thetaMin, 0.01, 0.1, "%.3f");
     ImGui::SameLine();
     ImGui::SetNextItemWidth(140);
-    ImGui::InputDouble("theta max (rad)", &ranges.thetaMax, 0.01, 0.1, "%.3f");
+    res.changed |= ImGui::InputDouble("theta max (rad)", &ranges.thetaMax, 0.01, 0.1, "%.3f");
 
     // Accel controls (min/max)
     ImGui::SetNextItemWidth(140);
-    ImGui::InputDouble("accel min (m/s^2)", &ranges.accelMin, 0.1, 1.0, "%.2f");
+    res.changed |= ImGui::InputDouble("accel min (m/s^2)", &ranges.accelMin, 0.1, 1.0, "%.2f");
     ImGui::SameLine();
     ImGui::SetNextItemWidth(140);
-    ImGui::InputDouble("accel max (m/s^2)", &ranges.accelMax, 0.1, 1.0, "%.2f");
+    res.changed |= ImGui::InputDouble("accel max (m/s^2)", &ranges.accelMax, 0.1, 1.0, "%.2f");
 
     // Buttons
     if (ImGui::Button("Apply")) {
@@ -192,3 +237,351 @@ ControlResult RenderRangeControls(PlotRanges& ranges, const PlotRanges& defaults
     ImGui::Separator();
     return res;
 }
+
+void RenderPitchDynamicsPlot(const PitchSimData& sim, int scenario) {
+    PROFILE_SCOPE("RenderPitchDynamicsPlot");
+    if (sim.generation == 0 || scenario < 0 || scenario >= sim.WF.Rows() || sim.time.empty())
+        return;
+    const int n = (int)sim.time.size();
+
+    // Pitch in degrees for the secondary axis (rebuilt only when the run changes)
+    static std::vector<double> pitchDeg;
+    static std::uint64_t pitchGen = 0;
+    static int pitchRow = -1;
+    if (pitchGen != sim.generation || pitchRow != scenario) {
+        pitchDeg.resize(n);
+        const double* p = sim.pitch.Row(scenario);
+        for (int s = 0; s < n; ++s) pitchDeg[s] = p[s] * 57.29577951308232;
+        pitchGen = sim.generation;
+        pitchRow = scenario;
+    }
+
+    if (ImPlot::BeginPlot("Braking transient", ImVec2(-1, 0))) {
+        ImPlot::SetupAxes("Time (s)", "Axle Load (N)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        ImPlot::SetupAxis(ImAxis_Y2, "Pitch (deg)", ImPlotAxisFlags_AuxDefault | ImPlotAxisFlags_AutoFit);
+
+        ImPlot::PlotLine("Front", sim.time.data(), sim.WF.Row(scenario), n);
+        const ImVec4 front = ImPlot::GetLastItemColor();
+        ImPlot::PlotLine("Rear", sim.time.data(), sim.WR.Row(scenario), n);
+        const ImVec4 rear = ImPlot::GetLastItemColor();
+        // Quasi-static reference: same colours, faded and thin
+        ImPlot::SetNextLineStyle(ImVec4(front.x, front.y, front.z, 0.45f), 1.0f);
+        ImPlot::PlotLine("Front (static)", sim.time.data(), sim.WFStatic.Row(scenario), n);
+        ImPlot::SetNextLineStyle(ImVec4(rear.x, rear.y, rear.z, 0.45f), 1.0f);
+        ImPlot::PlotLine("Rear (static)", sim.time.data(), sim.WRStatic.Row(scenario), n);
+
+        ImPlot::SetAxes(ImAxis_X1, ImAxis_Y2);
+        ImPlot::PlotLine("Pitch", sim.time.data(), pitchDeg.data(), n);
+        ImPlot::EndPlot();
+    }
+}
+
+// Index of the sample nearest v on a uniformly spaced axis
+static int NearestIndex(const std::vector<double>& axis, double v) {
+    const int n = (int)axis.size();
+    if (n < 2 || axis.back() == axis.front()) return 0;
+    const double u = (v - axis.front()) / (axis.back() - axis.front()) * (n - 1);
+    return std::clamp((int)std::lround(u), 0, n - 1);
+}
+
+void RenderFleetPlots(const AxleFleet& fleet, const std::vector<std::string>& names,
+                      const SeparableAxleData* current, double thetaNom, double accelNom) {
+    PROFILE_SCOPE("RenderFleetPlots");
+    const int n = fleet.Size();
+    if (current && current->Empty()) current = nullptr;
+    if (n == 0 && !current) return;
+
+    float full_row = ImGui::GetContentRegionAvail().x;
+    float spacing = ImGui::GetStyle().ItemSpacing.x;
+    float plot_w = (full_row - spacing) * 0.5f;
+    const int maxPoints = plot_w > 3.0f ? (int)plot_w : 3;
+
+    // One slice cache per variant; unchanged variants keep their generation, so only
+    // recomputed ones are re-sliced
+    static std::vector<AxlePlotSeriesCache> caches;
+    if ((int)caches.size() < n) caches.resize(n);
+    auto update = [&](AxlePlotSeriesCache& cache, const AxleData& grid) {
+        if (grid.theta.empty() || grid.accel.empty()) return false;
+        cache.UpdateCursor(grid, NearestIndex(grid.theta, thetaNom), NearestIndex(grid.accel, accelNom), maxPoints);
+        return !cache.CursorVsSlope().empty();
+    };
+    auto plotPair = [](const std::vector<PlotSeries>& s, const char* name, int id, bool reference) {
+        char label[96];
+        if (reference) ImPlot::SetNextLineStyle(ImVec4(1, 1, 1, 1), 2.0f);
+        std::snprintf(label, sizeof(label), "%s##F%d", name, id);
+        ImPlot::PlotLine(label, s[0].x.data(), s[0].y.data(), s[0].count);
+        const ImVec4 col = ImPlot::GetLastItemColor();
+        ImPlot::SetNextLineStyle(ImVec4(col.x, col.y, col.z, 0.5f), reference ? 2.0f : 1.0f);
+        std::snprintf(label, sizeof(label), "%s (rear)##R%d", name, id);
+        ImPlot::PlotLine(label, s[1].x.data(), s[1].y.data(), s[1].count);
+    };
+    static std::vector<char> ok;
+    ok.assign(n, 0);
+    for (int v = 0; v < n; ++v) ok[v] = update(caches[v], fleet.Grid(v));
+    // The current vehicle is sampled from its separable grid at the grid point nearest the
+    // operating point, one value per pixel (the series buffers only grow)
+    static std::vector<PlotSeries> curSlope(2), curAccel(2);
+    if (current) {
+        const double a = current->accel[NearestIndex(current->accel, accelNom)];
+        const double th = current->theta[NearestIndex(current->theta, thetaNom)];
+        for (PlotSeries* ps : {&curSlope[0], &curSlope[1], &curAccel[0], &curAccel[1]}) {
+            if ((int)ps->x.size() < maxPoints) { ps->x.resize(maxPoints); ps->y.resize(maxPoints); }
+            ps->count = maxPoints;
+        }
+        current->SampleAtAccel(a, maxPoints, curSlope[0].x.data(), curSlope[0].y.data(), curSlope[1].y.data());
+        std::copy(curSlope[0].x.begin(), curSlope[0].x.begin() + maxPoints, curSlope[1].x.begin());
+        current->SampleAtTheta(th, maxPoints, curAccel[0].x.data(), curAccel[0].y.data(), curAccel[1].y.data());
+        std::copy(curAccel[0].x.begin(), curAccel[0].x.begin() + maxPoints, curAccel[1].x.begin());
+    }
+
+    char title[96];
+    std::snprintf(title, sizeof(title), "Variants vs Slope (a=%.2f m/s^2)###fleetSlope", accelNom);
+    if (ImPlot::BeginPlot(title, ImVec2(plot_w, 0))) {
+        SetupSlopeAxes(current ? current->theta.front() : fleet.Grid(0).theta.front(),
+                       current ? current->theta.back()  : fleet.Grid(0).theta.back());
+        for (int v = 0; v < n; ++v)
+            if (ok[v]) plotPair(caches[v].CursorVsSlope(), v < (int)names.size() ? names[v].c_str() : "?", v, false);
+        if (current) plotPair(curSlope, "current", n, true);
+        ImPlot::EndPlot();
+    }
+    ImGui::SameLine();
+    std::snprintf(title, sizeof(title), "Variants vs Accel (theta=%.3f rad)###fleetAccel", thetaNom);
+    if (ImPlot::BeginPlot(title, ImVec2(plot_w, 0))) {
+        ImPlot::SetupAxes("Acceleration (m/s^2)", "Axle Load (N)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        for (int v = 0; v < n; ++v)
+            if (ok[v]) plotPair(caches[v].CursorVsAccel(), v < (int)names.size() ? names[v].c_str() : "?", v, false);
+        if (current) plotPair(curAccel, "current", n, true);
+        ImPlot::EndPlot();
+    }
+}
+
+void RenderAxleHeatmap(const AxleData& data, const AxleGridPyramid& pyramid, int field, bool useMax,
+                       GridCursor& cursor) {
+    PROFILE_SCOPE("RenderAxleHeatmap");
+    const int rows = data.WF.Rows(), cols = data.WF.Cols();
+    if (rows == 0 || cols == 0 || field < 0 || field >= kAxleHeatFieldCount) return;
+    if (pyramid.Empty() || pyramid.Generation() != data.generation) {
+        ImGui::TextDisabled("(building heatmap)");
+        return;
+    }
+    const AxleHeatField f = (AxleHeatField)field;
+
+    // Grid extent: each cell is centred on its (theta, accel) sample
+    double halfT = rows > 1 ? 0.5 * (data.theta.back() - data.theta.front()) / (rows - 1) : 0.0;
+    double halfA = cols > 1 ? 0.5 * (data.accel.back() - data.accel.front()) / (cols - 1) : 0.0;
+    if (!(halfT > 0.0)) halfT = 0.005;
+    if (!(halfA > 0.0)) halfA = 0.05;
+    const double t0 = data.theta.front() - halfT, t1 = data.theta.back() + halfT;
+    const double a0 = data.accel.front() - halfA, a1 = data.accel.back() + halfA;
+
+    // Resampled view, rebuilt only when the data, field, view rectangle or plot size changes
+    static std::vector<float> cells;
+    static std::uint64_t cellsGen = 0;
+    static int cellsField = -1, cellsMax = -1, outRows = 0, outCols = 0;
+    static double view[4] = {0, 0, 0, 0};
+    static double extent[4] = {0, 0, 0, 0};
+    const bool newExtent = extent[0] != t0 || extent[1] != t1 || extent[2] != a0 || extent[3] != a1;
+
+    const char* fmt = f == AxleHeatField::FrontShare ? "%.3f" : "%.0f";
+    ImPlot::PushColormap(ImPlotColormap_Viridis);
+    if (ImPlot::BeginPlot("Axle load map", ImVec2(-80, 0), ImPlotFlags_NoLegend)) {
+        ImPlot::SetupAxes("Acceleration (m/s^2)", "Slope (rad)");
+        // Fit to the grid once, and again whenever a new grid has different bounds
+        ImPlot::SetupAxesLimits(a0, a1, t0, t1, newExtent ? ImPlotCond_Always : ImPlotCond_Once);
+        if (newExtent) { extent[0] = t0; extent[1] = t1; extent[2] = a0; extent[3] = a1; }
+
+        const ImPlotRect lim = ImPlot::GetPlotLimits();
+        const ImVec2 size = ImPlot::GetPlotSize();
+        const double vt0 = std::max(t0, lim.Y.Min), vt1 = std::min(t1, lim.Y.Max);
+        const double va0 = std::max(a0, lim.X.Min), va1 = std::min(a1, lim.X.Max);
+        if (vt1 > vt0 && va1 > va0) {
+            // One sample per pixel of the visible part, capped to keep rebuilds cheap
+            const int wantRows = std::clamp((int)(size.y * (vt1 - vt0) / (lim.Y.Max - lim.Y.Min)), 1, 512);
+            const int wantCols = std::clamp((int)(size.x * (va1 - va0) / (lim.X.Max - lim.X.Min)), 1, 512);
+            if (cellsGen != data.generation || cellsField != field || cellsMax != (int)useMax ||
+                outRows != wantRows || outCols != wantCols ||
+                view[0] != vt0 || view[1] != vt1 || view[2] != va0 || view[3] != va1) {
+                outRows = wantRows;
+                outCols = wantCols;
+                cells.resize((size_t)outRows * outCols);
+                pyramid.Sample(data, f, useMax, vt0, vt1, va0, va1, outRows, outCols, cells.data());
+                cellsGen = data.generation;
+                cellsField = field;
+                cellsMax = (int)useMax;
+                view[0] = vt0; view[1] = vt1; view[2] = va0; view[3] = va1;
+            }
+            ImPlot::PlotHeatmap("##loads", cells.data(), outRows, outCols, pyramid.Min(f), pyramid.Max(f),
+                                nullptr, ImPlotPoint(va0, vt0), ImPlotPoint(va1, vt1));
+        }
+
+        // Cursor follows the mouse over the plot and stays on its last cell otherwise
+        if (ImPlot::IsPlotHovered()) {
+            const ImPlotPoint mp = ImPlot::GetPlotMousePos();
+            if (mp.x >= a0 && mp.x <= a1 && mp.y >= t0 && mp.y <= t1) {
+                cursor.row = std::clamp((int)((mp.y - t0) / (2.0 * halfT)), 0, rows - 1);
+                cursor.col = std::clamp((int)((mp.x - a0) / (2.0 * halfA)), 0, cols - 1);
+            }
+        }
+        if (cursor.row >= rows || cursor.col >= cols) cursor = GridCursor{};
+        if (cursor.row >= 0 && cursor.col >= 0) {
+            ImPlot::SetNextLineStyle(ImVec4(1, 1, 1, 0.8f), 1.0f);
+            ImPlot::PlotInfLines("##cursorA", &data.accel[cursor.col], 1);
+            ImPlot::SetNextLineStyle(ImVec4(1, 1, 1, 0.8f), 1.0f);
+            ImPlot::PlotInfLines("##cursorT", &data.theta[cursor.row], 1, ImPlotInfLinesFlags_Horizontal);
+        }
+        ImPlot::EndPlot();
+    }
+    ImGui::SameLine();
+    ImPlot::ColormapScale(f == AxleHeatField::FrontShare ? "WF / W" : "N", pyramid.Min(f), pyramid.Max(f),
+                          ImVec2(70, 0), fmt);
+    ImPlot::PopColormap();
+    if (cursor.row >= 0 && cursor.col >= 0) {
+        const double wf = data.WF(cursor.row, cursor.col), wr = data.WR(cursor.row, cursor.col);
+        ImGui::Text("theta %.4f rad  a %.3f m/s^2   WF %.1f N  WR %.1f N  front %.1f%%",
+                    data.theta[cursor.row], data.accel[cursor.col], wf, wr, 100.0 * wf / (wf + wr));
+    }
+}
+
+void RenderSensitivityHeatmap(const AxleSensitivityData& sens, int param, bool rear) {
+    PROFILE_SCOPE("RenderSensitivityHeatmap");
+    if (sens.generation == 0 || param < 0 || param > kAxleParamCount) return;
+    const AxleGrid* grids = rear ? sens.dWR : sens.dWF;
+    const int rows = grids[0].Rows(), cols = grids[0].Cols();
+    if (rows == 0 || cols == 0) return;
+
+    // Nearest-sampled copy of at most kMax x kMax cells, top row = thetaMax (ImPlot draws row 0 at the top).
+    // Rebuilt only when the data, the parameter or the axle changes.
+    const int kMax = 256;
+    static std::vector<double> cells;
+    static std::uint64_t cellsGen = 0;
+    static int cellsParam = -1, cellsRear = -1, outRows = 0, outCols = 0;
+    static double scale = 0.0;
+    if (cellsGen != sens.generation || cellsParam != param || cellsRear != (int)rear) {
+        outRows = std::min(rows, kMax);
+        outCols = std::min(cols, kMax);
+        cells.resize((size_t)outRows * outCols);
+        scale = 0.0;
+        for (int r = 0; r < outRows; ++r) {
+            const int i = (int)((long long)(outRows - 1 - r) * (rows - 1) / std::max(1, outRows - 1));
+            double* dst = &cells[(size_t)r * outCols];
+            for (int c = 0; c < outCols; ++c) {
+                const int j = (int)((long long)c * (cols - 1) / std::max(1, outCols - 1));
+                // CoG shift at fixed L: lf grows, lr shrinks by the same amount
+                const double v = param < kAxleParamCount
+                    ? grids[param](i, j)
+                    : grids[(int)AxleParam::lf](i, j) - grids[(int)AxleParam::lr](i, j);
+                dst[c] = v;
+                scale = std::max(scale, std::fabs(v));
+            }
+        }
+        if (scale == 0.0) scale = 1.0;
+        cellsGen = sens.generation;
+        cellsParam = param;
+        cellsRear = (int)rear;
+    }
+
+    char title[64];
+    std::snprintf(title, sizeof(title), "d%s / d%s##sens", rear ? "WR" : "WF",
+                  param < kAxleParamCount ? AxleParamName((AxleParam)param) : "CoG");
+    // Diverging map centred on zero so the sign of the sensitivity reads directly
+    ImPlot::PushColormap(ImPlotColormap_RdBu);
+    if (ImPlot::BeginPlot(title, ImVec2(-80, 0), ImPlotFlags_NoLegend)) {
+        ImPlot::SetupAxes("Acceleration (m/s^2)", "Slope (rad)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        ImPlot::PlotHeatmap("##cells", cells.data(), outRows, outCols, -scale, scale, nullptr,
+                            ImPlotPoint(sens.accel.front(), sens.theta.front()),
+                            ImPlotPoint(sens.accel.back(), sens.theta.back()));
+        ImPlot::EndPlot();
+    }
+    ImGui::SameLine();
+    ImPlot::ColormapScale("N / unit", -scale, scale, ImVec2(70, 0));
+    ImPlot::PopColormap();
+}
+
+void RenderBrakeBiasPlot(const BrakeBiasResult& bias) {
+    PROFILE_SCOPE("RenderBrakeBiasPlot");
+    const int n = (int)bias.decel.size();
+    if (bias.generation == 0 || n == 0) return;
+
+    // Curve and fixed bias sampled on the column decels (rebuilt only when the result changes)
+    static std::vector<double> curve, fixed;
+    static std::uint64_t curveGen = 0;
+    if (curveGen != bias.generation || (int)curve.size() != n) {
+        curve.resize(n);
+        fixed.assign(n, bias.fixedBias);
+        for (int k = 0; k < n; ++k) curve[k] = bias.curve.Bias(bias.decel[k]);
+        curveGen = bias.generation;
+    }
+
+    if (ImPlot::BeginPlot("Front brake share", ImVec2(-1, 0))) {
+        ImPlot::SetupAxes("Deceleration (m/s^2)", "Front share", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        ImPlot::SetNextFillStyle(IMPLOT_AUTO_COL, 0.35f);
+        ImPlot::PlotShaded("Ideal (over slope)", bias.decel.data(), bias.idealMin.data(), bias.idealMax.data(), n);
+        ImPlot::PlotLine("Optimized", bias.decel.data(), curve.data(), n);
+        ImPlot::SetNextLineStyle(IMPLOT_AUTO_COL, 1.0f);
+        ImPlot::PlotLine("Fixed", bias.decel.data(), fixed.data(), n);
+        ImPlot::EndPlot();
+    }
+}
+
+// Rolling frame time + per-stage breakdown from the global profiler, with Chrome trace export
+void RenderProfilerPanel(bool* open) {
+    Profiler& prof = GlobalProfiler();
+    if (!ImGui::Begin("Frame Profiler", open)) { ImGui::End(); return; }
+
+    bool capture = prof.Enabled();
+    if (ImGui::Checkbox("Capture", &capture)) prof.SetEnabled(capture);
+
+    // Chrome trace of everything still in the ring buffer
+    static char status[160] = "";
+    static int traceIndex = 0;
+    ImGui::SameLine();
+    if (ImGui::Button("Save Chrome trace")) {
+        char path[64];
+        std::snprintf(path, sizeof(path), "wheelload_trace_%d.json", traceIndex++);
+        if (prof.WriteChromeTrace(path))
+            std::snprintf(status, sizeof(status), "Wrote %s (open in chrome://tracing or ui.perfetto.dev)", path);
+        else
+            std::snprintf(status, sizeof(status), "Failed to write %s", path);
+    }
+    if (status[0]) ImGui::TextUnformatted(status);
+
+    const int n = prof.HistoryCount();
+    if (n == 0) {
+        ImGui::TextDisabled("No frames captured yet");
+        ImGui::End();
+        return;
+    }
+    const int first = Profiler::kHistory - n; // history is right-aligned, oldest first
+
+    if (ImPlot::BeginPlot("Frame time", ImVec2(-1, 200))) {
+        ImPlot::SetupAxes("Frame", "ms", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        ImPlot::PlotLine("Frame", prof.FrameTimes() + first, n);
+        for (int s = 0; s < prof.StageCount(); ++s)
+            ImPlot::PlotLine(prof.StageName(s), prof.StageTimes(s) + first, n);
+        ImPlot::EndPlot();
+    }
+
+    // Stage table: last / mean / max over the history window
+    if (ImGui::BeginTable("stages", 4)) {
+        ImGui::TableSetupColumn("Stage");
+        ImGui::TableSetupColumn("last ms");
+        ImGui::TableSetupColumn("mean ms");
+        ImGui::TableSetupColumn("max ms");
+        ImGui::TableHeadersRow();
+        auto row = [&](const char* name, const float* v) {
+            double sum = 0.0;
+            float mx = 0.0f;
+            for (int i = first; i < Profiler::kHistory; ++i) { sum += v[i]; mx = std::max(mx, v[i]); }
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(name);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", v[Profiler::kHistory - 1]);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", sum / n);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", mx);
+        };
+        row("Frame", prof.FrameTimes());
+        for (int s = 0; s < prof.StageCount(); ++s)
+            row(prof.StageName(s), prof.StageTimes(s));
+        ImGui::EndTable();
+    }
+    ImGui::End();
+}
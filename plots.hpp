@@ -6,6 +6,17 @@ File       - Program Header
 Version    - 0
     - Release Notes:
         - Version 0   - Class structure for PLotting functions
+        - Version 1   - Separable grid overload of RenderAxleLoadPlots
+        - Version 2   - ControlResult reports live edits
+        - Version 3   - Configurable slice count
+        - Version 4   - Frame profiler panel
+        - Version 5   - Monte Carlo envelope bands
+        - Version 6   - Braking transient (pitch dynamics) plot
+        - Version 7   - Sensitivity heatmap
+        - Version 8   - Full-grid load heatmap (pyramid resampled) with a cursor linked to the line plots
+        - Version 9   - Vehicle comparison overlay
+        - Version 10  - Brake bias curve over the ideal front share band
+        - Version 11  - Load and comparison plots take the separable grid only
 ********************/
 
 #ifndef PLOT_H
@@ -18,6 +29,13 @@ Version    - 0
 
 // Model types
 #include "axleLoads.hpp"
+#include "axleSeparable.hpp"
+#include "axleFleet.hpp"
+#include "axleMonteCarlo.hpp"
+#include "axlePyramid.hpp"
+#include "axlePitch.hpp"
+#include "axleSensitivity.hpp"
+#include "axleBrakeBias.hpp"
 
 // Simple container for UI-editable ranges
 struct PlotRanges {
@@ -27,27 +45,72 @@ struct PlotRanges {
     double accelMax;
 };
 
+// Grid cell picked on the load heatmap (-1 = none); its row and column are drawn as extra
+// slices in the line plots
+struct GridCursor { int row = -1; int col = -1; };
+
 // Result of rendering range controls
-struct ControlResult { bool apply; bool reset; };
+struct ControlResult { bool apply; bool reset; bool changed; };
 
 // Renders controls above the plots:
 // - 4 numeric inputs (theta min/max, accel min/max)
 // - Apply and Reset buttons
 // Returns ControlResult: apply=true when Apply clicked (caller should recompute),
-// reset=true when Reset clicked (caller may restore additional UI defaults).
+// reset=true when Reset clicked (caller may restore additional UI defaults),
+// changed=true when any range input was edited this frame (for live recompute).
 ControlResult RenderRangeControls(PlotRanges& ranges, const PlotRanges& defaults);
 
-// Render the two side-by-side axle load plots inside an active ImGui window.
+// Render the two side-by-side axle load plots inside an active ImGui window, from the
+// separable (O(n+m)) grid. Slices are sampled per pixel between the grid bounds.
 // Inputs:
 // - vp: vehicle parameters
-// - data: grids of theta, accel, WF, WR
+// - data: axes and per-theta coefficients
 // - thetaNom/accelNom: nominal operating point
 // - WF0/WR0: operating point axle loads computed from CalculateNominalAxleLoads
+// - slices: number of evenly spread slices per plot (2 = min/max)
+// - envelope: optional Monte Carlo envelope on the same axes, drawn as shaded
+//   percentile and min/max bands behind the slice lines
+// - cursor: optional heatmap cursor (same axes); its column (vs slope) and row (vs accel) are
+//   drawn bold
 void RenderAxleLoadPlots(const VehicleParams& vp,
-                         const AxleData& data,
+                         const SeparableAxleData& data,
                          double thetaNom,
                          double accelNom,
                          double WF0,
-                         double WR0);
+                         double WR0,
+                         int slices = 2,
+                         const AxleEnvelopeData* envelope = nullptr,
+                         const GridCursor* cursor = nullptr);
+
+// Time plot of one simulated scenario: dynamic front/rear loads with the quasi-static
+// loads at the same acceleration underneath, and body pitch (deg) on a second axis.
+void RenderPitchDynamicsPlot(const PitchSimData& sim, int scenario = 0);
+
+// Comparison of vehicle variants: front (solid) and rear (faded, same colour) load of every
+// variant vs slope at the accel nearest accelNom, and vs accel at the slope nearest thetaNom.
+// names[v] labels fleet variant v; current (optional) is overlaid in white as the reference.
+void RenderFleetPlots(const AxleFleet& fleet, const std::vector<std::string>& names,
+                      const SeparableAxleData* current, double thetaNom, double accelNom);
+
+// Heatmap of WF, WR or front share over the whole theta x accel grid (field indexes
+// AxleHeatField). The visible part is resampled from pyramid at about one cell per pixel, so
+// panning and zooming cost the same for any grid size; useMax picks per-pixel max over min.
+// Hovering moves cursor to the grid cell under the mouse; it stays put when the mouse leaves.
+// Nothing is drawn until pyramid has been built from data.
+void RenderAxleHeatmap(const AxleData& data, const AxleGridPyramid& pyramid, int field, bool useMax,
+                       GridCursor& cursor);
+
+// Heatmap of one partial over the theta x accel grid: param indexes AxleParam, or
+// kAxleParamCount for a CoG shift at fixed L (dW/dlf - dW/dlr). rear picks dWR over dWF.
+// Symmetric colour scale about zero; large grids are drawn from a cached <=256x256 sample.
+void RenderSensitivityHeatmap(const AxleSensitivityData& sens, int param, bool rear);
+
+// Front brake share vs deceleration: the band the ideal share spans over slope in each braking
+// column, the optimized bias curve and the best fixed bias. Nothing is drawn before a result.
+void RenderBrakeBiasPlot(const BrakeBiasResult& bias);
+
+// Frame profiler window: capture toggle, rolling frame/stage times and a button that
+// saves the profiler ring buffer as a Chrome trace (wheelload_trace_N.json in the cwd).
+void RenderProfilerPanel(bool* open);
 
 #endif // PLOT_H
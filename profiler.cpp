@@ -0,0 +1,140 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "profiler.hpp"
+
+/********************
+Program    - Axle Load Model - Frame Profiler
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Ring buffer writer/reader, stage history, Chrome trace writer
+        - Version 1   - Slot fields written and copied as relaxed atomics
+********************/
+
+thread_local std::uint32_t ProfileScope::depth = 0;
+
+// Small per-thread id for trace lanes (assigned on first use)
+static std::uint32_t ProfileThreadId() {
+    static std::atomic<std::uint32_t> next{0};
+    static thread_local std::uint32_t id = next.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+Profiler::Profiler() : ring_(new Slot[kCapacity]), frameMs_(kHistory, 0.0f) {
+    epoch_ = std::chrono::steady_clock::now().time_since_epoch().count();
+    for (int s = 0; s < kMaxStages; ++s) stageMs_[s].assign(kHistory, 0.0f);
+}
+
+Profiler& GlobalProfiler() {
+    static Profiler profiler;
+    return profiler;
+}
+
+std::uint64_t Profiler::NowNs() const {
+    const std::int64_t t = std::chrono::steady_clock::now().time_since_epoch().count() - epoch_;
+    return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::duration(t)).count();
+}
+
+// Seqlock-style publish: readers accept a slot only when seq matches before and after the copy
+void Profiler::Record(const char* name, std::uint64_t startNs, std::uint64_t endNs, std::uint32_t depth) {
+    const std::uint64_t idx = head_.fetch_add(1, std::memory_order_relaxed);
+    Slot& s = ring_[idx & (kCapacity - 1)];
+    s.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    s.name.store(name, std::memory_order_relaxed);
+    s.startNs.store(startNs, std::memory_order_relaxed);
+    s.endNs.store(endNs, std::memory_order_relaxed);
+    s.thread.store(ProfileThreadId(), std::memory_order_relaxed);
+    s.depth.store(depth, std::memory_order_relaxed);
+    s.seq.store(idx + 1, std::memory_order_release);
+}
+
+bool Profiler::ReadSlot(const Slot& s, std::uint64_t idx, ProfileEvent& out) {
+    if (s.seq.load(std::memory_order_acquire) != idx + 1) return false;
+    out.name = s.name.load(std::memory_order_relaxed);
+    out.startNs = s.startNs.load(std::memory_order_relaxed);
+    out.endNs = s.endNs.load(std::memory_order_relaxed);
+    out.thread = s.thread.load(std::memory_order_relaxed);
+    out.depth = s.depth.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return s.seq.load(std::memory_order_relaxed) == idx + 1;
+}
+
+void Profiler::Snapshot(std::vector<ProfileEvent>& out) const {
+    out.clear();
+    const std::uint64_t h = head_.load(std::memory_order_acquire);
+    const std::uint64_t from = h > (std::uint64_t)kCapacity ? h - kCapacity : 0;
+    out.reserve((std::size_t)(h - from));
+    ProfileEvent ev;
+    for (std::uint64_t i = from; i < h; ++i) {
+        const Slot& s = ring_[i & (kCapacity - 1)];
+        if (ReadSlot(s, i, ev)) out.push_back(ev);
+    }
+}
+
+int Profiler::StageIndex(const char* name) {
+    for (int s = 0; s < stageCount_; ++s)
+        if (stageNames_[s] == name || std::strcmp(stageNames_[s], name) == 0) return s;
+    if (stageCount_ == kMaxStages) return -1;
+    stageNames_[stageCount_] = name;
+    return stageCount_++;
+}
+
+void Profiler::FrameMark() {
+    const std::uint64_t now = NowNs();
+    const std::uint64_t h = head_.load(std::memory_order_acquire);
+    const bool first = frameStartNs_ == 0;
+    const std::uint64_t from = frameHead_;
+    frameHead_ = h;
+    const std::uint64_t frameNs = now - frameStartNs_;
+    frameStartNs_ = now;
+    if (!Enabled() || first) return;
+
+    // Sum this frame's events per stage
+    for (int s = 0; s < kMaxStages; ++s) stageAccum_[s] = 0.0f;
+    ProfileEvent ev;
+    for (std::uint64_t i = h - from > (std::uint64_t)kCapacity ? h - kCapacity : from; i < h; ++i) {
+        const Slot& s = ring_[i & (kCapacity - 1)];
+        if (!ReadSlot(s, i, ev)) continue;
+        const int stage = StageIndex(ev.name);
+        if (stage >= 0) stageAccum_[stage] += (float)((ev.endNs - ev.startNs) * 1e-6);
+    }
+
+    // Scroll the history by one frame
+    const int last = kHistory - 1;
+    std::memmove(frameMs_.data(), frameMs_.data() + 1, last * sizeof(float));
+    frameMs_[last] = (float)(frameNs * 1e-6);
+    for (int s = 0; s < stageCount_; ++s) {
+        std::memmove(stageMs_[s].data(), stageMs_[s].data() + 1, last * sizeof(float));
+        stageMs_[s][last] = stageAccum_[s];
+    }
+    if (historyCount_ < kHistory) ++historyCount_;
+}
+
+// Trace Event Format: complete ("X") events with microsecond timestamps
+bool Profiler::WriteChromeTrace(const std::string& path) const {
+    std::vector<ProfileEvent> events;
+    Snapshot(events);
+
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", f);
+    bool firstEvent = true;
+    for (const ProfileEvent& ev : events) {
+        std::fputs(firstEvent ? "" : ",\n", f);
+        firstEvent = false;
+        std::fputs("{\"name\":\"", f);
+        for (const char* c = ev.name; *c; ++c) {
+            if (*c == '"' || *c == '\\') std::fputc('\\', f);
+            if ((unsigned char)*c >= 0x20) std::fputc(*c, f);
+        }
+        std::fprintf(f, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                     ev.thread, ev.startNs * 1e-3, (ev.endNs - ev.startNs) * 1e-3);
+    }
+    std::fputs("\n]}\n", f);
+    const bool ok = !std::ferror(f);
+    return std::fclose(f) == 0 && ok;
+}
@@ -0,0 +1,127 @@
+/********************
+Program    - Axle Load Model - Frame Profiler
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Scoped timers into a lock-free ring buffer, per-frame stage history, Chrome trace export
+        - Version 1   - Ring slot fields are relaxed atomics (race-free seqlock reads)
+********************/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// One closed scope. name must be a string literal (or otherwise outlive the profiler).
+struct ProfileEvent {
+    const char* name;
+    std::uint64_t startNs;  // since profiler start
+    std::uint64_t endNs;
+    std::uint32_t thread;   // small sequential id, 0 = first thread to record
+    std::uint32_t depth;    // nesting depth on that thread
+};
+
+// Process-wide profiler.
+// Scopes from any thread append to a fixed ring buffer (one atomic increment, no lock);
+// the ring keeps the newest Capacity() events. FrameMark() is called once per frame by
+// the UI thread and folds that frame's events into a rolling per-stage history.
+class Profiler {
+public:
+    static const int kCapacity = 1 << 15;   // events kept in the ring
+    static const int kHistory  = 240;       // frames kept in the stage history
+    static const int kMaxStages = 16;
+
+    Profiler();
+
+    void SetEnabled(bool on) { enabled_.store(on, std::memory_order_relaxed); }
+    bool Enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    std::uint64_t NowNs() const;
+    void Record(const char* name, std::uint64_t startNs, std::uint64_t endNs, std::uint32_t depth);
+
+    // End the current frame (UI thread only)
+    void FrameMark();
+
+    // Rolling history, oldest first, in milliseconds. Stage times sum every event of
+    // that name that ended during the frame, on any thread.
+    int HistoryCount() const { return historyCount_; }
+    const float* FrameTimes() const { return frameMs_.data(); }
+    int StageCount() const { return stageCount_; }
+    const char* StageName(int s) const { return stageNames_[s]; }
+    const float* StageTimes(int s) const { return stageMs_[s].data(); }
+
+    // Copy the events currently in the ring, oldest first (events still being written are skipped)
+    void Snapshot(std::vector<ProfileEvent>& out) const;
+
+    // Write the ring as Chrome trace JSON (chrome://tracing, Perfetto). Returns false on I/O error.
+    bool WriteChromeTrace(const std::string& path) const;
+
+private:
+    // Fields are relaxed atomics so a reader copying a slot that is being rewritten is not a
+    // data race; seq tells it whether the copy is whole.
+    struct Slot {
+        std::atomic<std::uint64_t> seq{0};  // index + 1 once written, 0 while being written
+        std::atomic<const char*> name{nullptr};
+        std::atomic<std::uint64_t> startNs{0}, endNs{0};
+        std::atomic<std::uint32_t> thread{0}, depth{0};
+    };
+
+    // Copy event idx out of its slot; false if it was overwritten or is still being written
+    static bool ReadSlot(const Slot& s, std::uint64_t idx, ProfileEvent& out);
+    int StageIndex(const char* name);
+
+    std::atomic<bool> enabled_{false};
+    std::atomic<std::uint64_t> head_{0};
+    std::unique_ptr<Slot[]> ring_;
+    std::int64_t epoch_ = 0;
+
+    // UI-thread state
+    std::uint64_t frameHead_ = 0;           // ring index at the start of the current frame
+    std::uint64_t frameStartNs_ = 0;
+    int historyCount_ = 0;
+    std::vector<float> frameMs_;
+    int stageCount_ = 0;
+    const char* stageNames_[kMaxStages] = {};
+    std::vector<float> stageMs_[kMaxStages];
+    float stageAccum_[kMaxStages] = {};
+};
+
+Profiler& GlobalProfiler();
+
+// RAII timer behind PROFILE_SCOPE. When the profiler is disabled a scope costs the
+// GlobalProfiler() call (an out-of-line call with a static-init guard check) and one relaxed load.
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) {
+        Profiler& p = GlobalProfiler();
+        if (p.Enabled()) { name_ = name; start_ = p.NowNs(); depth_ = depth++; }
+    }
+    ~ProfileScope() {
+        if (name_) { --depth; GlobalProfiler().Record(name_, start_, GlobalProfiler().NowNs(), depth_); }
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    static thread_local std::uint32_t depth;
+    const char* name_ = nullptr;
+    std::uint64_t start_ = 0;
+    std::uint32_t depth_ = 0;
+};
+
+// PROFILE_SCOPE("Name") times the rest of the enclosing block.
+// Building without WLD_PROFILE compiles every scope out.
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#ifdef WLD_PROFILE
+    #define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#else
+    #define PROFILE_SCOPE(name) ((void)0)
+#endif
+
+#endif // PROFILER_H
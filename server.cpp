@@ -0,0 +1,329 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "axleKernel.hpp"
+#include "axleQuery.hpp"
+#include "threadPool.hpp"
+
+/********************
+Program    - Axle Load Modelling for Brake Redistribution
+Maintainer - C.Holmes
+File       - Headless Query Server Program
+Version    - 0
+    - Release Notes:
+        - Version 0   - Unix socket query server, requests coalesced per poll round
+            -- build -> ✅
+            -- run   -> ./WheelLoadServer [--socket /tmp/wheelload.sock] [-j threads] [--stats seconds]
+        - Version 1   - Refuse a socket a live server owns; bounded, shrinking connection buffers
+        - Version 2   - Reply buffer compacted before each append, so it is bounded by unsent bytes
+********************/
+
+static volatile std::sig_atomic_t gStop = 0;
+static void OnSignal(int) { gStop = 1; }
+
+static void PrintUsage() {
+    std::cerr <<
+        "Usage: WheelLoadServer [--socket path] [-j threads] [--stats seconds]\n"
+        "  Listens on a Unix domain socket for AxleQueryHeader requests (see axleQuery.hpp).\n"
+        "  All requests that arrive in one poll round are evaluated together in one pass.\n"
+        "  --stats N prints throughput and latency every N seconds (0 = only at exit).\n"
+        "  Stop with Ctrl-C; the socket file is removed on exit.\n";
+}
+
+// One client. in holds [0, inLen) received bytes, out holds [outSent, outLen) unsent reply bytes.
+struct Connection {
+    int fd = -1;
+    std::vector<char> in;
+    std::size_t inLen = 0;
+    std::vector<char> out;
+    std::size_t outLen = 0, outSent = 0;
+    std::size_t consumed = 0;           // input bytes taken by this round's requests
+    bool closed = false;
+};
+
+// A complete request found in a connection's input this round
+struct Pending {
+    int conn;
+    std::size_t inOffset;
+    std::size_t outOffset;
+    AxleQueryStatus status;
+};
+
+static const std::size_t kReadChunk = 256 * 1024;
+// Stop reading from a client whose replies pile up faster than it drains them
+static const std::size_t kMaxBacklog = 64u << 20;
+// Unparsed input held per client: one largest request. A complete request is always
+// consumed in the round it arrives, so the cap never stalls a well-formed client.
+static const std::size_t kMaxInput = QueryBytes(kAxleQueryMaxCount);
+// Drained buffers above this size are released
+static const std::size_t kKeepBuffer = 1u << 20;
+
+static bool SetNonBlocking(int fd) {
+    const int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static int Listen(const std::string& path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Socket path too long: " << path << std::endl;
+        return -1;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    // Replace a stale socket from an earlier run, but never a regular file or a socket a
+    // running server still answers on
+    struct stat st;
+    if (lstat(path.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            std::cerr << path << " exists and is not a socket" << std::endl;
+            return -1;
+        }
+        const int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        const bool live = probe >= 0 && connect(probe, (const sockaddr*)&addr, sizeof(addr)) == 0;
+        if (probe >= 0) close(probe);
+        if (live) {
+            std::cerr << "Another server is listening on " << path << std::endl;
+            return -1;
+        }
+        unlink(path.c_str());
+    }
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) { std::cerr << "socket: " << std::strerror(errno) << std::endl; return -1; }
+    if (bind(fd, (const sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 128) != 0 || !SetNonBlocking(fd)) {
+        std::cerr << "Cannot listen on " << path << ": " << std::strerror(errno) << std::endl;
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Read what is available, up to kMaxInput buffered; false when the peer closed or the socket failed
+static bool ReadAvailable(Connection& c) {
+    while (c.inLen < kMaxInput) {
+        if (c.in.size() - c.inLen < kReadChunk) c.in.resize(std::min(c.inLen + kReadChunk, kMaxInput));
+        const ssize_t r = read(c.fd, c.in.data() + c.inLen, c.in.size() - c.inLen);
+        if (r > 0) { c.inLen += (std::size_t)r; continue; }
+        if (r == 0) return false;
+        if (errno == EINTR) continue;
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    return true;
+}
+
+// Give back memory a burst of large requests left behind
+static void ReleaseDrained(Connection& c) {
+    if (c.inLen == 0 && c.in.size() > kKeepBuffer) std::vector<char>().swap(c.in);
+    if (c.outLen == 0 && c.out.size() > kKeepBuffer) std::vector<char>().swap(c.out);
+}
+
+// Write as much pending output as the socket takes; false on error
+static bool WritePending(Connection& c) {
+    while (c.outSent < c.outLen) {
+        const ssize_t w = write(c.fd, c.out.data() + c.outSent, c.outLen - c.outSent);
+        if (w > 0) { c.outSent += (std::size_t)w; continue; }
+        if (w < 0 && errno == EINTR) continue;
+        if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+        return false;
+    }
+    c.outLen = c.outSent = 0;
+    return true;
+}
+
+struct ServerStats {
+    std::uint64_t requests = 0, samples = 0, rounds = 0, errors = 0;
+    LatencyHistogram latency;     // request received -> reply queued
+    void Reset() { *this = ServerStats(); }
+};
+
+static void PrintStats(const ServerStats& s, double seconds, const char* label) {
+    if (seconds <= 0.0) return;
+    std::printf("%s %.1f s: %llu req (%.0f req/s), %.3g samples/s, %.1f req/round, "
+                "latency p50 %.1f us p99 %.1f us p99.9 %.1f us max %.1f us, %llu errors\n",
+                label, seconds, (unsigned long long)s.requests, s.requests / seconds, s.samples / seconds,
+                s.rounds ? (double)s.requests / s.rounds : 0.0,
+                s.latency.PercentileNs(0.50) / 1e3, s.latency.PercentileNs(0.99) / 1e3,
+                s.latency.PercentileNs(0.999) / 1e3, s.latency.MaxNs() / 1e3, (unsigned long long)s.errors);
+    std::fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    std::string path = "/tmp/wheelload.sock";
+    int threads = 0;
+    double statsEvery = 5.0;
+    for (int k = 1; k < argc; ++k) {
+        const std::string arg = argv[k];
+        if (arg == "--socket" && k + 1 < argc) path = argv[++k];
+        else if ((arg == "-j" || arg == "--threads") && k + 1 < argc) threads = std::atoi(argv[++k]);
+        else if (arg == "--stats" && k + 1 < argc) statsEvery = std::atof(argv[++k]);
+        else if (arg == "-h" || arg == "--help") { PrintUsage(); return 0; }
+        else { PrintUsage(); return 2; }
+    }
+
+    const int listenFd = Listen(path);
+    if (listenFd < 0) return 1;
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+    std::signal(SIGPIPE, SIG_IGN);   // a client that hangs up mid-reply is just dropped
+
+    ThreadPool pool(threads);
+    AxleQueryBatcher batcher(&pool);
+    std::printf("listening on %s (kernel: %s, threads: %d)\n", path.c_str(),
+                AxleKernelName(ActiveAxleKernel()), pool.Size());
+    std::fflush(stdout);
+
+    using Clock = std::chrono::steady_clock;
+    std::vector<Connection> conns;
+    std::vector<pollfd> fds;
+    std::vector<Pending> pending;
+    std::vector<AxleQueryJob> jobs;
+    ServerStats interval, total;
+    const Clock::time_point start = Clock::now();
+    Clock::time_point intervalStart = start;
+
+    while (!gStop) {
+        fds.clear();
+        fds.push_back({listenFd, POLLIN, 0});
+        for (const Connection& c : conns) {
+            short ev = 0;
+            if (c.outLen - c.outSent < kMaxBacklog) ev |= POLLIN;
+            if (c.outSent < c.outLen) ev |= POLLOUT;
+            fds.push_back({c.fd, ev, 0});
+        }
+        const int ready = poll(fds.data(), (nfds_t)fds.size(), 200);
+        if (ready < 0 && errno != EINTR) { std::cerr << "poll: " << std::strerror(errno) << std::endl; break; }
+
+        // New clients
+        if (ready > 0 && (fds[0].revents & POLLIN)) {
+            for (;;) {
+                const int fd = accept(listenFd, nullptr, nullptr);
+                if (fd < 0) break;
+                if (!SetNonBlocking(fd)) { close(fd); continue; }
+                Connection c;
+                c.fd = fd;
+                conns.push_back(std::move(c));
+            }
+        }
+
+        // Read every client that has data, then collect all complete requests
+        pending.clear();
+        for (size_t k = 0; k + 1 < fds.size() && ready > 0; ++k) {
+            Connection& c = conns[k];
+            if (fds[k + 1].revents & (POLLIN | POLLHUP | POLLERR))
+                if (!ReadAvailable(c)) c.closed = true;
+            std::size_t at = 0;
+            while (c.inLen - at >= sizeof(AxleQueryHeader)) {
+                AxleQueryHeader h;
+                std::memcpy(&h, c.in.data() + at, sizeof(h));
+                if (!IsQueryHeader(h)) { c.closed = true; break; }   // lost framing: drop the client
+                const AxleQueryStatus st = CheckQuery(h);
+                // A bad vehicle is answered and skipped; an unknown version or an oversized request
+                // is answered and then the client is dropped, as its payload cannot be trusted
+                const bool fatal = st == AxleQueryStatus::BadVersion || st == AxleQueryStatus::TooLarge;
+                const std::size_t need = fatal ? sizeof(h) : QueryBytes(h.count);
+                if (fatal) c.closed = true;
+                if (c.inLen - at < need) break;
+                pending.push_back({(int)k, at, 0, st});
+                at += need;
+                if (c.closed) break;
+            }
+            c.consumed = at;
+        }
+        const Clock::time_point received = Clock::now();
+
+        if (!pending.empty()) {
+            // Reserve every reply first (out may reallocate), then point the jobs into it
+            for (Pending& p : pending) {
+                Connection& c = conns[p.conn];
+                AxleQueryHeader h;
+                std::memcpy(&h, c.in.data() + p.inOffset, sizeof(h));
+                const std::size_t bytes = ReplyBytes(p.status == AxleQueryStatus::Ok ? h.count : 0);
+                // A pipelining client rarely lets out drain completely, so move the unsent tail
+                // to the front before appending; out then only ever holds unsent bytes
+                if (c.outSent > 0) {
+                    std::memmove(c.out.data(), c.out.data() + c.outSent, c.outLen - c.outSent);
+                    c.outLen -= c.outSent;
+                    c.outSent = 0;
+                }
+                if (c.out.size() < c.outLen + bytes) c.out.resize(std::max(c.outLen + bytes, 2 * c.out.size()));
+                p.outOffset = c.outLen;
+                c.outLen += bytes;
+            }
+            jobs.clear();
+            for (const Pending& p : pending) {
+                if (p.status != AxleQueryStatus::Ok) continue;
+                Connection& c = conns[p.conn];
+                AxleQueryHeader h;
+                std::memcpy(&h, c.in.data() + p.inOffset, sizeof(h));
+                const double* payload = (const double*)(c.in.data() + p.inOffset + sizeof(h));
+                double* result = (double*)(c.out.data() + p.outOffset + sizeof(AxleReplyHeader));
+                jobs.push_back({VehicleParams{h.m, h.h, h.L, h.lf, h.lr}, payload, payload + h.count,
+                                h.count, result, result + h.count});
+            }
+            batcher.Evaluate(jobs);
+
+            const Clock::time_point done = Clock::now();
+            const std::uint64_t ns = (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(done - received).count();
+            for (const Pending& p : pending) {
+                Connection& c = conns[p.conn];
+                AxleQueryHeader h;
+                std::memcpy(&h, c.in.data() + p.inOffset, sizeof(h));
+                AxleReplyHeader r;
+                MakeReplyHeader(r, h, p.status);
+                r.serverMicros = (std::uint32_t)std::min<std::uint64_t>(ns / 1000, 0xFFFFFFFFu);
+                r.batchRequests = (std::uint32_t)pending.size();
+                std::memcpy(c.out.data() + p.outOffset, &r, sizeof(r));
+                for (ServerStats* s : {&interval, &total}) {
+                    ++s->requests;
+                    s->samples += r.count;
+                    s->errors += p.status != AxleQueryStatus::Ok;
+                    s->latency.Record(ns);
+                }
+            }
+            for (ServerStats* s : {&interval, &total}) ++s->rounds;
+        }
+
+        // Drop consumed input, send what we can, retire closed clients
+        for (Connection& c : conns) {
+            if (c.consumed > 0) {
+                std::memmove(c.in.data(), c.in.data() + c.consumed, c.inLen - c.consumed);
+                c.inLen -= c.consumed;
+                c.consumed = 0;
+            }
+            if (!c.closed && !WritePending(c)) c.closed = true;
+            ReleaseDrained(c);
+        }
+        for (size_t k = conns.size(); k-- > 0;) {
+            if (!conns[k].closed) continue;
+            WritePending(conns[k]);   // best effort for replies already computed
+            close(conns[k].fd);
+            conns.erase(conns.begin() + k);
+        }
+
+        const double elapsed = std::chrono::duration<double>(Clock::now() - intervalStart).count();
+        if (statsEvery > 0.0 && elapsed >= statsEvery) {
+            if (interval.requests) PrintStats(interval, elapsed, "last");
+            interval.Reset();
+            intervalStart = Clock::now();
+        }
+    }
+
+    for (Connection& c : conns) close(c.fd);
+    close(listenFd);
+    unlink(path.c_str());
+    PrintStats(total, std::chrono::duration<double>(Clock::now() - start).count(), "total");
+    return 0;
+}
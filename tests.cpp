@@ -0,0 +1,380 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "axleGridCache.hpp"
+#include "axleLoads.hpp"
+#include "axleQuery.hpp"
+#include "frameScheduler.hpp"
+#include "plotSeries.hpp"
+#include "threadPool.hpp"
+
+/********************
+Program    - Axle Load Modelling for Brake Redistribution
+Maintainer - C.Holmes
+File       - Test Program
+Version    - 0
+    - Release Notes:
+        - Version 0   - Behaviour checks run by ctest: LTTB, grid cache files, batch job names, query protocol
+            -- build -> ✅
+            -- run   -> ctest, or ./WheelLoadTests [path/to/WheelLoadBatch]
+        - Version 1   - Frame scheduler wake/idle rules (moved from WheelLoadBench --idle)
+********************/
+
+// Prints one line per check; main() exits 1 if any failed
+static int failed = 0;
+static void Check(bool ok, const char* what) {
+    std::printf("  %-62s %s\n", what, ok ? "ok" : "FAILED");
+    failed += !ok;
+}
+
+static bool SameBits(double a, double b) { return std::memcmp(&a, &b, sizeof(double)) == 0; }
+
+static const VehicleParams kVehicle{1475.0, 0.55, 2.636, 1.0544, 1.5816};
+
+// Scratch directory under the system temp dir, emptied on creation and on destruction
+struct ScratchDir {
+    std::filesystem::path path;
+    explicit ScratchDir(const char* name) : path(std::filesystem::temp_directory_path() / name) {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+        std::filesystem::create_directories(path, ec);
+    }
+    ~ScratchDir() {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+    }
+};
+
+static bool ReadFile(const std::string& path, std::vector<char>& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+static bool WriteFile(const std::string& path, const char* data, std::size_t bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data, (std::streamsize)bytes);
+    return (bool)out;
+}
+
+static void TestLttb() {
+    std::printf("LTTB downsampling\n");
+    const int n = 10000;
+    std::vector<double> x(n), y(n), outX(n), outY(n);
+    for (int k = 0; k < n; ++k) { x[k] = 0.001 * k; y[k] = std::sin(0.003 * k); }
+    const GridView yv{y.data(), n, (int)sizeof(double)};
+
+    int got = DownsampleLTTB(x.data(), yv, 50, 100, outX.data(), outY.data());
+    bool copied = got == 50;
+    for (int k = 0; copied && k < got; ++k) copied = outX[k] == x[k] && outY[k] == y[k];
+    Check(copied, "n <= threshold copies every point");
+    got = DownsampleLTTB(x.data(), yv, n, 2, outX.data(), outY.data());
+    Check(got == n, "threshold < 3 copies every point");
+    Check(DownsampleLTTB(x.data(), yv, 0, 100, outX.data(), outY.data()) == 0, "empty input gives no points");
+
+    got = DownsampleLTTB(x.data(), yv, n, 100, outX.data(), outY.data());
+    Check(got == 100, "returns exactly threshold points");
+    Check(outX[0] == x[0] && outY[0] == y[0] && outX[got - 1] == x[n - 1] && outY[got - 1] == y[n - 1],
+          "first and last points are kept");
+    bool ordered = true, fromInput = true;
+    for (int k = 0; k < got; ++k) {
+        if (k > 0 && !(outX[k] > outX[k - 1])) ordered = false;
+        const int src = (int)std::lround(outX[k] / 0.001);
+        if (src < 0 || src >= n || x[src] != outX[k] || y[src] != outY[k]) fromInput = false;
+    }
+    Check(ordered, "picks are in increasing x, one per bucket");
+    Check(fromInput, "every pick is an input point");
+
+    // A one-sample spike in a flat line must survive a 100x reduction
+    std::vector<double> flat(n, 1.0);
+    flat[4321] = 5.0;
+    got = DownsampleLTTB(x.data(), GridView{flat.data(), n, (int)sizeof(double)}, n, 100, outX.data(), outY.data());
+    bool spike = false;
+    for (int k = 0; k < got; ++k) spike |= outY[k] == 5.0;
+    Check(spike, "a single-sample spike is kept");
+
+    // Strided column of a grid gives the same picks as the same values stored contiguously
+    AxleGrid grid(n, 3);
+    for (int k = 0; k < n; ++k) grid(k, 1) = y[k];
+    std::vector<double> colX(n), colY(n);
+    const int gotCol = DownsampleLTTB(x.data(), grid.ColView(1), n, 100, colX.data(), colY.data());
+    got = DownsampleLTTB(x.data(), yv, n, 100, outX.data(), outY.data());
+    bool same = gotCol == got;
+    for (int k = 0; same && k < got; ++k) same = colX[k] == outX[k] && colY[k] == outY[k];
+    Check(same, "strided view matches contiguous input");
+
+    std::vector<int> idx;
+    EvenSliceIndices(10, 3, idx);
+    Check(idx == std::vector<int>{0, 4, 9}, "EvenSliceIndices(10, 3) = 0, 4, 9");
+    EvenSliceIndices(3, 8, idx);
+    Check(idx == std::vector<int>{0, 1, 2}, "EvenSliceIndices clamps count to n");
+    EvenSliceIndices(10, 1, idx);
+    Check(idx == std::vector<int>{0}, "EvenSliceIndices(n, 1) = 0");
+}
+
+static void TestGridCache() {
+    std::printf("grid cache files\n");
+    ScratchDir dir("wheelload_tests_cache");
+    AxleGridCache cache(dir.path.string(), UINT64_MAX);
+    AxleGridKey key;
+    key.vp = kVehicle;
+    key.thetaMin = -0.3; key.thetaMax = 0.3; key.thetaSteps = 37;
+    key.accelMin = -10.0; key.accelMax = 10.0; key.accelSteps = 50;   // stride 56: padded rows
+    AxleData data;
+    CalculateAxleLoads(data, key.vp, key.thetaMin, key.thetaMax, key.thetaSteps,
+                       key.accelMin, key.accelMax, key.accelSteps);
+    Check(cache.Store(key, data), "store a 37 x 50 grid");
+    {
+        AxleData loaded;
+        bool same = cache.Load(key, loaded) && loaded.WF.External()
+                 && loaded.WF.Rows() == 37 && loaded.WF.Cols() == 50
+                 && loaded.theta == data.theta && loaded.accel == data.accel;
+        for (int i = 0; same && i < 37; ++i)
+            for (int j = 0; same && j < 50; ++j)
+                same = SameBits(loaded.WF(i, j), data.WF(i, j)) && SameBits(loaded.WR(i, j), data.WR(i, j));
+        Check(same, "load maps it back bit-identical");
+    }
+    AxleGridKey other = key;
+    other.vp.m += 1.0;
+    AxleData miss;
+    Check(!cache.Load(other, miss), "other inputs miss");
+    other = key;
+    other.model = kAxleModelVersion + 1;
+    Check(!cache.Load(other, miss), "other model version misses");
+    other = key;
+    other.kernel = key.kernel == AxleKernelIsa::Scalar ? AxleKernelIsa::SSE2 : AxleKernelIsa::Scalar;
+    Check(!cache.Load(other, miss), "other row kernel misses");
+
+    // Damaged copies of the good file at the good key's path must all be rejected
+    const std::string path = cache.PathFor(key);
+    std::vector<char> good;
+    Check(ReadFile(path, good) && good.size() > sizeof(AxleGridFileHeader), "read the stored file");
+    if (good.size() <= sizeof(AxleGridFileHeader)) return;
+    AxleGridFileHeader h0;
+    std::memcpy(&h0, good.data(), sizeof(h0));
+    auto rejects = [&](const std::vector<char>& bytes) {
+        AxleData out;
+        return WriteFile(path, bytes.data(), bytes.size()) && !cache.Load(key, out);
+    };
+    auto patched = [&](void (*patch)(AxleGridFileHeader&)) {
+        std::vector<char> bytes = good;
+        AxleGridFileHeader h = h0;
+        patch(h);
+        std::memcpy(bytes.data(), &h, sizeof(h));
+        return bytes;
+    };
+    Check(rejects(patched([](AxleGridFileHeader& h) { h.magic[0] = 'X'; })), "bad magic is rejected");
+    Check(rejects(patched([](AxleGridFileHeader& h) { h.version += 1; })), "other file version is rejected");
+    Check(rejects(patched([](AxleGridFileHeader& h) { h.model += 1; })), "header from another model version is rejected");
+    Check(rejects(patched([](AxleGridFileHeader& h) { h.kernel ^= 1; })), "header from another row kernel is rejected");
+    Check(rejects(patched([](AxleGridFileHeader& h) { h.stride = h.accelSteps; })), "stride that is not whole row pads is rejected");
+    Check(rejects(patched([](AxleGridFileHeader& h) { h.stride = 0; })), "stride shorter than a row is rejected");
+    Check(rejects(patched([](AxleGridFileHeader& h) { h.wrOffset = h.fileBytes; })), "section past the end is rejected");
+    Check(rejects(patched([](AxleGridFileHeader& h) { h.wfOffset += 8; })), "unaligned section is rejected");
+    std::vector<char> cut(good.begin(), good.end() - 64);
+    Check(rejects(cut), "truncated file is rejected");
+    {
+        AxleGridFileHeader h = h0;
+        h.fileBytes = cut.size();
+        std::memcpy(cut.data(), &h, sizeof(h));
+    }
+    Check(rejects(cut), "truncated file with a matching size field is rejected");
+    Check(rejects(std::vector<char>(good.begin(), good.begin() + 16)), "file shorter than a header is rejected");
+
+    AxleData again;
+    Check(WriteFile(path, good.data(), good.size()) && cache.Load(key, again), "restored file loads again");
+}
+
+// Runs the real batch tool, since the name rules decide which files it writes
+static void TestBatchNames(const char* batchExe) {
+    std::printf("batch job names\n");
+    if (!batchExe) {
+        std::printf("  (no WheelLoadBatch path given, skipped)\n");
+        return;
+    }
+    ScratchDir dir("wheelload_tests_batch");
+    const std::filesystem::path out = dir.path / "out";
+    const std::string config = (dir.path / "jobs.txt").string();
+    const char* names[] = {"ok", "OK", "plain.v2", "../escape", "sub/name", "back\\slash", "a..b",
+                           "summary", "Summary", "SUMMARY"};
+    {
+        std::ofstream cfg(config);
+        for (const char* name : names)
+            cfg << name << " 1475 0.55 2.636 1.0544 1.5816 -0.1 0.1 3 -5 5 4\n";
+    }
+    const std::string cmd = "\"" + std::string(batchExe) + "\" \"" + config + "\" -o \"" + out.string() + "\" -j 1";
+    Check(std::system(cmd.c_str()) == 0, "batch run with invalid names still succeeds");
+
+    std::set<std::string> files;
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(out, ec), end; !ec && it != end; it.increment(ec))
+        files.insert(it->path().filename().string());
+    Check(files == std::set<std::string>{"ok.csv", "plain.v2.csv", "summary.csv"},
+          "only ok, plain.v2 and the summary are written");
+    Check(!std::filesystem::exists(dir.path / "escape.csv"), "'..' cannot leave the output directory");
+    std::ifstream sum(out / "summary.csv");
+    std::string line;
+    int rows = 0;
+    bool firstOk = false;
+    while (std::getline(sum, line)) {
+        if (rows == 1) firstOk = line.rfind("ok,1,", 0) == 0;
+        ++rows;
+    }
+    Check(rows == 3 && firstOk, "summary lists the two valid jobs in config order");
+}
+
+static void TestQueryProtocol() {
+    std::printf("query protocol\n");
+    AxleQueryHeader q;
+    MakeQueryHeader(q, 42, 3, kVehicle);
+    Check(IsQueryHeader(q) && CheckQuery(q) == AxleQueryStatus::Ok, "well-formed request is accepted");
+    AxleQueryHeader bad = q;
+    bad.magic[3] = 'X';
+    Check(!IsQueryHeader(bad), "wrong magic is not a request");
+    bad = q; bad.version = kAxleQueryVersion + 1;
+    Check(CheckQuery(bad) == AxleQueryStatus::BadVersion, "other version: BadVersion");
+    bad = q; bad.count = kAxleQueryMaxCount;
+    Check(CheckQuery(bad) == AxleQueryStatus::Ok, "count at the limit is accepted");
+    bad.count = kAxleQueryMaxCount + 1;
+    Check(CheckQuery(bad) == AxleQueryStatus::TooLarge, "count over the limit: TooLarge");
+    bad = q; bad.L = 0.0;
+    Check(CheckQuery(bad) == AxleQueryStatus::BadVehicle, "L = 0: BadVehicle");
+    bad = q; bad.m = std::nan("");
+    Check(CheckQuery(bad) == AxleQueryStatus::BadVehicle, "NaN mass: BadVehicle");
+    bad = q; bad.h = std::nan("");
+    Check(CheckQuery(bad) == AxleQueryStatus::BadVehicle, "NaN CoG height: BadVehicle");
+
+    AxleReplyHeader r;
+    MakeReplyHeader(r, q, AxleQueryStatus::Ok);
+    Check(IsReplyHeader(r) && r.id == 42 && r.count == 3 && r.status == 0, "reply echoes id and count");
+    MakeReplyHeader(r, q, AxleQueryStatus::TooLarge);
+    Check(r.count == 0 && r.status == (std::uint32_t)AxleQueryStatus::TooLarge, "error reply carries no samples");
+    Check(QueryBytes(0) == sizeof(AxleQueryHeader) && QueryBytes(3) == sizeof(AxleQueryHeader) + 48
+              && ReplyBytes(3) == sizeof(AxleReplyHeader) + 48, "frame sizes are header + 16 bytes per sample");
+
+    // A round of framed requests evaluated in place, small (serial) and large (split over the
+    // pool), must match the model sample by sample
+    const std::uint32_t counts[] = {0, 1, 7, 1000, 200000};
+    std::vector<std::vector<char>> requests, replies;
+    std::vector<AxleQueryJob> jobs;
+    for (std::uint32_t count : counts) {
+        VehicleParams vp = kVehicle;
+        vp.m += count;
+        std::vector<char> req(QueryBytes(count)), rep(ReplyBytes(count));
+        AxleQueryHeader h;
+        MakeQueryHeader(h, count, count, vp);
+        std::memcpy(req.data(), &h, sizeof(h));
+        double* theta = reinterpret_cast<double*>(req.data() + sizeof(h));
+        double* accel = theta + count;
+        for (std::uint32_t k = 0; k < count; ++k) {
+            theta[k] = -0.3 + 0.6 * (k % 977) / 976.0;
+            accel[k] = -10.0 + 20.0 * (k % 613) / 612.0;
+        }
+        requests.push_back(std::move(req));
+        replies.push_back(std::move(rep));
+    }
+    for (std::size_t j = 0; j < requests.size(); ++j) {
+        AxleQueryHeader h;
+        std::memcpy(&h, requests[j].data(), sizeof(h));
+        const double* theta = reinterpret_cast<const double*>(requests[j].data() + sizeof(h));
+        double* WF = reinterpret_cast<double*>(replies[j].data() + sizeof(AxleReplyHeader));
+        jobs.push_back({VehicleParams{h.m, h.h, h.L, h.lf, h.lr}, theta, theta + h.count, h.count, WF, WF + h.count});
+    }
+    ThreadPool pool(4);
+    for (ThreadPool* p : {(ThreadPool*)nullptr, &pool}) {
+        for (std::vector<char>& rep : replies) std::fill(rep.begin(), rep.end(), 0);
+        AxleQueryBatcher batcher(p);
+        batcher.Evaluate(jobs);
+        bool same = true;
+        double worst = 0.0;
+        std::vector<double> WF, WR;
+        for (const AxleQueryJob& job : jobs) {
+            WF.resize(job.n); WR.resize(job.n);
+            CalculateAxleLoadsBatch(job.vp, job.theta, job.accel, job.n, WF.data(), WR.data());
+            for (std::size_t k = 0; k < job.n; ++k) {
+                same &= SameBits(job.WF[k], WF[k]) && SameBits(job.WR[k], WR[k]);
+                const auto [wf, wr] = CalculateNominalAxleLoads(job.vp, job.theta[k], job.accel[k]);
+                worst = std::max({worst, std::fabs(job.WF[k] - wf), std::fabs(job.WR[k] - wr)});
+            }
+        }
+        Check(same, p ? "pooled round matches CalculateAxleLoadsBatch bit for bit"
+                      : "serial round matches CalculateAxleLoadsBatch bit for bit");
+        Check(worst < 1e-6, p ? "pooled round agrees with the nominal model (< 1e-6 N)"
+                              : "serial round agrees with the nominal model (< 1e-6 N)");
+    }
+}
+
+// Frames the UI loop draws over `seconds` of virtual time with no events: it waits as the
+// scheduler says (idle cap 1 s) and nothing wakes it early, except one RequestFrames(1) from
+// another thread at wakeAt (< 0: none), which ends the wait in progress as glfwPostEmptyEvent would
+static std::uint64_t IdleFrames(double seconds, double wakeAt) {
+    FrameScheduler s;
+    double t = 0.0;
+    bool woken = wakeAt < 0.0;
+    while (t < seconds) {
+        double wait = s.WaitTimeout(1.0);
+        if (!woken && t + wait >= wakeAt) {
+            std::thread([&] { s.RequestFrames(1); }).join();
+            wait = wakeAt - t;
+            woken = true;
+        }
+        t += wait + 1.0 / 60.0;      // the wait, then one vsync-bound frame
+        s.FrameDrawn();
+    }
+    return s.FramesDrawn();
+}
+
+static void TestFrameScheduler() {
+    std::printf("frame scheduler\n");
+    FrameScheduler s;
+    bool settle = true;
+    for (int k = 0; k < FrameScheduler::kSettleFrames; ++k) { settle &= s.WaitTimeout(1.0) == 0.0; s.FrameDrawn(); }
+    Check(settle, "startup draws kSettleFrames frames without waiting");
+    Check(s.WaitTimeout(1.0) == 1.0, "then waits the idle cap");
+    s.RequestFrames();
+    bool input = true;
+    for (int k = 0; k < FrameScheduler::kSettleFrames; ++k) { input &= s.WaitTimeout(1.0) == 0.0; s.FrameDrawn(); }
+    Check(input && s.WaitTimeout(1.0) == 1.0, "input draws kSettleFrames frames, then idles");
+    s.RequestRefresh(0.5);
+    s.RequestRefresh(1.0 / 30.0);
+    Check(s.WaitTimeout(1.0) == 1.0 / 30.0, "refresh requests: the soonest one bounds the wait");
+    s.FrameDrawn();
+    Check(s.WaitTimeout(1.0) == 1.0, "refresh lasts one frame only");
+    s.RequestRefresh(5.0);
+    Check(s.WaitTimeout(1.0) == 1.0, "refresh later than the idle cap waits the cap");
+    s.FrameDrawn();
+    std::thread([&] { s.RequestFrames(1); }).join();
+    const bool wake = s.WaitTimeout(1.0) == 0.0;
+    s.FrameDrawn();
+    Check(wake && s.WaitTimeout(1.0) == 1.0, "request from another thread draws exactly one frame");
+    s.SetEventDriven(false);
+    bool vsync = true;
+    for (int k = 0; k < 10; ++k) { vsync &= s.WaitTimeout(1.0) == 0.0; s.FrameDrawn(); }
+    Check(vsync, "event-driven off never waits");
+
+    // Settle frames + one wake per idle second; a posted result adds exactly one frame
+    const std::uint64_t idle = IdleFrames(10.0, -1.0), woken = IdleFrames(10.0, 4.5);
+    Check(idle <= FrameScheduler::kSettleFrames + 10, "idle loop draws only settle frames + one per idle second");
+    Check(woken == idle + 1, "a posted result wakes the loop for one frame");
+}
+
+int main(int argc, char** argv) {
+    const char* batchExe = argc > 1 ? argv[1] : nullptr;
+    TestLttb();
+    TestGridCache();
+    TestBatchNames(batchExe);
+    TestQueryProtocol();
+    TestFrameScheduler();
+    std::printf("%s\n", failed ? "FAILED" : "all checks passed");
+    return failed ? 1 : 0;
+}
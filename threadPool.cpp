@@ -0,0 +1,182 @@
+#include <cstdlib>
+#include <exception>
+#include "threadPool.hpp"
+
+/********************
+Program    - Axle Load Model - Thread Pool
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Work-stealing ParallelFor over packed atomic index ranges
+        - Version 1   - Nested calls only reuse the worker id of the pool that owns the thread
+        - Version 2   - Only nested calls into the same pool skip the submit lock; caller exceptions drain the job
+********************/
+
+static std::uint64_t PackRange(std::uint32_t begin, std::uint32_t end) {
+    return ((std::uint64_t)end << 32) | begin;
+}
+static std::uint32_t RangeBegin(std::uint64_t r) { return (std::uint32_t)(r & 0xffffffffu); }
+static std::uint32_t RangeEnd(std::uint64_t r)   { return (std::uint32_t)(r >> 32); }
+
+// Pools whose tasks the current thread is executing, innermost first, with its participant id in
+// each. A thread can be inside several pools' tasks at once when a task calls another pool.
+struct PoolFrame {
+    const ThreadPool* pool;
+    int worker;
+    const PoolFrame* outer;
+};
+static thread_local const PoolFrame* tlsFrame = nullptr;
+
+// Pushes a frame for the duration of a scope, popping it on any exit
+struct PoolFrameScope {
+    PoolFrame frame;
+    PoolFrameScope(const ThreadPool* pool, int worker) : frame{pool, worker, tlsFrame} { tlsFrame = &frame; }
+    ~PoolFrameScope() { tlsFrame = frame.outer; }
+};
+
+// Participant id of the current thread in pool, or -1 if it is not running one of its tasks
+static int WorkerIn(const ThreadPool* pool) {
+    for (const PoolFrame* f = tlsFrame; f; f = f->outer)
+        if (f->pool == pool) return f->worker;
+    return -1;
+}
+
+ThreadPool::ThreadPool(int threads) {
+    if (threads <= 0) threads = (int)std::thread::hardware_concurrency();
+    if (threads <= 0) threads = 1;
+    size_ = threads;
+    slots_.reset(new Slot[size_]);
+    threads_.reserve(size_ - 1);
+    for (int w = 1; w < size_; ++w)
+        threads_.emplace_back(&ThreadPool::WorkerLoop, this, w);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& t : threads_) t.join();
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int, int)>& fn) {
+    if (count <= 0) return;
+
+    // A call from inside one of this pool's own tasks runs serially with that task's worker id:
+    // the other participants are busy with the outer job. Anything else, including a task of
+    // another pool, takes the submit lock, so two callers never share a worker id.
+    const int nested = WorkerIn(this);
+    if (nested >= 0) {
+        for (int t = 0; t < count; ++t) fn(t, nested);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(submitMutex_);
+
+    // Single participant or single task: run on the caller as worker 0
+    if (size_ == 1 || count == 1) {
+        PoolFrameScope scope(this, 0);
+        for (int t = 0; t < count; ++t) fn(t, 0);
+        return;
+    }
+
+    // Even initial split; stealing rebalances uneven tiles
+    for (int w = 0; w < size_; ++w) {
+        const std::uint32_t b = (std::uint32_t)((std::int64_t)count * w / size_);
+        const std::uint32_t e = (std::uint32_t)((std::int64_t)count * (w + 1) / size_);
+        slots_[w].range.store(PackRange(b, e), std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &fn;
+        busyWorkers_ = size_ - 1;
+        ++jobId_;
+    }
+    wake_.notify_all();
+
+    // If fn throws on the caller, hand out no more tasks and let the workers leave the job
+    // before rethrowing: they still read job_ and fn
+    std::exception_ptr error;
+    try {
+        RunTasks(0);
+    } catch (...) {
+        error = std::current_exception();
+        for (int w = 0; w < size_; ++w) slots_[w].range.store(0, std::memory_order_relaxed);
+    }
+
+    // Workers may still be finishing stolen tasks; wait until all have left the job
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return busyWorkers_ == 0; });
+    job_ = nullptr;
+    lock.unlock();
+    if (error) std::rethrow_exception(error);
+}
+
+void ThreadPool::WorkerLoop(int worker) {
+    std::uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return stop_ || jobId_ != seen; });
+            if (stop_) return;
+            seen = jobId_;
+        }
+
+        RunTasks(worker);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--busyWorkers_ == 0) done_.notify_one();
+    }
+}
+
+void ThreadPool::RunTasks(int worker) {
+    const std::function<void(int, int)>& fn = *job_;
+    PoolFrameScope scope(this, worker);
+    int task;
+    while (PopOwn(worker, task) || Steal(worker, task))
+        fn(task, worker);
+}
+
+bool ThreadPool::PopOwn(int worker, int& task) {
+    std::atomic<std::uint64_t>& slot = slots_[worker].range;
+    std::uint64_t r = slot.load(std::memory_order_acquire);
+    for (;;) {
+        const std::uint32_t b = RangeBegin(r), e = RangeEnd(r);
+        if (b >= e) return false;
+        if (slot.compare_exchange_weak(r, PackRange(b + 1, e), std::memory_order_acq_rel)) {
+            task = (int)b;
+            return true;
+        }
+    }
+}
+
+bool ThreadPool::Steal(int thief, int& task) {
+    for (int k = 1; k < size_; ++k) {
+        std::atomic<std::uint64_t>& victim = slots_[(thief + k) % size_].range;
+        std::uint64_t r = victim.load(std::memory_order_acquire);
+        for (;;) {
+            const std::uint32_t b = RangeBegin(r), e = RangeEnd(r);
+            if (b >= e) break;
+            // Take the back half (at least one task)
+            const std::uint32_t mid = e - (e - b + 1) / 2;
+            if (victim.compare_exchange_weak(r, PackRange(b, mid), std::memory_order_acq_rel)) {
+                task = (int)mid;
+                // Our own range is empty, so nobody else is modifying it
+                slots_[thief].range.store(PackRange(mid + 1, e), std::memory_order_release);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+ThreadPool& DefaultThreadPool() {
+    static ThreadPool pool([] {
+        const char* env = std::getenv("AXLE_THREADS");
+        return env ? std::atoi(env) : 0;
+    }());
+    return pool;
+}
@@ -0,0 +1,79 @@
+/********************
+Program    - Axle Load Model - Thread Pool
+Maintainer - C.Holmes
+File       - Program Header
+Version    - 0
+    - Release Notes:
+        - Version 0   - Persistent work-stealing pool for tiled grid evaluation
+        - Version 1   - Nested calls from another pool's task get worker 0
+        - Version 2   - Only same-pool nested calls run serially; others take the submit lock
+********************/
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent pool of worker threads.
+// ParallelFor() splits [0, count) into one contiguous index range per participant
+// (the calling thread plus every worker). Each participant pops indices from the
+// front of its own range; once empty it steals the back half of another range.
+// Ranges are single 64-bit atomics, so neither popping nor stealing takes a lock.
+class ThreadPool {
+public:
+    // threads <= 0 sizes the pool from std::thread::hardware_concurrency().
+    // threads counts participants, so ThreadPool(1) runs everything on the caller.
+    explicit ThreadPool(int threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Number of participants (caller + workers). Valid worker ids are [0, Size()).
+    int Size() const { return size_; }
+
+    // Run fn(task, worker) for every task in [0, count) and block until all finish.
+    // worker identifies the executing participant (0 = caller) for per-thread scratch.
+    // Calls from inside one of this pool's running tasks execute serially on that thread with
+    // that task's worker id. Calls from anywhere else, including another pool's tasks, wait for
+    // the pool to be free. Pools must not call each other in a cycle from different threads.
+    // If fn throws on the calling thread, the remaining tasks are dropped and the exception is
+    // rethrown once the workers have left the job; fn must not throw on a worker.
+    void ParallelFor(int count, const std::function<void(int task, int worker)>& fn);
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> range{0}; // [begin, end) packed as end<<32 | begin
+    };
+
+    void WorkerLoop(int worker);
+    void RunTasks(int worker);
+    bool PopOwn(int worker, int& task);
+    bool Steal(int thief, int& task);
+
+    int size_ = 1;
+    std::unique_ptr<Slot[]> slots_;
+    std::vector<std::thread> threads_;
+
+    std::mutex submitMutex_;                 // one ParallelFor at a time
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::uint64_t jobId_ = 0;
+    bool stop_ = false;
+    const std::function<void(int, int)>* job_ = nullptr;
+    int busyWorkers_ = 0;                    // workers still inside the current job
+};
+
+// Process-wide pool, created on first use.
+// Sized from the AXLE_THREADS environment variable when set, otherwise hardware concurrency.
+ThreadPool& DefaultThreadPool();
+
+#endif // THREAD_POOL_H